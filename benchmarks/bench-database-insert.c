@@ -0,0 +1,136 @@
+/* bench-database-insert.c
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#include <stdlib.h>
+
+#include "bench-utils.h"
+#include "font-manager-database.h"
+#include "font-manager-fontconfig.h"
+
+/*
+ * Reports faces/sec written by font_manager_update_database, the path which
+ * goes through update_available_fonts and its cached insert statements.
+ *
+ * The "bulk" run populates an empty database, where indexes are dropped
+ * until every row is in place. The "fonts" run starts from a complete
+ * database with every Fonts row removed, files are unchanged so nothing is
+ * rescanned and the time is spent in insert_font_row alone. The "rescan" run
+ * starts from a complete database with no FileState rows, so every face is
+ * scanned again and each of its rows replaced through the incremental path.
+ *
+ * All of them include the search index triggers and the commit every 500
+ * families performed by a real sync.
+ */
+
+typedef struct
+{
+    FontManagerDatabase *db;
+    FontManagerFontTable *table;
+    GMainLoop *loop;
+}
+InsertBench;
+
+static void
+on_update_finished (G_GNUC_UNUSED GObject *source,
+                    GAsyncResult *result,
+                    gpointer user_data)
+{
+    InsertBench *bench = user_data;
+    g_autoptr(GError) error = NULL;
+    if (!font_manager_update_database_finish(result, &error))
+        g_printerr("Database update failed : %s\n", error->message);
+    g_main_loop_quit(bench->loop);
+    return;
+}
+
+static void
+update_database (InsertBench *bench)
+{
+    font_manager_update_database(bench->db, bench->table, NULL, NULL, on_update_finished, bench);
+    g_main_loop_run(bench->loop);
+    return;
+}
+
+static void
+open_empty_database (InsertBench *bench)
+{
+    g_clear_object(&bench->db);
+    g_free(bench_reset_database());
+    bench->db = font_manager_database_new();
+    return;
+}
+
+static void
+clear_table (InsertBench *bench, const gchar *sql)
+{
+    g_autoptr(GError) error = NULL;
+    if (bench->db == NULL) {
+        open_empty_database(bench);
+        update_database(bench);
+    }
+    font_manager_database_execute_query(bench->db, sql, &error);
+    if (error != NULL)
+        g_error("%s : %s", sql, error->message);
+    if (sqlite3_step(font_manager_database_get_cursor(bench->db)) != SQLITE_DONE)
+        g_error("Failed to execute %s", sql);
+    font_manager_database_end_query(bench->db);
+    return;
+}
+
+static void
+clear_fonts (InsertBench *bench)
+{
+    clear_table(bench, "DELETE FROM Fonts;");
+    return;
+}
+
+static void
+clear_file_state (InsertBench *bench)
+{
+    clear_table(bench, "DELETE FROM FileState;");
+    return;
+}
+
+int
+main (int argc, char *argv[])
+{
+    bench_init(&argc, &argv, "database-insert", "1000,5000");
+    guint n_sizes = 0;
+    const guint *sizes = bench_get_sizes(&n_sizes);
+    InsertBench bench = { NULL, NULL, g_main_loop_new(NULL, FALSE) };
+    for (guint i = 0; i < n_sizes; i++) {
+        if (!bench_use_font_corpus(sizes[i], 512))
+            return EXIT_FAILURE;
+        bench.table = font_manager_get_available_font_table(NULL);
+        g_autofree gchar *bulk = g_strdup_printf("insert/bulk/%u", sizes[i]);
+        bench_run_with_setup(bulk, sizes[i], (BenchFunc) open_empty_database,
+                             (BenchFunc) update_database, &bench);
+        g_autofree gchar *fonts = g_strdup_printf("insert/fonts/%u", sizes[i]);
+        bench_run_with_setup(fonts, sizes[i], (BenchFunc) clear_fonts,
+                             (BenchFunc) update_database, &bench);
+        g_autofree gchar *rescan = g_strdup_printf("insert/rescan/%u", sizes[i]);
+        bench_run_with_setup(rescan, sizes[i], (BenchFunc) clear_file_state,
+                             (BenchFunc) update_database, &bench);
+        g_clear_object(&bench.db);
+        g_clear_object(&bench.table);
+    }
+    g_main_loop_unref(bench.loop);
+    return bench_finish();
+}
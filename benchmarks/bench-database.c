@@ -0,0 +1,93 @@
+/* bench-database.c
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#include <stdlib.h>
+
+#include "bench-utils.h"
+#include "font-manager-database.h"
+#include "font-manager-fontconfig.h"
+
+/*
+ * Times font_manager_update_database over a generated corpus.
+ *
+ * The cold run starts from an empty database every time, as on first launch
+ * or after a locale change. The warm run syncs against a database which
+ * already contains every font, as on any other launch.
+ */
+
+typedef struct
+{
+    FontManagerDatabase *db;
+    FontManagerFontTable *table;
+    GMainLoop *loop;
+}
+DatabaseBench;
+
+static void
+on_update_finished (G_GNUC_UNUSED GObject *source,
+                    GAsyncResult *result,
+                    gpointer user_data)
+{
+    DatabaseBench *bench = user_data;
+    g_autoptr(GError) error = NULL;
+    if (!font_manager_update_database_finish(result, &error))
+        g_printerr("Database update failed : %s\n", error->message);
+    g_main_loop_quit(bench->loop);
+    return;
+}
+
+static void
+update_database (DatabaseBench *bench)
+{
+    font_manager_update_database(bench->db, bench->table, NULL, NULL, on_update_finished, bench);
+    g_main_loop_run(bench->loop);
+    return;
+}
+
+static void
+remove_database (DatabaseBench *bench)
+{
+    g_clear_object(&bench->db);
+    g_free(bench_reset_database());
+    bench->db = font_manager_database_new();
+    return;
+}
+
+int
+main (int argc, char *argv[])
+{
+    bench_init(&argc, &argv, "database", "1000,5000");
+    guint n_sizes = 0;
+    const guint *sizes = bench_get_sizes(&n_sizes);
+    DatabaseBench bench = { NULL, NULL, g_main_loop_new(NULL, FALSE) };
+    for (guint i = 0; i < n_sizes; i++) {
+        if (!bench_use_font_corpus(sizes[i], 512))
+            return EXIT_FAILURE;
+        bench.table = font_manager_get_available_font_table(NULL);
+        g_autofree gchar *cold = g_strdup_printf("update_database/cold/%u", sizes[i]);
+        bench_run_with_setup(cold, sizes[i], (BenchFunc) remove_database, (BenchFunc) update_database, &bench);
+        g_autofree gchar *warm = g_strdup_printf("update_database/warm/%u", sizes[i]);
+        bench_run(warm, sizes[i], (BenchFunc) update_database, &bench);
+        g_clear_object(&bench.db);
+        g_clear_object(&bench.table);
+    }
+    g_main_loop_unref(bench.loop);
+    return bench_finish();
+}
@@ -0,0 +1,120 @@
+/* bench-models.vala
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+// Times category construction and font list filtering. Built along with
+// the sources of font-manager itself, see benchmarks/meson.build.
+
+namespace FontManager {
+
+    // Faces written to disk for the category benchmark
+    const uint CATEGORY_CORPUS_SIZE = 2000;
+
+    void populate_database (FontTable table) {
+        var loop = new MainLoop();
+        var db = new Database();
+        update_database.begin(db, table, null, null, (obj, res) => {
+            try {
+                update_database.end(res);
+            } catch (Error e) {
+                critical(e.message);
+            }
+            loop.quit();
+        });
+        loop.run();
+        return;
+    }
+
+    void build_categories () {
+        var task = new GLib.Task(null, null, null);
+        task.run_in_thread_sync(get_default_categories);
+        return;
+    }
+
+    // Only returns once results are published, items_updated may be emitted
+    // right away if the list is small enough to be filtered synchronously.
+    void wait_for_update (BaseFontModel model) {
+        var loop = new MainLoop();
+        bool done = false;
+        ulong handler = model.items_updated.connect(() => {
+            done = true;
+            loop.quit();
+        });
+        model.update_items();
+        if (!done)
+            loop.run();
+        model.disconnect(handler);
+        return;
+    }
+
+    // Matches every other face in table
+    Category create_category_filter (FontTable table) {
+        var category = new Category("Benchmark", "Benchmark", "folder-symbolic", "", 0);
+        for (uint i = 0; i < table.get_n_faces(); i += 2) {
+            category.families.add(table.get_family_name(table.get_family(i)));
+            category.variations.add(table.get_description(i));
+        }
+        return category;
+    }
+
+    void run_model_benchmarks (uint n_faces) {
+        FontTable table = Bench.create_font_table(n_faces);
+        var model = new FontModel();
+        model.table = table;
+        wait_for_update(model);
+
+        Bench.run(@"font_model/update/$n_faces", n_faces, () => {
+            wait_for_update(model);
+        });
+
+        // The first search builds the trigram index, keep that out of the timings
+        model.search_term = "Serif 0";
+        wait_for_update(model);
+        Bench.run(@"font_model/search/$n_faces", n_faces, () => {
+            wait_for_update(model);
+        });
+        model.search_term = null;
+
+        Category category = create_category_filter(table);
+        model.filter = category;
+        wait_for_update(model);
+        Bench.run(@"font_model/category/uncached/$n_faces", n_faces, () => {
+            // Drops the cached matches for category
+            category.changed();
+            wait_for_update(model);
+        });
+        Bench.run(@"font_model/category/cached/$n_faces", n_faces, () => {
+            wait_for_update(model);
+        });
+        model.filter = null;
+        return;
+    }
+
+    public static int main (string [] args) {
+        Bench.init(ref args, "models", "10000,50000");
+        if (!Bench.use_font_corpus(CATEGORY_CORPUS_SIZE, 256))
+            return 1;
+        populate_database(get_available_font_table(null));
+        Bench.run(@"categories/build/$CATEGORY_CORPUS_SIZE", CATEGORY_CORPUS_SIZE, build_categories);
+        foreach (uint n_faces in Bench.get_sizes())
+            run_model_benchmarks(n_faces);
+        return Bench.finish();
+    }
+
+}
@@ -0,0 +1,122 @@
+/* bench-orthography.c
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#include <stdlib.h>
+#include <hb.h>
+
+#include "bench-utils.h"
+#include "font-corpus.h"
+#include "font-manager-orthographies.h"
+
+/*
+ * Times orthography coverage for fonts of different scripts and sizes,
+ * split into reading the charset of a font and comparing that charset
+ * against every known orthography.
+ *
+ * Sizes are the number of fonts processed per iteration.
+ */
+
+typedef struct
+{
+    const gchar *name;
+    FontCorpusScript script;
+    guint n_codepoints;
+}
+OrthographyFont;
+
+/* Codepoint counts roughly match typical fonts for each script */
+static const OrthographyFont FONTS[] = {
+    { "latin", FONT_CORPUS_LATIN, 780 },
+    { "cjk", FONT_CORPUS_CJK, 30000 },
+    { "symbol", FONT_CORPUS_SYMBOL, 2000 }
+};
+
+typedef struct
+{
+    JsonObject *font;
+    hb_set_t *charset;
+    guint repeat;
+}
+OrthographyBench;
+
+static void
+get_charset (OrthographyBench *bench)
+{
+    for (guint i = 0; i < bench->repeat; i++)
+        hb_set_destroy(font_manager_get_charset_from_font_object(bench->font));
+    return;
+}
+
+static void
+get_results_for_charset (OrthographyBench *bench)
+{
+    for (guint i = 0; i < bench->repeat; i++)
+        json_object_unref(font_manager_get_orthography_results_for_charset(bench->charset));
+    return;
+}
+
+static void
+get_results (OrthographyBench *bench)
+{
+    for (guint i = 0; i < bench->repeat; i++)
+        json_object_unref(font_manager_get_orthography_results(bench->font));
+    return;
+}
+
+int
+main (int argc, char *argv[])
+{
+    bench_init(&argc, &argv, "orthography", "10");
+    guint n_sizes = 0;
+    const guint *sizes = bench_get_sizes(&n_sizes);
+    for (guint i = 0; i < G_N_ELEMENTS(FONTS); i++) {
+        FontCorpusFace face = {
+            "Corpus Orthography", "Regular", 400, 5, FALSE,
+            FONTS[i].script, FONTS[i].n_codepoints, NULL, NULL, 2
+        };
+        g_autoptr(GBytes) bytes = font_corpus_build_face(&face);
+        g_autofree gchar *filename = g_strdup_printf("%s.ttf", FONTS[i].name);
+        g_autofree gchar *filepath = g_build_filename(bench_get_temp_dir(), filename, NULL);
+        gsize size = 0;
+        gconstpointer data = g_bytes_get_data(bytes, &size);
+        g_autoptr(GError) error = NULL;
+        if (!g_file_set_contents(filepath, data, size, &error)) {
+            g_printerr("%s\n", error->message);
+            return EXIT_FAILURE;
+        }
+        g_autoptr(JsonObject) font = json_object_new();
+        json_object_set_string_member(font, "filepath", filepath);
+        json_object_set_int_member(font, "findex", 0);
+        OrthographyBench bench = { font, font_manager_get_charset_from_font_object(font), 0 };
+        /* Orthography sets are built on first use, keep that out of the timings */
+        json_object_unref(font_manager_get_orthography_results_for_charset(bench.charset));
+        for (guint s = 0; s < n_sizes; s++) {
+            bench.repeat = sizes[s];
+            g_autofree gchar *charset_name = g_strdup_printf("orthography/charset/%s/%u", FONTS[i].name, sizes[s]);
+            bench_run(charset_name, sizes[s], (BenchFunc) get_charset, &bench);
+            g_autofree gchar *compare_name = g_strdup_printf("orthography/compare/%s/%u", FONTS[i].name, sizes[s]);
+            bench_run(compare_name, sizes[s], (BenchFunc) get_results_for_charset, &bench);
+            g_autofree gchar *results_name = g_strdup_printf("orthography/results/%s/%u", FONTS[i].name, sizes[s]);
+            bench_run(results_name, sizes[s], (BenchFunc) get_results, &bench);
+        }
+        hb_set_destroy(bench.charset);
+    }
+    return bench_finish();
+}
@@ -0,0 +1,178 @@
+/* bench-search.c
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#include <string.h>
+#include <sqlite3.h>
+
+#include "bench-utils.h"
+#include "font-manager-database.h"
+
+/*
+ * Times font_manager_database_search, which the shell search provider uses,
+ * against the full table scans it replaced.
+ *
+ * "index" goes through the trigram search index.
+ * "like" runs the same match over every searched field using LIKE, which is
+ * also what font_manager_database_search falls back to for terms shorter
+ * than three characters.
+ * "family" is the query the search provider used to run, family names only.
+ *
+ * Sizes are numbers of faces in the database. Each iteration runs a query
+ * QUERIES_PER_ITERATION times, items/s is queries per second.
+ */
+
+#define QUERIES_PER_ITERATION 100
+
+#define INSERT_FONT_ROW "INSERT INTO Fonts VALUES (NULL,?,?,?,?,?,?,?,?,?);"
+
+#define SELECT_LIKE "SELECT filepath, findex, family, style FROM Fonts " \
+"WHERE (family LIKE ?1 OR style LIKE ?1 OR description LIKE ?1 OR filepath LIKE ?1) " \
+"ORDER BY weight;"
+
+#define SELECT_FAMILY_LIKE "SELECT filepath, findex, family, style FROM Fonts " \
+"WHERE family LIKE ?1 ORDER BY weight;"
+
+/* A common word, a prefix, a rare match, several terms and a path */
+static const gchar *QUERIES[] = { "Bold", "Synth", "Serif 01233", "Serif Italic", "/synthetic/0042" };
+
+static const gchar *KINDS[] = { "Sans", "Serif", "Mono", "Display" };
+static const gchar *STYLES[] = { "Regular", "Bold", "Italic", "Bold Italic" };
+
+typedef struct
+{
+    FontManagerDatabase *db;
+    sqlite3 *conn;
+    const gchar *query;
+}
+SearchBench;
+
+static void
+populate_database (const gchar *filepath, guint n_faces)
+{
+    sqlite3 *db = NULL;
+    if (sqlite3_open_v2(filepath, &db, SQLITE_OPEN_READWRITE, NULL) != SQLITE_OK)
+        g_error("Failed to open %s : %s", filepath, sqlite3_errmsg(db));
+    sqlite3_stmt *stmt = NULL;
+    sqlite3_exec(db, "BEGIN;", NULL, NULL, NULL);
+    sqlite3_prepare_v2(db, INSERT_FONT_ROW, -1, &stmt, NULL);
+    for (guint i = 0; i < n_faces; i++) {
+        guint family_index = i / G_N_ELEMENTS(STYLES);
+        const gchar *style = STYLES[i % G_N_ELEMENTS(STYLES)];
+        g_autofree gchar *path = g_strdup_printf("/synthetic/%06u.ttf", i);
+        g_autofree gchar *family = g_strdup_printf("Synthetic %s %05u",
+                                                   KINDS[family_index % G_N_ELEMENTS(KINDS)],
+                                                   family_index);
+        g_autofree gchar *description = g_strdup_printf("%s %s", family, style);
+        sqlite3_bind_text(stmt, 1, path, -1, SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 2, 0);
+        sqlite3_bind_text(stmt, 3, family, -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 4, style, -1, SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 5, 0);
+        sqlite3_bind_int(stmt, 6, i % 4 > 1 ? 100 : 0);
+        sqlite3_bind_int(stmt, 7, i % 2 ? 200 : 80);
+        sqlite3_bind_int(stmt, 8, 100);
+        sqlite3_bind_text(stmt, 9, description, -1, SQLITE_STATIC);
+        if (sqlite3_step(stmt) != SQLITE_DONE)
+            g_error("Insert failed : %s", sqlite3_errmsg(db));
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_exec(db, "COMMIT;", NULL, NULL, NULL);
+    sqlite3_close(db);
+    return;
+}
+
+static void
+search_index (SearchBench *bench)
+{
+    for (guint i = 0; i < QUERIES_PER_ITERATION; i++) {
+        JsonArray *results = font_manager_database_search(bench->db, bench->query, NULL);
+        g_clear_pointer(&results, json_array_unref);
+    }
+    return;
+}
+
+static void
+run_like_query (SearchBench *bench, const gchar *sql)
+{
+    g_autofree gchar *pattern = g_strdup_printf("%%%s%%", bench->query);
+    sqlite3_stmt *stmt = NULL;
+    sqlite3_prepare_v2(bench->conn, sql, -1, &stmt, NULL);
+    for (guint i = 0; i < QUERIES_PER_ITERATION; i++) {
+        sqlite3_bind_text(stmt, 1, pattern, -1, SQLITE_STATIC);
+        /* Results are collected the same way as font_manager_database_search */
+        JsonArray *results = json_array_new();
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            JsonObject *face = json_object_new();
+            json_object_set_string_member(face, "filepath", (const gchar *) sqlite3_column_text(stmt, 0));
+            json_object_set_int_member(face, "findex", sqlite3_column_int(stmt, 1));
+            json_object_set_string_member(face, "family", (const gchar *) sqlite3_column_text(stmt, 2));
+            json_object_set_string_member(face, "style", (const gchar *) sqlite3_column_text(stmt, 3));
+            json_array_add_object_element(results, face);
+        }
+        json_array_unref(results);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+    return;
+}
+
+static void
+search_like (SearchBench *bench)
+{
+    run_like_query(bench, SELECT_LIKE);
+    return;
+}
+
+static void
+search_family_like (SearchBench *bench)
+{
+    run_like_query(bench, SELECT_FAMILY_LIKE);
+    return;
+}
+
+int
+main (int argc, char *argv[])
+{
+    bench_init(&argc, &argv, "search", "50000");
+    guint n_sizes = 0;
+    const guint *sizes = bench_get_sizes(&n_sizes);
+    for (guint i = 0; i < n_sizes; i++) {
+        g_autofree gchar *filepath = bench_reset_database();
+        populate_database(filepath, sizes[i]);
+        SearchBench bench = { font_manager_database_new(), NULL, NULL };
+        sqlite3_open_v2(filepath, &bench.conn, SQLITE_OPEN_READONLY, NULL);
+        for (guint q = 0; q < G_N_ELEMENTS(QUERIES); q++) {
+            bench.query = QUERIES[q];
+            g_autofree gchar *index = g_strdup_printf("search/index/%u/%s", sizes[i], QUERIES[q]);
+            bench_run(index, QUERIES_PER_ITERATION, (BenchFunc) search_index, &bench);
+            /* LIKE matches a single pattern, multiple terms only apply to the index */
+            if (strchr(QUERIES[q], ' ') != NULL)
+                continue;
+            g_autofree gchar *like = g_strdup_printf("search/like/%u/%s", sizes[i], QUERIES[q]);
+            bench_run(like, QUERIES_PER_ITERATION, (BenchFunc) search_like, &bench);
+            g_autofree gchar *family = g_strdup_printf("search/family/%u/%s", sizes[i], QUERIES[q]);
+            bench_run(family, QUERIES_PER_ITERATION, (BenchFunc) search_family_like, &bench);
+        }
+        sqlite3_close(bench.conn);
+        g_object_unref(bench.db);
+    }
+    return bench_finish();
+}
@@ -0,0 +1,67 @@
+/* bench-sort-listing.c
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#include "bench-utils.h"
+#include "font-manager-fontconfig.h"
+
+/*
+ * Times sorting the available font listing, both the JSON listing used by
+ * the font viewer and extensions and the FontTable used by the main window.
+ *
+ * Sizes are numbers of faces, four per family.
+ */
+
+typedef struct
+{
+    JsonObject *listing;
+    guint n_faces;
+}
+SortBench;
+
+static void
+sort_json_listing (SortBench *bench)
+{
+    json_array_unref(font_manager_sort_json_font_listing(bench->listing));
+    return;
+}
+
+static void
+build_font_table (SortBench *bench)
+{
+    g_object_unref(bench_create_font_table(bench->n_faces));
+    return;
+}
+
+int
+main (int argc, char *argv[])
+{
+    bench_init(&argc, &argv, "sort-listing", "1000,10000,50000");
+    guint n_sizes = 0;
+    const guint *sizes = bench_get_sizes(&n_sizes);
+    for (guint i = 0; i < n_sizes; i++) {
+        SortBench bench = { bench_create_font_listing(sizes[i]), sizes[i] };
+        g_autofree gchar *json = g_strdup_printf("sort_json_font_listing/%u", sizes[i]);
+        bench_run(json, sizes[i], (BenchFunc) sort_json_listing, &bench);
+        g_autofree gchar *table = g_strdup_printf("font_table/build_and_sort/%u", sizes[i]);
+        bench_run(table, sizes[i], (BenchFunc) build_font_table, &bench);
+        json_object_unref(bench.listing);
+    }
+    return bench_finish();
+}
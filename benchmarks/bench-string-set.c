@@ -0,0 +1,151 @@
+/* bench-string-set.c
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#include "bench-utils.h"
+#include "font-manager-string-set.h"
+
+/*
+ * Times the operations collections, categories and filters rely on,
+ * with strings shaped like font descriptions.
+ *
+ * Each operation is also timed against a copy of the implementation
+ * FontManagerStringSet used before it gained a hash index, an array
+ * searched linearly on every add, contains and remove.
+ */
+
+typedef struct
+{
+    GPtrArray *strings;
+    FontManagerStringSet *set;
+    GPtrArray *old_set;
+}
+StringSetBench;
+
+static gboolean
+old_string_set_contains (GPtrArray *set, const gchar *str)
+{
+    return g_ptr_array_find_with_equal_func(set, str, (GEqualFunc) g_str_equal, NULL);
+}
+
+static void
+old_string_set_add (GPtrArray *set, const gchar *str)
+{
+    if (!old_string_set_contains(set, str))
+        g_ptr_array_add(set, g_strdup(str));
+    return;
+}
+
+static void
+old_string_set_remove (GPtrArray *set, const gchar *str)
+{
+    guint index;
+    if (g_ptr_array_find_with_equal_func(set, str, (GEqualFunc) g_str_equal, &index))
+        g_ptr_array_remove_index(set, index);
+    return;
+}
+
+static GPtrArray *
+generate_strings (guint n_strings)
+{
+    GPtrArray *strings = g_ptr_array_new_full(n_strings, g_free);
+    for (guint i = 0; i < n_strings; i++)
+        g_ptr_array_add(strings, g_strdup_printf("Synthetic Family %06u Bold Italic", i));
+    return strings;
+}
+
+static void
+fill_set (StringSetBench *bench)
+{
+    g_clear_object(&bench->set);
+    bench->set = font_manager_string_set_new();
+    for (guint i = 0; i < bench->strings->len; i++)
+        font_manager_string_set_add(bench->set, g_ptr_array_index(bench->strings, i));
+    return;
+}
+
+static void
+old_fill_set (StringSetBench *bench)
+{
+    g_clear_pointer(&bench->old_set, g_ptr_array_unref);
+    bench->old_set = g_ptr_array_new_with_free_func(g_free);
+    for (guint i = 0; i < bench->strings->len; i++)
+        old_string_set_add(bench->old_set, g_ptr_array_index(bench->strings, i));
+    return;
+}
+
+static void
+contains_all (StringSetBench *bench)
+{
+    /* Lookups in reverse so that a linear search gets no help from ordering */
+    for (guint i = bench->strings->len; i > 0; i--)
+        g_assert(font_manager_string_set_contains(bench->set, g_ptr_array_index(bench->strings, i - 1)));
+    return;
+}
+
+static void
+old_contains_all (StringSetBench *bench)
+{
+    for (guint i = bench->strings->len; i > 0; i--)
+        g_assert(old_string_set_contains(bench->old_set, g_ptr_array_index(bench->strings, i - 1)));
+    return;
+}
+
+static void
+remove_all (StringSetBench *bench)
+{
+    for (guint i = 0; i < bench->strings->len; i++)
+        font_manager_string_set_remove(bench->set, g_ptr_array_index(bench->strings, i));
+    return;
+}
+
+static void
+old_remove_all (StringSetBench *bench)
+{
+    for (guint i = 0; i < bench->strings->len; i++)
+        old_string_set_remove(bench->old_set, g_ptr_array_index(bench->strings, i));
+    return;
+}
+
+int
+main (int argc, char *argv[])
+{
+    bench_init(&argc, &argv, "string-set", "1000,10000,100000");
+    guint n_sizes = 0;
+    const guint *sizes = bench_get_sizes(&n_sizes);
+    for (guint i = 0; i < n_sizes; i++) {
+        StringSetBench bench = { generate_strings(sizes[i]), NULL, NULL };
+        g_autofree gchar *add = g_strdup_printf("string_set/add/%u", sizes[i]);
+        bench_run(add, sizes[i], (BenchFunc) fill_set, &bench);
+        g_autofree gchar *old_add = g_strdup_printf("string_set/old/add/%u", sizes[i]);
+        bench_run(old_add, sizes[i], (BenchFunc) old_fill_set, &bench);
+        g_autofree gchar *contains = g_strdup_printf("string_set/contains/%u", sizes[i]);
+        bench_run(contains, sizes[i], (BenchFunc) contains_all, &bench);
+        g_autofree gchar *old_contains = g_strdup_printf("string_set/old/contains/%u", sizes[i]);
+        bench_run(old_contains, sizes[i], (BenchFunc) old_contains_all, &bench);
+        g_autofree gchar *remove = g_strdup_printf("string_set/remove/%u", sizes[i]);
+        bench_run_with_setup(remove, sizes[i], (BenchFunc) fill_set, (BenchFunc) remove_all, &bench);
+        g_autofree gchar *old_remove = g_strdup_printf("string_set/old/remove/%u", sizes[i]);
+        bench_run_with_setup(old_remove, sizes[i], (BenchFunc) old_fill_set, (BenchFunc) old_remove_all, &bench);
+        g_clear_object(&bench.set);
+        g_clear_pointer(&bench.old_set, g_ptr_array_unref);
+        g_ptr_array_unref(bench.strings);
+    }
+    return bench_finish();
+}
@@ -0,0 +1,407 @@
+/* bench-utils.c
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#include "config.h"
+
+#include <stdlib.h>
+#include <glib/gstdio.h>
+#include <fontconfig/fontconfig.h>
+#include <sqlite3.h>
+
+#include "bench-utils.h"
+#include "font-corpus.h"
+#include "font-manager-database.h"
+
+/*
+ * Shared by every benchmark in this directory.
+ *
+ * Each benchmark is timed over a number of iterations and the results are
+ * written as a single JSON document, to stdout and optionally to a file,
+ * so that runs can be compared over time or across machines.
+ *
+ * Benchmarks run in a temporary directory which also serves as the home for
+ * the application cache and configuration, so that nothing touches the
+ * database or settings of the user running them.
+ */
+
+static gint iterations = 5;
+static gchar *sizes_arg = NULL;
+static gchar *output = NULL;
+static gboolean keep = FALSE;
+
+static GOptionEntry entries[] = {
+    { "iterations", 'i', 0, G_OPTION_ARG_INT, &iterations, "Number of timed runs per benchmark", "N" },
+    { "sizes", 's', 0, G_OPTION_ARG_STRING, &sizes_arg, "Comma separated list of input sizes", "N,N,..." },
+    { "output", 'o', 0, G_OPTION_ARG_FILENAME, &output, "Also write results to FILE", "FILE" },
+    { "keep", 'k', 0, G_OPTION_ARG_NONE, &keep, "Keep the temporary directory", NULL },
+    { NULL }
+};
+
+static gchar *suite_name = NULL;
+static gchar *temp_dir = NULL;
+static GArray *sizes = NULL;
+static JsonArray *results = NULL;
+
+static void
+remove_tree (const gchar *path)
+{
+    if (g_file_test(path, G_FILE_TEST_IS_DIR) && !g_file_test(path, G_FILE_TEST_IS_SYMLINK)) {
+        GDir *dir = g_dir_open(path, 0, NULL);
+        const gchar *name;
+        while (dir != NULL && (name = g_dir_read_name(dir)) != NULL) {
+            g_autofree gchar *child = g_build_filename(path, name, NULL);
+            remove_tree(child);
+        }
+        if (dir != NULL)
+            g_dir_close(dir);
+        g_rmdir(path);
+    } else {
+        g_unlink(path);
+    }
+    return;
+}
+
+/**
+ * bench_init:
+ * @argc:           argument count
+ * @argv:           argument vector
+ * @suite:          name of this benchmark suite
+ * @default_sizes:  input sizes used unless --sizes is given
+ *
+ * Must be called before anything reads the user directories.
+ */
+void
+bench_init (int *argc, char ***argv, const gchar *suite, const gchar *default_sizes)
+{
+    g_autoptr(GOptionContext) context = g_option_context_new(NULL);
+    g_option_context_add_main_entries(context, entries, NULL);
+    g_autoptr(GError) error = NULL;
+    if (!g_option_context_parse(context, argc, argv, &error)) {
+        g_printerr("%s\n", error->message);
+        exit(EXIT_FAILURE);
+    }
+    suite_name = g_strdup(suite);
+    temp_dir = g_dir_make_tmp("font-manager-benchmark-XXXXXX", &error);
+    if (temp_dir == NULL) {
+        g_printerr("%s\n", error->message);
+        exit(EXIT_FAILURE);
+    }
+    const gchar *dirs[][2] = {
+        { "XDG_CACHE_HOME", "cache" },
+        { "XDG_CONFIG_HOME", "config" },
+        { "XDG_DATA_HOME", "data" }
+    };
+    for (guint i = 0; i < G_N_ELEMENTS(dirs); i++) {
+        g_autofree gchar *dir = g_build_filename(temp_dir, dirs[i][1], NULL);
+        g_mkdir_with_parents(dir, 0755);
+        g_setenv(dirs[i][0], dir, TRUE);
+    }
+    sizes = g_array_new(FALSE, FALSE, sizeof(guint));
+    g_auto(GStrv) values = g_strsplit(sizes_arg != NULL ? sizes_arg : default_sizes, ",", -1);
+    for (gint i = 0; values[i] != NULL; i++) {
+        guint size = (guint) g_ascii_strtoull(values[i], NULL, 10);
+        if (size > 0)
+            g_array_append_val(sizes, size);
+    }
+    iterations = MAX(iterations, 1);
+    results = json_array_new();
+    return;
+}
+
+/**
+ * bench_get_sizes:
+ * @n_sizes: (out): number of sizes
+ *
+ * Returns: (transfer none) (array length=n_sizes): input sizes to benchmark
+ */
+const guint *
+bench_get_sizes (guint *n_sizes)
+{
+    *n_sizes = sizes->len;
+    return (const guint *) sizes->data;
+}
+
+/**
+ * bench_get_temp_dir:
+ *
+ * Returns: (transfer none): directory removed once the benchmark finishes
+ */
+const gchar *
+bench_get_temp_dir (void)
+{
+    return temp_dir;
+}
+
+static gint
+compare_times (const gint64 *a, const gint64 *b)
+{
+    return *a < *b ? -1 : *a > *b;
+}
+
+/**
+ * bench_run_with_setup:
+ * @name:       name of this benchmark, including any parameters
+ * @n_items:    number of items processed per iteration, used for throughput
+ * @setup:      (nullable): called before every iteration, not timed
+ * @func:       timed function
+ * @data:       passed to @setup and @func
+ */
+void
+bench_run_with_setup (const gchar *name, guint n_items, BenchFunc setup, BenchFunc func, gpointer data)
+{
+    g_autofree gint64 *times = g_new(gint64, iterations);
+    gint64 total = 0;
+    for (gint i = 0; i < iterations; i++) {
+        if (setup != NULL)
+            setup(data);
+        gint64 start = g_get_monotonic_time();
+        func(data);
+        times[i] = MAX(g_get_monotonic_time() - start, 1);
+        total += times[i];
+    }
+    qsort(times, iterations, sizeof(gint64), (GCompareFunc) compare_times);
+    gint64 median = times[iterations / 2];
+    JsonObject *result = json_object_new();
+    json_object_set_string_member(result, "name", name);
+    json_object_set_int_member(result, "items", n_items);
+    json_object_set_int_member(result, "iterations", iterations);
+    json_object_set_int_member(result, "min", times[0]);
+    json_object_set_int_member(result, "median", median);
+    json_object_set_int_member(result, "mean", total / iterations);
+    json_object_set_int_member(result, "max", times[iterations - 1]);
+    json_object_set_double_member(result, "items_per_second", n_items / (median / (gdouble) G_USEC_PER_SEC));
+    json_array_add_object_element(results, result);
+    g_printerr("%-48s %12" G_GINT64_FORMAT " µs %14.0f items/s\n",
+               name, median, n_items / (median / (gdouble) G_USEC_PER_SEC));
+    return;
+}
+
+/**
+ * bench_run:
+ * @name:       name of this benchmark, including any parameters
+ * @n_items:    number of items processed per iteration, used for throughput
+ * @func:       timed function
+ * @data:       passed to @func
+ */
+void
+bench_run (const gchar *name, guint n_items, BenchFunc func, gpointer data)
+{
+    bench_run_with_setup(name, n_items, NULL, func, data);
+    return;
+}
+
+/**
+ * bench_finish:
+ *
+ * Writes results and removes the temporary directory.
+ * All times are in microseconds.
+ *
+ * Returns: exit status
+ */
+gint
+bench_finish (void)
+{
+    JsonObject *system = json_object_new();
+    json_object_set_string_member(system, "version", PACKAGE_VERSION);
+    json_object_set_int_member(system, "processors", g_get_num_processors());
+    json_object_set_int_member(system, "fontconfig", FcGetVersion());
+    json_object_set_string_member(system, "sqlite", sqlite3_libversion());
+    g_autofree gchar *glib_version = g_strdup_printf("%u.%u.%u", glib_major_version,
+                                                     glib_minor_version, glib_micro_version);
+    json_object_set_string_member(system, "glib", glib_version);
+    g_autoptr(JsonObject) document = json_object_new();
+    json_object_set_string_member(document, "suite", suite_name);
+    json_object_set_object_member(document, "system", system);
+    json_object_set_array_member(document, "results", g_steal_pointer(&results));
+    g_autoptr(JsonNode) root = json_node_init_object(json_node_alloc(), document);
+    g_autofree gchar *json = json_to_string(root, TRUE);
+    g_print("%s\n", json);
+    gint status = EXIT_SUCCESS;
+    g_autoptr(GError) error = NULL;
+    if (output != NULL && !g_file_set_contents(output, json, -1, &error)) {
+        g_printerr("%s\n", error->message);
+        status = EXIT_FAILURE;
+    }
+    if (keep)
+        g_printerr("Temporary directory kept : %s\n", temp_dir);
+    else
+        remove_tree(temp_dir);
+    g_clear_pointer(&temp_dir, g_free);
+    g_clear_pointer(&suite_name, g_free);
+    g_clear_pointer(&sizes, g_array_unref);
+    return status;
+}
+
+/**
+ * bench_use_font_directory:
+ * @directory:  directory containing fonts
+ *
+ * Replaces the current Fontconfig configuration with one that only
+ * contains the fonts in @directory, i.e. a generated corpus.
+ */
+void
+bench_use_font_directory (const gchar *directory)
+{
+    FcConfig *config = FcConfigCreate();
+    if (!FcConfigAppFontAddDir(config, (const FcChar8 *) directory))
+        g_printerr("Failed to add %s to configuration\n", directory);
+    FcConfigSetCurrent(config);
+    return;
+}
+
+/**
+ * bench_use_font_corpus:
+ * @n_faces:        number of faces
+ * @n_codepoints:   number of codepoints mapped by each face
+ *
+ * Writes a corpus of Latin fonts, four styles per family, to the temporary
+ * directory and makes it the only source of fonts, see #bench_use_font_directory.
+ *
+ * Returns: %TRUE on success
+ */
+gboolean
+bench_use_font_corpus (guint n_faces, guint n_codepoints)
+{
+    g_autofree gchar *name = g_strdup_printf("corpus-%u-%u", n_faces, n_codepoints);
+    g_autofree gchar *directory = g_build_filename(temp_dir, name, NULL);
+    FontCorpusOptions options = { n_faces, 4, n_codepoints, FONT_CORPUS_LATIN };
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) files = font_corpus_write(directory, &options, &error);
+    if (files == NULL) {
+        g_printerr("%s\n", error->message);
+        return FALSE;
+    }
+    bench_use_font_directory(directory);
+    return TRUE;
+}
+
+/**
+ * bench_reset_database:
+ *
+ * Replaces the application database with an empty one using the current schema.
+ *
+ * Returns: (transfer full): path to the database file
+ */
+gchar *
+bench_reset_database (void)
+{
+    g_autofree gchar *cache_dir = font_manager_get_package_cache_directory();
+    g_autofree gchar *filename = g_strdup_printf("%s.sqlite", PACKAGE_NAME);
+    gchar *filepath = g_build_filename(cache_dir, filename, NULL);
+    static const gchar *suffixes[] = { "", "-wal", "-shm" };
+    for (guint i = 0; i < G_N_ELEMENTS(suffixes); i++) {
+        g_autofree gchar *path = g_strdup_printf("%s%s", filepath, suffixes[i]);
+        g_unlink(path);
+    }
+    g_object_unref(font_manager_database_new());
+    return filepath;
+}
+
+static const gchar *KINDS[] = { "Sans", "Serif", "Mono", "Display" };
+
+typedef struct
+{
+    const gchar *name;
+    gint weight;
+    gint slant;
+}
+SyntheticStyle;
+
+static const SyntheticStyle STYLES[] = {
+    { "Regular", FC_WEIGHT_REGULAR, FC_SLANT_ROMAN },
+    { "Bold", FC_WEIGHT_BOLD, FC_SLANT_ROMAN },
+    { "Italic", FC_WEIGHT_REGULAR, FC_SLANT_ITALIC },
+    { "Bold Italic", FC_WEIGHT_BOLD, FC_SLANT_ITALIC }
+};
+
+/**
+ * bench_create_font_table:
+ * @n_faces:    number of faces
+ *
+ * Generated from patterns rather than files, for benchmarks which never
+ * open the fonts listed.
+ *
+ * Returns: (transfer full): sorted #FontManagerFontTable
+ */
+FontManagerFontTable *
+bench_create_font_table (guint n_faces)
+{
+    FontManagerFontTable *table = font_manager_font_table_new();
+    for (guint i = 0; i < n_faces; i++) {
+        guint family_index = i / G_N_ELEMENTS(STYLES);
+        const SyntheticStyle *style = &STYLES[i % G_N_ELEMENTS(STYLES)];
+        g_autofree gchar *family = g_strdup_printf("Synthetic %s %05u",
+                                                   KINDS[family_index % G_N_ELEMENTS(KINDS)],
+                                                   family_index);
+        g_autofree gchar *filepath = g_strdup_printf("/synthetic/%06u.ttf", i);
+        FcPattern *pattern = FcPatternBuild(NULL,
+                                            FC_FAMILY, FcTypeString, family,
+                                            FC_STYLE, FcTypeString, style->name,
+                                            FC_FILE, FcTypeString, filepath,
+                                            FC_INDEX, FcTypeInteger, 0,
+                                            FC_WEIGHT, FcTypeInteger, style->weight,
+                                            FC_SLANT, FcTypeInteger, style->slant,
+                                            FC_WIDTH, FcTypeInteger, FC_WIDTH_NORMAL,
+                                            FC_SPACING, FcTypeInteger, FC_PROPORTIONAL,
+                                            NULL);
+        font_manager_font_table_add_pattern(table, pattern);
+        FcPatternDestroy(pattern);
+    }
+    font_manager_font_table_sort(table);
+    return table;
+}
+
+/**
+ * bench_create_font_listing:
+ * @n_faces:    number of faces
+ *
+ * Returns: (transfer full): #JsonObject structured like the result of
+ * #font_manager_get_available_fonts
+ */
+JsonObject *
+bench_create_font_listing (guint n_faces)
+{
+    JsonObject *listing = json_object_new();
+    /* Families are added in reverse so that sorting has something to do */
+    for (guint n = n_faces; n > 0; n--) {
+        guint i = n - 1;
+        guint family_index = i / G_N_ELEMENTS(STYLES);
+        const SyntheticStyle *style = &STYLES[i % G_N_ELEMENTS(STYLES)];
+        g_autofree gchar *family = g_strdup_printf("Synthetic %s %u",
+                                                   KINDS[family_index % G_N_ELEMENTS(KINDS)],
+                                                   family_index);
+        g_autofree gchar *filepath = g_strdup_printf("/synthetic/%06u.ttf", i);
+        g_autofree gchar *description = g_strdup_printf("%s %s", family, style->name);
+        if (!json_object_has_member(listing, family))
+            json_object_set_object_member(listing, family, json_object_new());
+        JsonObject *font = json_object_new();
+        json_object_set_string_member(font, "filepath", filepath);
+        json_object_set_int_member(font, "findex", 0);
+        json_object_set_string_member(font, "family", family);
+        json_object_set_string_member(font, "style", style->name);
+        json_object_set_int_member(font, "spacing", FC_PROPORTIONAL);
+        json_object_set_int_member(font, "slant", style->slant);
+        json_object_set_int_member(font, "weight", style->weight);
+        json_object_set_int_member(font, "width", FC_WIDTH_NORMAL);
+        json_object_set_string_member(font, "description", description);
+        json_object_set_object_member(json_object_get_object_member(listing, family), style->name, font);
+    }
+    return listing;
+}
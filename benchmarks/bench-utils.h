@@ -0,0 +1,40 @@
+/* bench-utils.h
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#pragma once
+
+#include <glib.h>
+#include <json-glib/json-glib.h>
+
+#include "font-manager-font-table.h"
+
+typedef void (*BenchFunc) (gpointer data);
+
+void bench_init (int *argc, char ***argv, const gchar *suite, const gchar *default_sizes);
+const guint * bench_get_sizes (guint *n_sizes);
+const gchar * bench_get_temp_dir (void);
+void bench_run (const gchar *name, guint n_items, BenchFunc func, gpointer data);
+void bench_run_with_setup (const gchar *name, guint n_items, BenchFunc setup, BenchFunc func, gpointer data);
+gint bench_finish (void);
+void bench_use_font_directory (const gchar *directory);
+gboolean bench_use_font_corpus (guint n_faces, guint n_codepoints);
+gchar * bench_reset_database (void);
+FontManagerFontTable * bench_create_font_table (guint n_faces);
+JsonObject * bench_create_font_listing (guint n_faces);
@@ -0,0 +1,646 @@
+/* font-corpus.c
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib/gstdio.h>
+
+#include "font-corpus.h"
+
+/*
+ * Writes minimal but complete TrueType fonts, enough for Fontconfig, FreeType
+ * and HarfBuzz to treat them like any other installed font. Every glyph is the
+ * same box outline, only the names, style properties and cmap differ.
+ */
+
+#define UNITS_PER_EM 1000
+#define ADVANCE_WIDTH 600
+#define MAX_CODEPOINTS 65534
+
+typedef struct
+{
+    gunichar start;
+    gunichar end;
+}
+CodepointRange;
+
+/* Ranges must be sorted, codepoints are taken from each in order */
+static const CodepointRange LATIN_RANGES[] = {
+    { 0x0020, 0x007E },
+    { 0x00A0, 0x024F },
+    { 0x1E00, 0x1EFF }
+};
+
+static const CodepointRange CJK_RANGES[] = {
+    { 0x0020, 0x007E },
+    { 0x3000, 0x30FF },
+    { 0x4E00, 0x9FFF },
+    { 0xAC00, 0xD7A3 },
+    { 0x20000, 0x2A6DF }
+};
+
+static const CodepointRange SYMBOL_RANGES[] = {
+    { 0x0020, 0x0020 },
+    { 0x2190, 0x23FF },
+    { 0x2500, 0x27BF },
+    { 0x1F300, 0x1F5FF }
+};
+
+typedef struct
+{
+    const gchar *tag;
+    GByteArray *data;
+}
+Table;
+
+static void
+put_u8 (GByteArray *buffer, guint8 value)
+{
+    g_byte_array_append(buffer, &value, 1);
+    return;
+}
+
+static void
+put_u16 (GByteArray *buffer, guint16 value)
+{
+    guint8 data[2] = { value >> 8, value & 0xFF };
+    g_byte_array_append(buffer, data, sizeof(data));
+    return;
+}
+
+static void
+put_i16 (GByteArray *buffer, gint16 value)
+{
+    put_u16(buffer, (guint16) value);
+    return;
+}
+
+static void
+put_u32 (GByteArray *buffer, guint32 value)
+{
+    guint8 data[4] = { value >> 24, (value >> 16) & 0xFF, (value >> 8) & 0xFF, value & 0xFF };
+    g_byte_array_append(buffer, data, sizeof(data));
+    return;
+}
+
+static void
+put_zeros (GByteArray *buffer, guint n)
+{
+    while (n-- > 0)
+        put_u8(buffer, 0);
+    return;
+}
+
+static void
+set_u32 (GByteArray *buffer, guint offset, guint32 value)
+{
+    buffer->data[offset] = value >> 24;
+    buffer->data[offset + 1] = (value >> 16) & 0xFF;
+    buffer->data[offset + 2] = (value >> 8) & 0xFF;
+    buffer->data[offset + 3] = value & 0xFF;
+    return;
+}
+
+static guint32
+get_checksum (const guint8 *data, guint length)
+{
+    guint32 sum = 0;
+    for (guint i = 0; i < length; i += 4) {
+        guint32 word = 0;
+        for (guint j = 0; j < 4; j++)
+            word = (word << 8) | (i + j < length ? data[i + j] : 0);
+        sum += word;
+    }
+    return sum;
+}
+
+static guint
+floor_log2 (guint n)
+{
+    guint result = 0;
+    while (n > 1) {
+        n >>= 1;
+        result++;
+    }
+    return result;
+}
+
+static GArray *
+get_codepoints (FontCorpusScript script, guint n_codepoints)
+{
+    const CodepointRange *ranges = LATIN_RANGES;
+    guint n_ranges = G_N_ELEMENTS(LATIN_RANGES);
+    if (script == FONT_CORPUS_CJK) {
+        ranges = CJK_RANGES;
+        n_ranges = G_N_ELEMENTS(CJK_RANGES);
+    } else if (script == FONT_CORPUS_SYMBOL) {
+        ranges = SYMBOL_RANGES;
+        n_ranges = G_N_ELEMENTS(SYMBOL_RANGES);
+    }
+    n_codepoints = MIN(n_codepoints, MAX_CODEPOINTS);
+    GArray *codepoints = g_array_sized_new(FALSE, FALSE, sizeof(gunichar), n_codepoints);
+    for (guint r = 0; r < n_ranges && codepoints->len < n_codepoints; r++)
+        for (gunichar c = ranges[r].start; c <= ranges[r].end && codepoints->len < n_codepoints; c++)
+            g_array_append_val(codepoints, c);
+    return codepoints;
+}
+
+/* Glyph ids follow codepoint order, so every run of consecutive codepoints
+ * maps to a run of consecutive glyphs. Returns the number of codepoints in
+ * the run starting at @start, stopping at @limit. */
+static guint
+get_run_length (GArray *codepoints, guint start, gunichar limit)
+{
+    guint end = start + 1;
+    while (end < codepoints->len &&
+           g_array_index(codepoints, gunichar, end) <= limit &&
+           g_array_index(codepoints, gunichar, end) == g_array_index(codepoints, gunichar, end - 1) + 1)
+        end++;
+    return end - start;
+}
+
+static GByteArray *
+build_cmap_format_4 (GArray *codepoints)
+{
+    g_autoptr(GArray) starts = g_array_new(FALSE, FALSE, sizeof(guint16));
+    g_autoptr(GArray) ends = g_array_new(FALSE, FALSE, sizeof(guint16));
+    g_autoptr(GArray) deltas = g_array_new(FALSE, FALSE, sizeof(guint16));
+    for (guint i = 0; i < codepoints->len && g_array_index(codepoints, gunichar, i) < 0xFFFF;) {
+        guint n = get_run_length(codepoints, i, 0xFFFE);
+        guint16 start = g_array_index(codepoints, gunichar, i);
+        guint16 end = start + n - 1;
+        guint16 delta = (guint16) ((i + 1) - start);
+        g_array_append_val(starts, start);
+        g_array_append_val(ends, end);
+        g_array_append_val(deltas, delta);
+        i += n;
+    }
+    /* Required final segment, maps 0xFFFF to .notdef */
+    guint16 last = 0xFFFF, last_delta = 1;
+    g_array_append_val(starts, last);
+    g_array_append_val(ends, last);
+    g_array_append_val(deltas, last_delta);
+    guint seg_count = starts->len;
+    guint search_range = 2 * (1 << floor_log2(seg_count));
+    GByteArray *subtable = g_byte_array_new();
+    put_u16(subtable, 4);
+    put_u16(subtable, 16 + seg_count * 8);
+    put_u16(subtable, 0);
+    put_u16(subtable, seg_count * 2);
+    put_u16(subtable, search_range);
+    put_u16(subtable, floor_log2(search_range / 2));
+    put_u16(subtable, seg_count * 2 - search_range);
+    for (guint i = 0; i < seg_count; i++)
+        put_u16(subtable, g_array_index(ends, guint16, i));
+    put_u16(subtable, 0);
+    for (guint i = 0; i < seg_count; i++)
+        put_u16(subtable, g_array_index(starts, guint16, i));
+    for (guint i = 0; i < seg_count; i++)
+        put_u16(subtable, g_array_index(deltas, guint16, i));
+    put_zeros(subtable, seg_count * 2);
+    return subtable;
+}
+
+static GByteArray *
+build_cmap_format_12 (GArray *codepoints)
+{
+    GByteArray *groups = g_byte_array_new();
+    guint n_groups = 0;
+    for (guint i = 0; i < codepoints->len;) {
+        guint n = get_run_length(codepoints, i, G_MAXUINT32);
+        gunichar start = g_array_index(codepoints, gunichar, i);
+        put_u32(groups, start);
+        put_u32(groups, start + n - 1);
+        put_u32(groups, i + 1);
+        n_groups++;
+        i += n;
+    }
+    GByteArray *subtable = g_byte_array_new();
+    put_u16(subtable, 12);
+    put_u16(subtable, 0);
+    put_u32(subtable, 16 + groups->len);
+    put_u32(subtable, 0);
+    put_u32(subtable, n_groups);
+    g_byte_array_append(subtable, groups->data, groups->len);
+    g_byte_array_unref(groups);
+    return subtable;
+}
+
+static GByteArray *
+build_cmap (GArray *codepoints)
+{
+    g_autoptr(GByteArray) bmp = build_cmap_format_4(codepoints);
+    g_autoptr(GByteArray) full = build_cmap_format_12(codepoints);
+    GByteArray *cmap = g_byte_array_new();
+    guint header_size = 4 + 2 * 8;
+    put_u16(cmap, 0);
+    put_u16(cmap, 2);
+    put_u16(cmap, 3);
+    put_u16(cmap, 1);
+    put_u32(cmap, header_size);
+    put_u16(cmap, 3);
+    put_u16(cmap, 10);
+    put_u32(cmap, header_size + bmp->len);
+    g_byte_array_append(cmap, bmp->data, bmp->len);
+    g_byte_array_append(cmap, full->data, full->len);
+    return cmap;
+}
+
+static void
+put_name (GByteArray *records, GByteArray *strings, guint16 name_id, const gchar *str)
+{
+    glong length = 0;
+    g_autofree gunichar2 *utf16 = g_utf8_to_utf16(str, -1, NULL, &length, NULL);
+    g_return_if_fail(utf16 != NULL);
+    put_u16(records, 3);
+    put_u16(records, 1);
+    put_u16(records, 0x0409);
+    put_u16(records, name_id);
+    put_u16(records, length * 2);
+    put_u16(records, strings->len);
+    for (glong i = 0; i < length; i++)
+        put_u16(strings, utf16[i]);
+    return;
+}
+
+static GByteArray *
+build_name (const FontCorpusFace *face)
+{
+    g_autofree gchar *full_name = g_strdup_printf("%s %s", face->family, face->style);
+    g_autofree gchar *unique_id = g_strdup_printf("%s;corpus", full_name);
+    g_autofree gchar *ps_name = g_strdup_printf("%s-%s", face->family, face->style);
+    g_strdelimit(ps_name, " ", '_');
+    g_autoptr(GByteArray) records = g_byte_array_new();
+    g_autoptr(GByteArray) strings = g_byte_array_new();
+    /* Records must be sorted by name id */
+    put_name(records, strings, 1, face->family);
+    put_name(records, strings, 2, face->style);
+    put_name(records, strings, 3, unique_id);
+    put_name(records, strings, 4, full_name);
+    put_name(records, strings, 5, "Version 1.000");
+    put_name(records, strings, 6, ps_name);
+    if (face->designer != NULL)
+        put_name(records, strings, 9, face->designer);
+    put_name(records, strings, 13, "SIL Open Font License, Version 1.1");
+    guint count = records->len / 12;
+    GByteArray *name = g_byte_array_new();
+    put_u16(name, 0);
+    put_u16(name, count);
+    put_u16(name, 6 + count * 12);
+    g_byte_array_append(name, records->data, records->len);
+    g_byte_array_append(name, strings->data, strings->len);
+    return name;
+}
+
+static GByteArray *
+build_os2 (const FontCorpusFace *face, GArray *codepoints)
+{
+    gunichar first = codepoints->len > 0 ? g_array_index(codepoints, gunichar, 0) : 0x20;
+    gunichar last = codepoints->len > 0 ? g_array_index(codepoints, gunichar, codepoints->len - 1) : 0x20;
+    guint16 selection = 0;
+    if (face->italic)
+        selection |= 1 << 0;
+    if (face->weight >= 700)
+        selection |= 1 << 5;
+    if (!face->italic && face->weight == 400)
+        selection |= 1 << 6;
+    GByteArray *os2 = g_byte_array_new();
+    put_u16(os2, 4);
+    put_i16(os2, ADVANCE_WIDTH);
+    put_u16(os2, face->weight);
+    put_u16(os2, face->width);
+    put_u16(os2, 0);
+    /* Subscript, superscript and strikeout metrics */
+    const gint16 metrics[] = { 650, 600, 0, 75, 650, 600, 0, 350, 50, 300 };
+    for (guint i = 0; i < G_N_ELEMENTS(metrics); i++)
+        put_i16(os2, metrics[i]);
+    put_i16(os2, 0);
+    put_u8(os2, face->panose_family);
+    put_zeros(os2, 9);
+    put_zeros(os2, 16);
+    gchar vendor[4] = { ' ', ' ', ' ', ' ' };
+    if (face->vendor != NULL)
+        memcpy(vendor, face->vendor, MIN(strlen(face->vendor), sizeof(vendor)));
+    g_byte_array_append(os2, (const guint8 *) vendor, sizeof(vendor));
+    put_u16(os2, selection);
+    put_u16(os2, MIN(first, 0xFFFF));
+    put_u16(os2, MIN(last, 0xFFFF));
+    put_i16(os2, 800);
+    put_i16(os2, -200);
+    put_i16(os2, 200);
+    put_u16(os2, 1000);
+    put_u16(os2, 200);
+    put_u32(os2, 1);
+    put_u32(os2, 0);
+    put_i16(os2, 500);
+    put_i16(os2, 700);
+    put_u16(os2, 0);
+    put_u16(os2, 0x20);
+    put_u16(os2, 1);
+    return os2;
+}
+
+static GByteArray *
+build_head (const FontCorpusFace *face)
+{
+    guint16 mac_style = (face->weight >= 700 ? 1 : 0) | (face->italic ? 2 : 0);
+    GByteArray *head = g_byte_array_new();
+    put_u32(head, 0x00010000);
+    put_u32(head, 0x00010000);
+    /* checkSumAdjustment, filled in once the whole file is assembled */
+    put_u32(head, 0);
+    put_u32(head, 0x5F0F3CF5);
+    put_u16(head, 0x000B);
+    put_u16(head, UNITS_PER_EM);
+    put_zeros(head, 16);
+    put_i16(head, 100);
+    put_i16(head, 0);
+    put_i16(head, 500);
+    put_i16(head, 700);
+    put_u16(head, mac_style);
+    put_u16(head, 8);
+    put_i16(head, 2);
+    /* Long loca offsets */
+    put_i16(head, 1);
+    put_i16(head, 0);
+    return head;
+}
+
+static GByteArray *
+build_hhea (void)
+{
+    GByteArray *hhea = g_byte_array_new();
+    put_u32(hhea, 0x00010000);
+    put_i16(hhea, 800);
+    put_i16(hhea, -200);
+    put_i16(hhea, 200);
+    put_u16(hhea, ADVANCE_WIDTH);
+    put_i16(hhea, 100);
+    put_i16(hhea, 100);
+    put_i16(hhea, 500);
+    put_i16(hhea, 1);
+    put_i16(hhea, 0);
+    put_i16(hhea, 0);
+    put_zeros(hhea, 8);
+    put_i16(hhea, 0);
+    /* Every glyph has the same advance */
+    put_u16(hhea, 1);
+    return hhea;
+}
+
+static GByteArray *
+build_hmtx (guint n_glyphs)
+{
+    GByteArray *hmtx = g_byte_array_new();
+    put_u16(hmtx, ADVANCE_WIDTH);
+    put_i16(hmtx, 100);
+    for (guint i = 1; i < n_glyphs; i++)
+        put_i16(hmtx, 100);
+    return hmtx;
+}
+
+static GByteArray *
+build_maxp (guint n_glyphs)
+{
+    GByteArray *maxp = g_byte_array_new();
+    put_u32(maxp, 0x00010000);
+    put_u16(maxp, n_glyphs);
+    put_u16(maxp, 4);
+    put_u16(maxp, 1);
+    put_zeros(maxp, 4);
+    put_u16(maxp, 2);
+    put_zeros(maxp, 16);
+    return maxp;
+}
+
+static GByteArray *
+build_post (const FontCorpusFace *face)
+{
+    GByteArray *post = g_byte_array_new();
+    put_u32(post, 0x00030000);
+    put_u32(post, face->italic ? (guint32) (-12 * 65536) : 0);
+    put_i16(post, -100);
+    put_i16(post, 50);
+    put_zeros(post, 20);
+    return post;
+}
+
+/* A single contour box, padded to keep loca offsets aligned */
+static GByteArray *
+build_glyph (void)
+{
+    GByteArray *glyph = g_byte_array_new();
+    put_i16(glyph, 1);
+    put_i16(glyph, 100);
+    put_i16(glyph, 0);
+    put_i16(glyph, 500);
+    put_i16(glyph, 700);
+    put_u16(glyph, 3);
+    put_u16(glyph, 0);
+    for (guint i = 0; i < 4; i++)
+        put_u8(glyph, 0x01);
+    const gint16 x[] = { 100, 0, 400, 0 };
+    const gint16 y[] = { 0, 700, 0, -700 };
+    for (guint i = 0; i < G_N_ELEMENTS(x); i++)
+        put_i16(glyph, x[i]);
+    for (guint i = 0; i < G_N_ELEMENTS(y); i++)
+        put_i16(glyph, y[i]);
+    put_zeros(glyph, 2);
+    return glyph;
+}
+
+static void
+build_glyf_and_loca (guint n_glyphs, GByteArray **glyf, GByteArray **loca)
+{
+    g_autoptr(GByteArray) glyph = build_glyph();
+    *glyf = g_byte_array_sized_new(glyph->len * n_glyphs);
+    *loca = g_byte_array_sized_new((n_glyphs + 1) * 4);
+    for (guint i = 0; i < n_glyphs; i++) {
+        put_u32(*loca, (*glyf)->len);
+        g_byte_array_append(*glyf, glyph->data, glyph->len);
+    }
+    put_u32(*loca, (*glyf)->len);
+    return;
+}
+
+static gint
+compare_tables (const Table *a, const Table *b)
+{
+    return memcmp(a->tag, b->tag, 4);
+}
+
+/**
+ * font_corpus_build_face:
+ * @face:   #FontCorpusFace
+ *
+ * Returns: (transfer full): #GBytes containing a TrueType font
+ */
+GBytes *
+font_corpus_build_face (const FontCorpusFace *face)
+{
+    g_return_val_if_fail(face != NULL && face->family != NULL && face->style != NULL, NULL);
+    g_autoptr(GArray) codepoints = get_codepoints(face->script, face->n_codepoints);
+    guint n_glyphs = codepoints->len + 1;
+    GByteArray *glyf = NULL, *loca = NULL;
+    build_glyf_and_loca(n_glyphs, &glyf, &loca);
+    Table tables[] = {
+        { "OS/2", build_os2(face, codepoints) },
+        { "cmap", build_cmap(codepoints) },
+        { "glyf", glyf },
+        { "head", build_head(face) },
+        { "hhea", build_hhea() },
+        { "hmtx", build_hmtx(n_glyphs) },
+        { "loca", loca },
+        { "maxp", build_maxp(n_glyphs) },
+        { "name", build_name(face) },
+        { "post", build_post(face) }
+    };
+    guint n_tables = G_N_ELEMENTS(tables);
+    qsort(tables, n_tables, sizeof(Table), (GCompareFunc) compare_tables);
+    guint search_range = (1 << floor_log2(n_tables)) * 16;
+    GByteArray *font = g_byte_array_new();
+    put_u32(font, 0x00010000);
+    put_u16(font, n_tables);
+    put_u16(font, search_range);
+    put_u16(font, floor_log2(n_tables));
+    put_u16(font, n_tables * 16 - search_range);
+    guint offset = 12 + n_tables * 16;
+    guint head_offset = 0;
+    for (guint i = 0; i < n_tables; i++) {
+        GByteArray *data = tables[i].data;
+        g_byte_array_append(font, (const guint8 *) tables[i].tag, 4);
+        put_u32(font, get_checksum(data->data, data->len));
+        put_u32(font, offset);
+        put_u32(font, data->len);
+        if (g_strcmp0(tables[i].tag, "head") == 0)
+            head_offset = offset;
+        offset += (data->len + 3) & ~3U;
+    }
+    for (guint i = 0; i < n_tables; i++) {
+        GByteArray *data = tables[i].data;
+        g_byte_array_append(font, data->data, data->len);
+        put_zeros(font, ((data->len + 3) & ~3U) - data->len);
+        g_byte_array_unref(data);
+    }
+    set_u32(font, head_offset + 8, 0xB1B0AFBA - get_checksum(font->data, font->len));
+    return g_byte_array_free_to_bytes(font);
+}
+
+typedef struct
+{
+    const gchar *name;
+    guint16 weight;
+    guint16 width;
+    gboolean italic;
+}
+CorpusStyle;
+
+static const CorpusStyle STYLES[] = {
+    { "Regular", 400, 5, FALSE },
+    { "Bold", 700, 5, FALSE },
+    { "Italic", 400, 5, TRUE },
+    { "Bold Italic", 700, 5, TRUE },
+    { "Light", 300, 5, FALSE },
+    { "Medium", 500, 5, FALSE },
+    { "Condensed", 400, 3, FALSE },
+    { "Black", 900, 5, FALSE }
+};
+
+static const gchar *KINDS[] = { "Sans", "Serif", "Mono", "Display" };
+static const gchar *DESIGNERS[] = { "Ada Lovelace", "Claude Garamond", "Adrian Frutiger", NULL };
+static const gchar *VENDORS[] = { "ADBE", "GOOG", "MONO", "CRPS", "UKWN" };
+
+/**
+ * font_corpus_write:
+ * @directory:  directory to write files to, created if needed
+ * @options:    #FontCorpusOptions
+ * @error: (nullable): #GError or %NULL to ignore errors
+ *
+ * Writes one file per face. Faces are grouped into families of
+ * @options->styles_per_family, each with a different style.
+ *
+ * Returns: (transfer full) (nullable): #GPtrArray containing the path of
+ * each file written or %NULL on error
+ */
+GPtrArray *
+font_corpus_write (const gchar *directory, const FontCorpusOptions *options, GError **error)
+{
+    g_return_val_if_fail(directory != NULL && options != NULL, NULL);
+    g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+    if (g_mkdir_with_parents(directory, 0755) != 0) {
+        g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(errno),
+                    "Failed to create %s : %s", directory, g_strerror(errno));
+        return NULL;
+    }
+    guint styles_per_family = CLAMP(options->styles_per_family, 1, G_N_ELEMENTS(STYLES));
+    GPtrArray *files = g_ptr_array_new_with_free_func(g_free);
+    for (guint i = 0; i < options->n_faces; i++) {
+        guint family_index = i / styles_per_family;
+        const CorpusStyle *style = &STYLES[i % styles_per_family];
+        g_autofree gchar *family = g_strdup_printf("Corpus %s %05u",
+                                                   KINDS[family_index % G_N_ELEMENTS(KINDS)],
+                                                   family_index);
+        FontCorpusFace face = {
+            family,
+            style->name,
+            style->weight,
+            style->width,
+            style->italic,
+            options->script,
+            options->n_codepoints,
+            DESIGNERS[family_index % G_N_ELEMENTS(DESIGNERS)],
+            VENDORS[family_index % G_N_ELEMENTS(VENDORS)],
+            2 + family_index % 4
+        };
+        g_autoptr(GBytes) bytes = font_corpus_build_face(&face);
+        g_autofree gchar *filename = g_strdup_printf("corpus-%06u.ttf", i);
+        gchar *filepath = g_build_filename(directory, filename, NULL);
+        gsize size = 0;
+        gconstpointer data = g_bytes_get_data(bytes, &size);
+        if (!g_file_set_contents(filepath, data, size, error)) {
+            g_free(filepath);
+            g_ptr_array_unref(files);
+            return NULL;
+        }
+        g_ptr_array_add(files, filepath);
+    }
+    return files;
+}
+
+/**
+ * font_corpus_parse_script:
+ * @name:   one of "latin", "cjk" or "symbol"
+ * @script: (out): #FontCorpusScript
+ *
+ * Returns: %TRUE if @name is a valid script name
+ */
+gboolean
+font_corpus_parse_script (const gchar *name, FontCorpusScript *script)
+{
+    static const gchar *names[] = { "latin", "cjk", "symbol" };
+    for (guint i = 0; i < G_N_ELEMENTS(names); i++) {
+        if (g_strcmp0(name, names[i]) == 0) {
+            *script = (FontCorpusScript) i;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
@@ -0,0 +1,88 @@
+/* font-corpus.h
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#pragma once
+
+#include <glib.h>
+
+/**
+ * FontCorpusScript:
+ * @FONT_CORPUS_LATIN:  Basic Latin through Latin Extended Additional
+ * @FONT_CORPUS_CJK:    Kana, CJK Unified Ideographs and Hangul
+ * @FONT_CORPUS_SYMBOL: Arrows, math operators, box drawing, dingbats and emoji
+ *
+ * Determines which codepoints a generated face maps, in order, until the
+ * requested number of codepoints is reached.
+ */
+typedef enum
+{
+    FONT_CORPUS_LATIN,
+    FONT_CORPUS_CJK,
+    FONT_CORPUS_SYMBOL
+}
+FontCorpusScript;
+
+/**
+ * FontCorpusFace:
+ * @family:         family name
+ * @style:          style name
+ * @weight:         OS/2 usWeightClass
+ * @width:          OS/2 usWidthClass
+ * @italic:         whether the face is italic
+ * @script:         #FontCorpusScript
+ * @n_codepoints:   number of codepoints mapped in the cmap
+ * @designer:       (nullable): designer name
+ * @vendor:         (nullable): four character vendor id
+ * @panose_family:  first byte of the PANOSE classification
+ */
+typedef struct
+{
+    const gchar *family;
+    const gchar *style;
+    guint16 weight;
+    guint16 width;
+    gboolean italic;
+    FontCorpusScript script;
+    guint n_codepoints;
+    const gchar *designer;
+    const gchar *vendor;
+    guint8 panose_family;
+}
+FontCorpusFace;
+
+/**
+ * FontCorpusOptions:
+ * @n_faces:            total number of faces, one file each
+ * @styles_per_family:  number of faces sharing a family name
+ * @n_codepoints:       number of codepoints mapped by each face
+ * @script:             #FontCorpusScript
+ */
+typedef struct
+{
+    guint n_faces;
+    guint styles_per_family;
+    guint n_codepoints;
+    FontCorpusScript script;
+}
+FontCorpusOptions;
+
+GBytes * font_corpus_build_face (const FontCorpusFace *face);
+GPtrArray * font_corpus_write (const gchar *directory, const FontCorpusOptions *options, GError **error);
+gboolean font_corpus_parse_script (const gchar *name, FontCorpusScript *script);
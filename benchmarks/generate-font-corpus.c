@@ -0,0 +1,100 @@
+/* generate-font-corpus.c
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#include <stdlib.h>
+#include <glib/gstdio.h>
+#include <json-glib/json-glib.h>
+
+#include "font-corpus.h"
+
+/*
+ * Writes a synthetic font corpus for use with the benchmarks or for manual
+ * testing, e.g. by pointing a user font directory at it, and prints a JSON
+ * summary of what was written.
+ */
+
+static gchar *output = NULL;
+static gint n_faces = 1000;
+static gint styles_per_family = 4;
+static gint n_codepoints = 256;
+static gchar *script_name = NULL;
+
+static GOptionEntry entries[] = {
+    { "output", 'o', 0, G_OPTION_ARG_FILENAME, &output, "Directory to write fonts to", "DIR" },
+    { "faces", 'f', 0, G_OPTION_ARG_INT, &n_faces, "Number of faces to generate", "N" },
+    { "styles", 's', 0, G_OPTION_ARG_INT, &styles_per_family, "Number of styles per family (1-8)", "N" },
+    { "codepoints", 'c', 0, G_OPTION_ARG_INT, &n_codepoints, "Number of codepoints mapped by each face", "N" },
+    { "script", 0, 0, G_OPTION_ARG_STRING, &script_name, "One of latin, cjk or symbol", "SCRIPT" },
+    { NULL }
+};
+
+int
+main (int argc, char *argv[])
+{
+    g_autoptr(GOptionContext) context = g_option_context_new(NULL);
+    g_option_context_set_summary(context, "Generate a synthetic font corpus");
+    g_option_context_add_main_entries(context, entries, NULL);
+    g_autoptr(GError) error = NULL;
+    if (!g_option_context_parse(context, &argc, &argv, &error)) {
+        g_printerr("%s\n", error->message);
+        return EXIT_FAILURE;
+    }
+    FontCorpusScript script = FONT_CORPUS_LATIN;
+    if (output == NULL || n_faces < 1 || n_codepoints < 1 ||
+        (script_name != NULL && !font_corpus_parse_script(script_name, &script))) {
+        g_autofree gchar *help = g_option_context_get_help(context, TRUE, NULL);
+        g_printerr("%s", help);
+        return EXIT_FAILURE;
+    }
+    FontCorpusOptions options = {
+        (guint) n_faces,
+        (guint) MAX(styles_per_family, 1),
+        (guint) n_codepoints,
+        script
+    };
+    g_autoptr(GPtrArray) files = font_corpus_write(output, &options, &error);
+    if (files == NULL) {
+        g_printerr("%s\n", error->message);
+        return EXIT_FAILURE;
+    }
+    gint64 total = 0;
+    for (guint i = 0; i < files->len; i++) {
+        GStatBuf st;
+        if (g_stat(g_ptr_array_index(files, i), &st) == 0)
+            total += st.st_size;
+    }
+    g_autoptr(JsonBuilder) builder = json_builder_new();
+    json_builder_begin_object(builder);
+    json_builder_set_member_name(builder, "directory");
+    json_builder_add_string_value(builder, output);
+    json_builder_set_member_name(builder, "faces");
+    json_builder_add_int_value(builder, files->len);
+    json_builder_set_member_name(builder, "codepoints");
+    json_builder_add_int_value(builder, n_codepoints);
+    json_builder_set_member_name(builder, "script");
+    json_builder_add_string_value(builder, script_name != NULL ? script_name : "latin");
+    json_builder_set_member_name(builder, "bytes");
+    json_builder_add_int_value(builder, total);
+    json_builder_end_object(builder);
+    g_autoptr(JsonNode) root = json_builder_get_root(builder);
+    g_autofree gchar *json = json_to_string(root, TRUE);
+    g_print("%s\n", json);
+    return EXIT_SUCCESS;
+}
@@ -31,8 +31,16 @@
  * @stability: Unstable
  *
  * Database class and related functions.
+ *
+ * The database is kept in WAL mode so that a single writer, normally the
+ * connection passed to #font_manager_update_database, never blocks readers.
+ * Code which only reads from the database should use
+ * #font_manager_database_get_reader.
  */
 
+/* Milliseconds to wait on a locked database before giving up */
+#define BUSY_TIMEOUT 5000
+
 #define CREATE_FONTS_TABLE "CREATE TABLE IF NOT EXISTS Fonts ( " \
 "uid INTEGER PRIMARY KEY, filepath TEXT, findex INTEGER, family TEXT, " \
 "style TEXT, spacing INTEGER, slant INTEGER, weight INTEGER, " \
@@ -51,7 +59,20 @@
 "filepath TEXT, findex INTEGER );\n"
 
 #define CREATE_ORTH_TABLE "CREATE TABLE IF NOT EXISTS Orthography ( " \
-"uid INTEGER PRIMARY KEY, filepath TEXT, findex INT, support TEXT, sample TEXT );\n"
+"uid INTEGER PRIMARY KEY, filepath TEXT, findex INT, sample TEXT );\n"
+
+#define CREATE_COVERAGE_TABLE "CREATE TABLE IF NOT EXISTS Coverage ( " \
+"filepath TEXT NOT NULL, findex INTEGER NOT NULL, orthography TEXT NOT NULL, " \
+"coverage REAL NOT NULL );\n"
+
+#define CREATE_FILE_STATE_TABLE "CREATE TABLE IF NOT EXISTS FileState ( " \
+"filepath TEXT NOT NULL, findex INTEGER NOT NULL, mtime INTEGER, size INTEGER, " \
+"inode INTEGER, PRIMARY KEY (filepath, findex) );\n"
+
+/* Ranges are stored as pairs of little-endian 32-bit codepoints, first and last */
+#define CREATE_CODEPOINTS_TABLE "CREATE TABLE IF NOT EXISTS Codepoints ( " \
+"filepath TEXT NOT NULL, findex INTEGER NOT NULL, ranges BLOB, " \
+"PRIMARY KEY (filepath, findex) );\n"
 
 #define CREATE_FONT_MATCH_INDEX "CREATE INDEX IF NOT EXISTS font_match_idx " \
 "ON Fonts (filepath, findex, family, description);\n"
@@ -62,30 +83,254 @@
 #define CREATE_PANOSE_MATCH_INDEX "CREATE INDEX IF NOT EXISTS panose_match_idx " \
 "ON Panose (filepath, findex, P0);\n"
 
+#define CREATE_ORTH_MATCH_INDEX "CREATE INDEX IF NOT EXISTS orth_match_idx " \
+"ON Orthography (filepath, findex);\n"
+
+#define CREATE_COVERAGE_MATCH_INDEX "CREATE INDEX IF NOT EXISTS coverage_match_idx " \
+"ON Coverage (orthography, coverage);\n"
+
+#define CREATE_COVERAGE_FACE_INDEX "CREATE INDEX IF NOT EXISTS coverage_face_idx " \
+"ON Coverage (filepath, findex);\n"
+
+/* Trigram tokenizer allows case-insensitive matches anywhere within a field */
+#define CREATE_SEARCH_INDEX "CREATE VIRTUAL TABLE IF NOT EXISTS SearchIndex USING fts5 ( " \
+"family, style, description, psname, designer, vendor, filepath, tokenize = 'trigram' );\n"
+
+/* Keep SearchIndex in sync with Fonts, rowid in SearchIndex is Fonts.uid */
+#define CREATE_SEARCH_INSERT_TRIGGER "CREATE TRIGGER IF NOT EXISTS search_index_insert " \
+"AFTER INSERT ON Fonts BEGIN INSERT OR REPLACE INTO SearchIndex (rowid, family, style, " \
+"description, psname, designer, vendor, filepath) VALUES (new.uid, new.family, new.style, " \
+"new.description, " \
+"(SELECT psname FROM Metadata WHERE filepath = new.filepath AND findex = new.findex), " \
+"(SELECT designer FROM Metadata WHERE filepath = new.filepath AND findex = new.findex), " \
+"(SELECT vendor FROM Metadata WHERE filepath = new.filepath AND findex = new.findex), " \
+"new.filepath); END;\n"
+
+#define CREATE_SEARCH_DELETE_TRIGGER "CREATE TRIGGER IF NOT EXISTS search_index_delete " \
+"AFTER DELETE ON Fonts BEGIN DELETE FROM SearchIndex WHERE rowid = old.uid; END;\n"
+
+#define CREATE_SEARCH_METADATA_TRIGGER "CREATE TRIGGER IF NOT EXISTS search_index_metadata " \
+"AFTER INSERT ON Metadata BEGIN UPDATE SearchIndex SET psname = new.psname, " \
+"designer = new.designer, vendor = new.vendor WHERE rowid IN " \
+"(SELECT uid FROM Fonts WHERE filepath = new.filepath AND findex = new.findex); END;\n"
+
+#define POPULATE_SEARCH_INDEX "INSERT INTO SearchIndex (rowid, family, style, description, " \
+"psname, designer, vendor, filepath) SELECT Fonts.uid, Fonts.family, Fonts.style, " \
+"Fonts.description, Metadata.psname, Metadata.designer, Metadata.vendor, Fonts.filepath " \
+"FROM Fonts LEFT JOIN Metadata ON Metadata.filepath = Fonts.filepath " \
+"AND Metadata.findex = Fonts.findex GROUP BY Fonts.uid;\n"
+
+#define SELECT_SEARCH_INDEX_EXISTS "SELECT count(*) FROM sqlite_master " \
+"WHERE type = 'table' AND name = 'SearchIndex';"
+
 #define DROP_FONT_MATCH_INDEX "DROP INDEX IF EXISTS font_match_idx;\n"
 #define DROP_INFO_MATCH_INDEX "DROP INDEX IF EXISTS info_match_idx;\n"
 #define DROP_PANOSE_MATCH_INDEX "DROP INDEX IF EXISTS panose_match_idx;\n"
+#define DROP_ORTH_MATCH_INDEX "DROP INDEX IF EXISTS orth_match_idx;\n"
+#define DROP_COVERAGE_MATCH_INDEX "DROP INDEX IF EXISTS coverage_match_idx;\n"
+#define DROP_COVERAGE_FACE_INDEX "DROP INDEX IF EXISTS coverage_face_idx;\n"
+#define DROP_SEARCH_INSERT_TRIGGER "DROP TRIGGER IF EXISTS search_index_insert;\n"
+#define DROP_SEARCH_DELETE_TRIGGER "DROP TRIGGER IF EXISTS search_index_delete;\n"
+#define DROP_SEARCH_METADATA_TRIGGER "DROP TRIGGER IF EXISTS search_index_metadata;\n"
 
 #define INSERT_FONT_ROW "INSERT OR REPLACE INTO Fonts VALUES (NULL,?,?,?,?,?,?,?,?,?);"
 #define INSERT_INFO_ROW "INSERT OR REPLACE INTO Metadata VALUES (NULL,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);"
 #define INSERT_PANOSE_ROW "INSERT OR REPLACE INTO Panose VALUES (NULL,?,?,?,?,?,?,?,?,?,?,?,?);"
-#define INSERT_ORTH_ROW "INSERT OR REPLACE INTO Orthography VALUES (NULL, ?, ?, ?, ?);"
+#define INSERT_ORTH_ROW "INSERT OR REPLACE INTO Orthography VALUES (NULL, ?, ?, ?);"
+#define INSERT_COVERAGE_ROW "INSERT INTO Coverage VALUES (?, ?, ?, ?);"
+#define INSERT_CODEPOINTS_ROW "INSERT OR REPLACE INTO Codepoints VALUES (?, ?, ?);"
+#define INSERT_FILE_STATE_ROW "INSERT OR REPLACE INTO FileState VALUES (?, ?, ?, ?, ?);"
+
+#define REPLACE_FONT_ROW "INSERT OR REPLACE INTO Fonts (filepath, findex, family, style, " \
+"spacing, slant, weight, width, description, uid) VALUES (?,?,?,?,?,?,?,?,?,?);"
+#define DELETE_FONT_ROW "DELETE FROM Fonts WHERE uid = ?;"
+#define SELECT_FONT_ROWS "SELECT uid, filepath, findex, family, style, spacing, slant, " \
+"weight, width, description FROM Fonts;"
+#define SELECT_FILE_STATES "SELECT filepath, findex, mtime, size, inode FROM FileState;"
+
+#define SELECT_COVERAGE "SELECT orthography, coverage FROM Coverage " \
+"WHERE filepath = ? AND findex = ?;"
+#define SELECT_SAMPLE "SELECT sample FROM Orthography WHERE filepath = ? AND findex = ?;"
+#define SELECT_FIRST_FACE "SELECT findex FROM Coverage WHERE filepath = ? ORDER BY findex LIMIT 1;"
+
+#define SELECT_CODEPOINTS "SELECT Fonts.filepath, Fonts.findex, Fonts.family, Fonts.style, " \
+"Fonts.spacing, Fonts.slant, Fonts.weight, Fonts.width, Fonts.description, Codepoints.ranges " \
+"FROM Fonts JOIN Codepoints USING (filepath, findex);"
+/* Character searches fall back to fontconfig until every face has been scanned,
+ * faces which failed to scan are recorded with empty ranges */
+#define SELECT_CODEPOINTS_COMPLETE "SELECT (SELECT count(*) FROM Fonts) <= " \
+"(SELECT count(*) FROM Fonts JOIN Codepoints USING (filepath, findex));"
+
+#define SELECT_SEARCH_RESULTS "SELECT Fonts.filepath, Fonts.findex, Fonts.family, Fonts.style " \
+"FROM SearchIndex JOIN Fonts ON Fonts.uid = SearchIndex.rowid WHERE "
+#define SELECT_SEARCH_RESULTS_FALLBACK "SELECT Fonts.filepath, Fonts.findex, Fonts.family, " \
+"Fonts.style FROM Fonts LEFT JOIN Metadata ON Metadata.filepath = Fonts.filepath " \
+"AND Metadata.findex = Fonts.findex WHERE "
+#define SELECT_SEARCH_METADATA "SELECT filepath, findex, psname, designer, vendor FROM Metadata;"
+
+/* Columns checked by font_manager_database_search.
+ * Keep in sync with the fields matched by FontModel in the main window.
+ * Nearly every filepath shares a prefix like /usr/share/fonts, so terms such as
+ * "share" or "font" would match everything if filepath were included. */
+static const gchar *SEARCH_INDEX_COLUMNS[] = {
+    "SearchIndex.family",
+    "SearchIndex.style",
+    "SearchIndex.description",
+    "SearchIndex.psname",
+    "SearchIndex.designer",
+    "SearchIndex.vendor",
+    NULL
+};
+
+/* Restricts MATCH to the columns above */
+#define SEARCH_INDEX_COLUMN_FILTER "{family style description psname designer vendor} : "
+
+/* Used if SearchIndex is unavailable, i.e. SQLite lacks FTS5 trigram support */
+static const gchar *SEARCH_FALLBACK_COLUMNS[] = {
+    "Fonts.family",
+    "Fonts.style",
+    "Fonts.description",
+    "Metadata.psname",
+    "Metadata.designer",
+    "Metadata.vendor",
+    NULL
+};
+
+/* Version 5 had no FileState table, every face is rescanned during the next
+ * sync but existing rows remain available until then. The remaining tables
+ * are added by the migrations which follow. */
+static const gchar *MIGRATE_FROM_VERSION_5[] = {
+    CREATE_FILE_STATE_TABLE,
+    CREATE_ORTH_MATCH_INDEX,
+    NULL
+};
+
+/* Version 6 stored orthography results as JSON text in Orthography.support */
+static const gchar *MIGRATE_FROM_VERSION_6[] = {
+    CREATE_COVERAGE_TABLE,
+    "INSERT INTO Coverage (filepath, findex, orthography, coverage) "
+    "SELECT Orthography.filepath, Orthography.findex, json_each.key, "
+    "json_extract(json_each.value, '$.coverage') FROM Orthography, json_each(Orthography.support) "
+    "WHERE json_valid(Orthography.support) AND json_each.type = 'object';",
+    "ALTER TABLE Orthography DROP COLUMN support;",
+    CREATE_COVERAGE_MATCH_INDEX,
+    CREATE_COVERAGE_FACE_INDEX,
+    NULL
+};
+
+/* Version 7 had no full text search index.
+ * It's added by create_search_index() instead, if SQLite supports it. */
+static const gchar *MIGRATE_FROM_VERSION_7[] = {
+    NULL
+};
+
+/* Version 8 did not store codepoint coverage, clearing FileState forces a rescan */
+static const gchar *MIGRATE_FROM_VERSION_8[] = {
+    CREATE_CODEPOINTS_TABLE,
+    "DELETE FROM FileState;",
+    NULL
+};
+
+/* Indexes which aren't needed while syncing. When populating an empty database
+ * it's much cheaper to build these once afterwards than to update them per row. */
+static const gchar *DROP_DEFERRED_INDEXES[] = {
+    DROP_PANOSE_MATCH_INDEX,
+    DROP_ORTH_MATCH_INDEX,
+    DROP_COVERAGE_MATCH_INDEX,
+    DROP_COVERAGE_FACE_INDEX,
+    NULL
+};
+
+/* Triggers are only created once SearchIndex exists */
+static const gchar *CREATE_SEARCH_INDEX_STEPS[] = {
+    CREATE_SEARCH_INDEX,
+    POPULATE_SEARCH_INDEX,
+    CREATE_SEARCH_INSERT_TRIGGER,
+    CREATE_SEARCH_DELETE_TRIGGER,
+    CREATE_SEARCH_METADATA_TRIGGER,
+    NULL
+};
+
+/* Left behind if creating SearchIndex failed, every insert into Fonts fails with these */
+static const gchar *DROP_SEARCH_TRIGGERS[] = {
+    DROP_SEARCH_INSERT_TRIGGER,
+    DROP_SEARCH_DELETE_TRIGGER,
+    DROP_SEARCH_METADATA_TRIGGER,
+    NULL
+};
+
+static const gchar *CREATE_DEFERRED_INDEXES[] = {
+    CREATE_PANOSE_MATCH_INDEX,
+    CREATE_ORTH_MATCH_INDEX,
+    CREATE_COVERAGE_MATCH_INDEX,
+    CREATE_COVERAGE_FACE_INDEX,
+    NULL
+};
+
+/* Tables holding rows which describe a face listed in the Fonts table */
+static const gchar *FACE_DATA_TABLES[] = {
+    "Metadata",
+    "Panose",
+    "Orthography",
+    "Coverage",
+    "Codepoints",
+    "FileState",
+    NULL
+};
+
+#define DELETE_ORPHANED_ROWS "DELETE FROM %s WHERE rowid IN (SELECT rowid FROM %s AS t " \
+"WHERE NOT EXISTS (SELECT 1 FROM Fonts WHERE Fonts.filepath = t.filepath " \
+"AND Fonts.findex = t.findex) LIMIT %i);"
+
+/* Orphaned rows are deleted in batches so the write lock is only held briefly */
+#define ORPHANED_ROW_BATCH_SIZE 1000
+/* Fraction of unused pages at which the database file gets compacted */
+#define FRAGMENTATION_THRESHOLD 0.2
+
+/* Rows describing a face which need to be dropped before rescanning it */
+static const gchar *DELETE_FACE_ROWS[] = {
+    "DELETE FROM Metadata WHERE filepath = ? AND findex = ?;",
+    "DELETE FROM Panose WHERE filepath = ? AND findex = ?;",
+    "DELETE FROM Orthography WHERE filepath = ? AND findex = ?;",
+    "DELETE FROM Coverage WHERE filepath = ? AND findex = ?;",
+    "DELETE FROM Codepoints WHERE filepath = ? AND findex = ?;",
+    NULL
+};
 
 #define FONT_PROPERTIES FontProperties
 #define INFO_PROPERTIES InfoProperties
 
+typedef struct _CodepointIndex CodepointIndex;
+
+static void codepoint_index_free (CodepointIndex *index);
+
 struct _FontManagerDatabase
 {
     GObject parent_instance;
 
     sqlite3 *db;
     sqlite3_stmt *stmt;
+    gboolean stmt_cached;
+    GHashTable *statements;
     gboolean in_transaction;
+    gboolean read_only;
     gchar *file;
+    guint max_workers;
+    CodepointIndex *codepoints;
 };
 
 G_DEFINE_TYPE(FontManagerDatabase, font_manager_database, G_TYPE_OBJECT)
 
+enum
+{
+    PROP_RESERVED,
+    PROP_MAX_WORKERS,
+    PROP_READ_ONLY,
+    N_PROPERTIES
+};
+
+static GParamSpec *obj_properties[N_PROPERTIES] = { NULL, };
+
 static void
 set_error (FontManagerDatabase *self, const gchar *ctx, GError **error)
 {
@@ -140,7 +385,11 @@ font_manager_database_close (FontManagerDatabase *self, GError **error)
 {
     g_return_if_fail(self != NULL);
     g_return_if_fail(error == NULL || *error == NULL);
-    sqlite3_exec(self->db, "PRAGMA optimize;", NULL, NULL, NULL);
+    g_clear_pointer(&self->codepoints, codepoint_index_free);
+    /* Cached statements have to be finalized before the connection can be closed */
+    g_clear_pointer(&self->statements, g_hash_table_destroy);
+    if (!self->read_only)
+        sqlite3_exec(self->db, "PRAGMA optimize;", NULL, NULL, NULL);
     if (self->db && (sqlite3_close(self->db) != SQLITE_OK))
         set_error(self, "sqlite3_close", error);
     self->db = NULL;
@@ -159,11 +408,104 @@ font_manager_database_dispose (GObject *gobject)
     return;
 }
 
+static void
+font_manager_database_get_property (GObject *gobject,
+                                    guint property_id,
+                                    GValue *value,
+                                    GParamSpec *pspec)
+{
+    g_return_if_fail(gobject != NULL);
+    FontManagerDatabase *self = FONT_MANAGER_DATABASE(gobject);
+    switch (property_id) {
+        case PROP_MAX_WORKERS:
+            g_value_set_uint(value, self->max_workers);
+            break;
+        case PROP_READ_ONLY:
+            g_value_set_boolean(value, self->read_only);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
+            break;
+    }
+    return;
+}
+
+static void
+font_manager_database_set_property (GObject *gobject,
+                                    guint property_id,
+                                    const GValue *value,
+                                    GParamSpec *pspec)
+{
+    g_return_if_fail(gobject != NULL);
+    FontManagerDatabase *self = FONT_MANAGER_DATABASE(gobject);
+    switch (property_id) {
+        case PROP_MAX_WORKERS:
+            self->max_workers = g_value_get_uint(value);
+            break;
+        case PROP_READ_ONLY:
+            self->read_only = g_value_get_boolean(value);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
+            break;
+    }
+    return;
+}
+
+static void
+font_manager_database_constructed (GObject *gobject)
+{
+    g_return_if_fail(gobject != NULL);
+    FontManagerDatabase *self = FONT_MANAGER_DATABASE(gobject);
+    /* Read-only connections can neither create nor upgrade the database */
+    if (!self->read_only) {
+        font_manager_database_open(self, NULL);
+        font_manager_database_initialize(self, NULL);
+    }
+    G_OBJECT_CLASS(font_manager_database_parent_class)->constructed(gobject);
+    return;
+}
+
 static void
 font_manager_database_class_init (FontManagerDatabaseClass *klass)
 {
     GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    object_class->constructed = font_manager_database_constructed;
     object_class->dispose = font_manager_database_dispose;
+    object_class->get_property = font_manager_database_get_property;
+    object_class->set_property = font_manager_database_set_property;
+
+    /**
+     * FontManagerDatabase:max-workers
+     *
+     * Maximum number of threads used to extract font metadata during
+     * #font_manager_update_database. 0 uses the number of available processors.
+     */
+    obj_properties[PROP_MAX_WORKERS] = g_param_spec_uint("max-workers",
+                                                         NULL,
+                                                         "Maximum number of worker threads",
+                                                         0, G_MAXUINT, 0,
+                                                         G_PARAM_READWRITE |
+                                                         G_PARAM_STATIC_STRINGS);
+
+    /**
+     * FontManagerDatabase:read-only
+     *
+     * Whether this connection was opened read-only.
+     *
+     * Read-only connections never take the write lock and, since the database
+     * is in WAL mode, never wait on a running #font_manager_update_database.
+     * Each query sees the last committed state of the database.
+     */
+    obj_properties[PROP_READ_ONLY] = g_param_spec_boolean("read-only",
+                                                          NULL,
+                                                          "Whether connection is read-only",
+                                                          FALSE,
+                                                          G_PARAM_READWRITE |
+                                                          G_PARAM_CONSTRUCT_ONLY |
+                                                          G_PARAM_STATIC_STRINGS);
+
+    g_object_class_install_properties(object_class, N_PROPERTIES, obj_properties);
     return;
 }
 
@@ -174,8 +516,6 @@ font_manager_database_init (FontManagerDatabase *self)
     g_autofree gchar *cache_dir = font_manager_get_package_cache_directory();
     g_autofree gchar *db_file = g_strdup_printf("%s.sqlite", PACKAGE_NAME);
     self->file = g_build_filename(cache_dir, db_file, NULL);
-    font_manager_database_open(self, NULL);
-    font_manager_database_initialize(self, NULL);
     return;
 }
 
@@ -196,8 +536,15 @@ font_manager_database_open (FontManagerDatabase *self, GError **error)
     g_return_if_fail(error == NULL || *error == NULL);
     if (self->db != NULL)
         return;
-    if (sqlite3_open(self->file, &self->db) != SQLITE_OK)
-        set_error(self, "sqlite3_open", error);
+    int flags = self->read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+    if (sqlite3_open_v2(self->file, &self->db, flags, NULL) != SQLITE_OK) {
+        set_error(self, "sqlite3_open_v2", error);
+        sqlite3_close(self->db);
+        self->db = NULL;
+        return;
+    }
+    /* Wait for competing writers rather than failing right away with SQLITE_BUSY */
+    sqlite3_busy_timeout(self->db, BUSY_TIMEOUT);
     return;
 }
 
@@ -276,11 +623,45 @@ font_manager_database_execute_query (FontManagerDatabase *self, const gchar *sql
     g_return_if_fail(error == NULL || *error == NULL);
     if (sqlite3_open_failed(self, error))
         return;
+    self->stmt_cached = FALSE;
     if (sqlite3_prepare_v2(self->db, sql, -1, &self->stmt, NULL) != SQLITE_OK)
         set_error(self, sql, error);
     return;
 }
 
+/*
+ * Same as font_manager_database_execute_query but the prepared statement is
+ * kept around and reused the next time the same query is executed.
+ * Intended for queries which are run over and over, i.e. inserts during a sync.
+ *
+ * @sql is used as the cache key and must remain valid for the lifetime of the connection.
+ * Calls to this function must be paired with a call to font_manager_database_end_query,
+ * which resets the statement instead of finalizing it.
+ */
+static void
+execute_cached_query (FontManagerDatabase *self, const gchar *sql, GError **error)
+{
+    g_return_if_fail(self != NULL);
+    g_return_if_fail(sql != NULL);
+    g_return_if_fail(error == NULL || *error == NULL);
+    if (sqlite3_open_failed(self, error))
+        return;
+    if (self->statements == NULL)
+        self->statements = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+                                                 (GDestroyNotify) sqlite3_finalize);
+    sqlite3_stmt *stmt = g_hash_table_lookup(self->statements, sql);
+    if (stmt == NULL) {
+        if (sqlite3_prepare_v3(self->db, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, NULL) != SQLITE_OK) {
+            set_error(self, sql, error);
+            return;
+        }
+        g_hash_table_insert(self->statements, (gpointer) sql, stmt);
+    }
+    self->stmt = stmt;
+    self->stmt_cached = TRUE;
+    return;
+}
+
 /**
  * font_manager_database_end_query:
  * @self:   #fontManagerDatabase
@@ -291,6 +672,12 @@ void
 font_manager_database_end_query (FontManagerDatabase *self)
 {
     g_return_if_fail(self != NULL);
+    if (self->stmt_cached && self->stmt != NULL) {
+        sqlite3_reset(self->stmt);
+        sqlite3_clear_bindings(self->stmt);
+        self->stmt = NULL;
+    }
+    self->stmt_cached = FALSE;
     g_clear_pointer(&self->stmt, sqlite3_finalize);
     return;
 }
@@ -337,6 +724,138 @@ font_manager_database_vacuum (FontManagerDatabase *self, GError **error)
     return;
 }
 
+static gint64
+get_pragma_value (FontManagerDatabase *self, const gchar *pragma)
+{
+    gint64 result = 0;
+    g_autofree gchar *sql = g_strdup_printf("PRAGMA %s;", pragma);
+    font_manager_database_execute_query(self, sql, NULL);
+    if (self->stmt != NULL && sqlite3_step_succeeded(self, SQLITE_ROW))
+        result = sqlite3_column_int64(self->stmt, 0);
+    font_manager_database_end_query(self);
+    return result;
+}
+
+static gint
+remove_orphaned_rows (FontManagerDatabase *self, GError **error)
+{
+    gint removed = 0;
+    for (gint i = 0; FACE_DATA_TABLES[i] != NULL; i++) {
+        const gchar *table = FACE_DATA_TABLES[i];
+        g_autofree gchar *sql = g_strdup_printf(DELETE_ORPHANED_ROWS, table, table, ORPHANED_ROW_BATCH_SIZE);
+        gint changes;
+        do {
+            if (sqlite3_exec(self->db, sql, NULL, NULL, NULL) != SQLITE_OK) {
+                set_error(self, "sqlite3_exec", error);
+                return removed;
+            }
+            changes = sqlite3_changes(self->db);
+            removed += changes;
+        } while (changes >= ORPHANED_ROW_BATCH_SIZE);
+    }
+    return removed;
+}
+
+/**
+ * font_manager_database_run_maintenance:
+ * @self:   #FontManagerDatabase
+ * @error: (nullable): #GError or %NULL to ignore errors
+ *
+ * Remove rows describing faces which are no longer listed in the Fonts table,
+ * i.e. files which were removed or moved, refresh the statistics used by the
+ * query planner and compact the database file once enough of it is unused.
+ *
+ * Only meaningful once the Fonts table reflects the current set of
+ * available fonts, i.e. after a complete #font_manager_update_database.
+ * This function must not be called while in a transaction.
+ *
+ * Returns: Number of bytes reclaimed
+ */
+gint64
+font_manager_database_run_maintenance (FontManagerDatabase *self, GError **error)
+{
+    g_return_val_if_fail(self != NULL, 0);
+    g_return_val_if_fail(error == NULL || *error == NULL, 0);
+    g_return_val_if_fail(!self->read_only && !self->in_transaction, 0);
+    if (sqlite3_open_failed(self, error))
+        return 0;
+    gint64 span = font_manager_profiler_begin();
+    gint64 page_size = get_pragma_value(self, "page_size");
+    gint64 initial_size = get_pragma_value(self, "page_count") * page_size;
+    gint removed = remove_orphaned_rows(self, error);
+    if (error != NULL && *error != NULL)
+        return 0;
+    /* Statistics are sampled, keeps this cheap regardless of database size */
+    if (removed > 0)
+        sqlite3_exec(self->db, "PRAGMA analysis_limit = 1000; ANALYZE;", NULL, NULL, NULL);
+    gint64 n_pages = get_pragma_value(self, "page_count");
+    gint64 n_free = get_pragma_value(self, "freelist_count");
+    if (n_pages > 0 && ((gdouble) n_free / (gdouble) n_pages) >= FRAGMENTATION_THRESHOLD) {
+        /* Databases created before auto_vacuum was enabled need one full VACUUM to switch */
+        const gchar *sql = get_pragma_value(self, "auto_vacuum") == 2 ?
+                           "PRAGMA incremental_vacuum;" :
+                           "PRAGMA auto_vacuum = INCREMENTAL; VACUUM;";
+        if (sqlite3_exec(self->db, sql, NULL, NULL, NULL) != SQLITE_OK)
+            g_warning("Database Error : Failed to compact database : %s", sqlite3_errmsg(self->db));
+    }
+    gint64 reclaimed = MAX(initial_size - get_pragma_value(self, "page_count") * page_size, 0);
+    g_debug("Database maintenance : removed %i orphaned rows, reclaimed %" G_GINT64_FORMAT " bytes",
+            removed, reclaimed);
+    font_manager_profiler_counter("Database.reclaimed", reclaimed);
+    font_manager_profiler_end(span, "Database.maintenance");
+    return reclaimed;
+}
+
+static gboolean
+migrate_database (FontManagerDatabase *self, const gchar *steps[], gint from_version)
+{
+    g_return_val_if_fail(self->db != NULL, FALSE);
+    if (sqlite3_exec(self->db, "BEGIN;", NULL, NULL, NULL) != SQLITE_OK)
+        return FALSE;
+    for (gint i = 0; steps[i] != NULL; i++) {
+        if (sqlite3_exec(self->db, steps[i], NULL, NULL, NULL) != SQLITE_OK) {
+            g_warning("Database migration from version %i failed : %s",
+                      from_version, sqlite3_errmsg(self->db));
+            sqlite3_exec(self->db, "ROLLBACK;", NULL, NULL, NULL);
+            return FALSE;
+        }
+    }
+    g_autofree gchar *sql = g_strdup_printf("PRAGMA user_version = %i", from_version + 1);
+    sqlite3_exec(self->db, sql, NULL, NULL, NULL);
+    if (sqlite3_exec(self->db, "COMMIT;", NULL, NULL, NULL) != SQLITE_OK) {
+        sqlite3_exec(self->db, "ROLLBACK;", NULL, NULL, NULL);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* SearchIndex requires FTS5 and the trigram tokenizer, available since SQLite 3.34.
+ * Without either searches fall back to scanning Fonts and Metadata. */
+static gboolean
+create_search_index (FontManagerDatabase *self)
+{
+    g_return_val_if_fail(self->db != NULL, FALSE);
+    font_manager_database_execute_query(self, SELECT_SEARCH_INDEX_EXISTS, NULL);
+    gboolean exists = self->stmt != NULL &&
+                      sqlite3_step_succeeded(self, SQLITE_ROW) &&
+                      sqlite3_column_int(self->stmt, 0) > 0;
+    font_manager_database_end_query(self);
+    if (exists)
+        return TRUE;
+    for (gint i = 0; DROP_SEARCH_TRIGGERS[i] != NULL; i++)
+        sqlite3_exec(self->db, DROP_SEARCH_TRIGGERS[i], NULL, NULL, NULL);
+    if (sqlite3_exec(self->db, "SAVEPOINT search_index;", NULL, NULL, NULL) != SQLITE_OK)
+        return FALSE;
+    for (gint i = 0; CREATE_SEARCH_INDEX_STEPS[i] != NULL; i++) {
+        if (sqlite3_exec(self->db, CREATE_SEARCH_INDEX_STEPS[i], NULL, NULL, NULL) != SQLITE_OK) {
+            g_debug("Search index unavailable : %s", sqlite3_errmsg(self->db));
+            sqlite3_exec(self->db, "ROLLBACK TO search_index; RELEASE search_index;", NULL, NULL, NULL);
+            return FALSE;
+        }
+    }
+    return sqlite3_exec(self->db, "RELEASE search_index;", NULL, NULL, NULL) == SQLITE_OK;
+}
+
 void
 cache_locale_value (GFile      *locale_file,
                     const char *current_locale)
@@ -386,9 +905,35 @@ font_manager_database_initialize (FontManagerDatabase *self,
 
     bool db_exists = font_manager_exists(self->file);
     int CURRENT_VERSION = FONT_MANAGER_CURRENT_DATABASE_VERSION;
+    int version = db_exists ? font_manager_database_get_version(self, NULL) : -1;
+
+    /* Older databases are brought up to date one version at a time */
+    static const gchar **migrations[] = {
+        MIGRATE_FROM_VERSION_5,
+        MIGRATE_FROM_VERSION_6,
+        MIGRATE_FROM_VERSION_7,
+        MIGRATE_FROM_VERSION_8
+    };
+    gint first_migration = 5;
+    gboolean migrated = FALSE;
+    G_STATIC_ASSERT(G_N_ELEMENTS(migrations) == FONT_MANAGER_CURRENT_DATABASE_VERSION - 5);
+
+    while (db_exists && version >= first_migration && version < CURRENT_VERSION) {
+        if (!migrate_database(self, migrations[version - first_migration], version))
+            break;
+        g_debug("Database migrated from version %i", version);
+        version = font_manager_database_get_version(self, NULL);
+        migrated = TRUE;
+    }
+
+    /* Reclaim the space used by whatever was dropped */
+    if (migrated)
+        sqlite3_exec(self->db, "VACUUM;", NULL, NULL, NULL);
 
-    if (db_exists && font_manager_database_get_version(self, NULL) == CURRENT_VERSION) {
+    if (db_exists && version == CURRENT_VERSION) {
         g_debug("Database version is current, skipping initialization");
+        /* Missing if migrated from version 7 or created without FTS5 support */
+        create_search_index(self);
         font_manager_database_close(self, error);
         return;
     } else if (db_exists) {
@@ -401,15 +946,24 @@ font_manager_database_initialize (FontManagerDatabase *self,
     }
     if (self->db == NULL)
         font_manager_database_open(self, NULL);
+    /* Has to be set before any tables are created */
+    sqlite3_exec(self->db, "PRAGMA auto_vacuum = INCREMENTAL;", NULL, 0, 0);
     sqlite3_exec(self->db, "PRAGMA journal_mode = WAL;", NULL, 0, 0);
     sqlite3_exec(self->db, "PRAGMA synchronous = NORMAL;", NULL, 0, 0);
     sqlite3_exec(self->db, CREATE_FONTS_TABLE, NULL, 0, 0);
     sqlite3_exec(self->db, CREATE_INFO_TABLE, NULL, 0, 0);
     sqlite3_exec(self->db, CREATE_PANOSE_TABLE, NULL, 0, 0);
     sqlite3_exec(self->db, CREATE_ORTH_TABLE, NULL, 0, 0);
+    sqlite3_exec(self->db, CREATE_COVERAGE_TABLE, NULL, 0, 0);
+    sqlite3_exec(self->db, CREATE_FILE_STATE_TABLE, NULL, 0, 0);
+    sqlite3_exec(self->db, CREATE_CODEPOINTS_TABLE, NULL, 0, 0);
     sqlite3_exec(self->db, CREATE_FONT_MATCH_INDEX, NULL, 0, 0);
     sqlite3_exec(self->db, CREATE_INFO_MATCH_INDEX, NULL, 0, 0);
     sqlite3_exec(self->db, CREATE_PANOSE_MATCH_INDEX, NULL, 0, 0);
+    sqlite3_exec(self->db, CREATE_ORTH_MATCH_INDEX, NULL, 0, 0);
+    sqlite3_exec(self->db, CREATE_COVERAGE_MATCH_INDEX, NULL, 0, 0);
+    sqlite3_exec(self->db, CREATE_COVERAGE_FACE_INDEX, NULL, 0, 0);
+    create_search_index(self);
     g_autofree gchar *sql = g_strdup_printf("PRAGMA user_version = %i", CURRENT_VERSION);
     sqlite3_exec(self->db, sql, NULL, 0, 0);
     return;
@@ -468,6 +1022,451 @@ font_manager_database_get_object (FontManagerDatabase *self, const gchar *sql, G
     return obj;
 }
 
+/**
+ * font_manager_database_get_orthography:
+ * @self: #FontManagerDatabase
+ * @filepath: Full path to font file
+ * @index: Face index or -1 to use the first face found for @filepath
+ * @error: #GError or %NULL to ignore errors
+ *
+ * The returned object has the same structure as the object returned by
+ * #font_manager_get_orthography_results(), except that the members do not
+ * contain a filter. #font_manager_orthography_get_filter() will rebuild it
+ * as needed.
+ *
+ * Returns: (transfer full) (nullable):
+ * #JsonObject containing orthography results for the requested face,
+ * %NULL if there were no results or there was an error.
+ */
+JsonObject *
+font_manager_database_get_orthography (FontManagerDatabase *self,
+                                       const gchar *filepath,
+                                       gint index,
+                                       GError **error)
+{
+    g_return_val_if_fail(FONT_MANAGER_IS_DATABASE(self), NULL);
+    g_return_val_if_fail(filepath != NULL, NULL);
+    g_return_val_if_fail((error == NULL || *error == NULL), NULL);
+
+    if (index < 0) {
+        font_manager_database_execute_query(self, SELECT_FIRST_FACE, error);
+        g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+        g_assert(sqlite3_bind_text(self->stmt, 1, filepath, -1, SQLITE_STATIC) == SQLITE_OK);
+        if (sqlite3_step_succeeded(self, SQLITE_ROW))
+            index = sqlite3_column_int(self->stmt, 0);
+        font_manager_database_end_query(self);
+        if (index < 0)
+            return NULL;
+    }
+
+    JsonObject *result = json_object_new();
+    font_manager_database_execute_query(self, SELECT_COVERAGE, error);
+    if (error != NULL && *error != NULL) {
+        json_object_unref(result);
+        return NULL;
+    }
+    g_assert(sqlite3_bind_text(self->stmt, 1, filepath, -1, SQLITE_STATIC) == SQLITE_OK);
+    g_assert(sqlite3_bind_int(self->stmt, 2, index) == SQLITE_OK);
+    while (sqlite3_step_succeeded(self, SQLITE_ROW)) {
+        const gchar *name = (const gchar *) sqlite3_column_text(self->stmt, 0);
+        gdouble coverage = sqlite3_column_double(self->stmt, 1);
+        JsonObject *entry = name ? font_manager_get_orthography_entry(name, coverage) : NULL;
+        if (entry)
+            json_object_set_object_member(result, name, entry);
+    }
+    font_manager_database_end_query(self);
+
+    if (json_object_get_size(result) < 1) {
+        json_object_unref(result);
+        return NULL;
+    }
+
+    font_manager_database_execute_query(self, SELECT_SAMPLE, error);
+    if (error != NULL && *error != NULL) {
+        json_object_unref(result);
+        return NULL;
+    }
+    g_assert(sqlite3_bind_text(self->stmt, 1, filepath, -1, SQLITE_STATIC) == SQLITE_OK);
+    g_assert(sqlite3_bind_int(self->stmt, 2, index) == SQLITE_OK);
+    const gchar *sample = NULL;
+    if (sqlite3_step_succeeded(self, SQLITE_ROW))
+        sample = (const gchar *) sqlite3_column_text(self->stmt, 0);
+    json_object_set_string_member(result, "sample", sample);
+    font_manager_database_end_query(self);
+    return result;
+}
+
+static gchar *
+escape_like_pattern (const gchar *term)
+{
+    GString *pattern = g_string_new("%");
+    for (const gchar *c = term; *c; c++) {
+        if (*c == '%' || *c == '_' || *c == '\\')
+            g_string_append_c(pattern, '\\');
+        g_string_append_c(pattern, *c);
+    }
+    g_string_append_c(pattern, '%');
+    return g_string_free(pattern, FALSE);
+}
+
+/* Fills sql and params, returns FALSE if there is nothing to search for */
+static gboolean
+build_search_query (GString *sql, GPtrArray *params, gchar **terms, gboolean use_index)
+{
+    const gchar **columns = use_index ? SEARCH_INDEX_COLUMNS : SEARCH_FALLBACK_COLUMNS;
+    g_autoptr(GString) match = g_string_new(NULL);
+    gint n_clauses = 0;
+    g_string_append(sql, use_index ? SELECT_SEARCH_RESULTS : SELECT_SEARCH_RESULTS_FALLBACK);
+    for (gint i = 0; terms[i] != NULL; i++) {
+        if (terms[i][0] == '\0')
+            continue;
+        /* Trigram queries require at least three characters */
+        if (use_index && g_utf8_strlen(terms[i], -1) >= 3) {
+            g_autofree gchar *quoted = font_manager_str_replace(terms[i], "\"", "\"\"");
+            g_string_append_printf(match, "%s%s\"%s\"", match->len > 0 ? " AND " : "",
+                                   SEARCH_INDEX_COLUMN_FILTER, quoted);
+            continue;
+        }
+        g_string_append_printf(sql, "%s(", n_clauses > 0 ? " AND " : "");
+        for (gint j = 0; columns[j] != NULL; j++) {
+            g_string_append_printf(sql, "%s%s LIKE ? ESCAPE '\\'", j > 0 ? " OR " : "", columns[j]);
+            g_ptr_array_add(params, escape_like_pattern(terms[i]));
+        }
+        g_string_append(sql, ")");
+        n_clauses++;
+    }
+    if (match->len > 0) {
+        g_string_append_printf(sql, "%sSearchIndex MATCH ?", n_clauses > 0 ? " AND " : "");
+        g_ptr_array_add(params, g_strdup(match->str));
+        n_clauses++;
+    }
+    g_string_append(sql, use_index ? " ORDER BY Fonts.weight;" : " GROUP BY Fonts.uid ORDER BY Fonts.weight;");
+    return n_clauses > 0;
+}
+
+/**
+ * font_manager_database_search:
+ * @self:           #FontManagerDatabase
+ * @search_term:    whitespace separated list of terms to search for
+ * @error: (nullable): #GError or %NULL to ignore errors
+ *
+ * Every term must be found within the family, style, description, PostScript name,
+ * designer or vendor of a face for it to be considered a match.
+ * Matching is case-insensitive and terms may appear anywhere within a field.
+ *
+ * Returns: (transfer full) (nullable): #JsonArray containing an object with
+ * the filepath, findex, family and style of each matching face, ordered by weight
+ * or %NULL if there was nothing to search for or an error occurred.
+ */
+JsonArray *
+font_manager_database_search (FontManagerDatabase *self,
+                              const gchar *search_term,
+                              GError **error)
+{
+    g_return_val_if_fail(FONT_MANAGER_IS_DATABASE(self), NULL);
+    g_return_val_if_fail(search_term != NULL, NULL);
+    g_return_val_if_fail((error == NULL || *error == NULL), NULL);
+
+    g_auto(GStrv) terms = g_strsplit_set(search_term, " \t\n", -1);
+    g_autoptr(GString) sql = g_string_new(NULL);
+    g_autoptr(GPtrArray) params = g_ptr_array_new_with_free_func(g_free);
+    if (!build_search_query(sql, params, terms, TRUE))
+        return NULL;
+
+    GError *query_error = NULL;
+    font_manager_database_execute_query(self, sql->str, &query_error);
+    if (query_error != NULL) {
+        g_debug("Search index unavailable : %s", query_error->message);
+        g_clear_error(&query_error);
+        g_string_truncate(sql, 0);
+        g_ptr_array_set_size(params, 0);
+        build_search_query(sql, params, terms, FALSE);
+        font_manager_database_execute_query(self, sql->str, error);
+        if (error != NULL && *error != NULL)
+            return NULL;
+    }
+
+    for (guint i = 0; i < params->len; i++) {
+        const gchar *param = g_ptr_array_index(params, i);
+        g_assert(sqlite3_bind_text(self->stmt, i + 1, param, -1, SQLITE_STATIC) == SQLITE_OK);
+    }
+
+    JsonArray *result = json_array_new();
+    while (sqlite3_step_succeeded(self, SQLITE_ROW)) {
+        JsonObject *face = json_object_new();
+        json_object_set_string_member(face, "filepath", (const gchar *) sqlite3_column_text(self->stmt, 0));
+        json_object_set_int_member(face, "findex", sqlite3_column_int(self->stmt, 1));
+        json_object_set_string_member(face, "family", (const gchar *) sqlite3_column_text(self->stmt, 2));
+        json_object_set_string_member(face, "style", (const gchar *) sqlite3_column_text(self->stmt, 3));
+        json_array_add_object_element(result, face);
+    }
+    font_manager_database_end_query(self);
+    return result;
+}
+
+/**
+ * font_manager_database_get_search_metadata:
+ * @self:   #FontManagerDatabase
+ * @error: (nullable): #GError or %NULL to ignore errors
+ *
+ * Used to search the same fields as #font_manager_database_search
+ * without going through the database for every face checked.
+ *
+ * Returns: (transfer full) (nullable): #JsonObject mapping "filepath:findex"
+ * to the PostScript name, designer and vendor of each face, separated by
+ * newlines, or %NULL on error.
+ */
+JsonObject *
+font_manager_database_get_search_metadata (FontManagerDatabase *self, GError **error)
+{
+    g_return_val_if_fail(FONT_MANAGER_IS_DATABASE(self), NULL);
+    g_return_val_if_fail((error == NULL || *error == NULL), NULL);
+    font_manager_database_execute_query(self, SELECT_SEARCH_METADATA, error);
+    if (error != NULL && *error != NULL)
+        return NULL;
+    JsonObject *result = json_object_new();
+    g_autoptr(GString) fields = g_string_new(NULL);
+    while (sqlite3_step_succeeded(self, SQLITE_ROW)) {
+        const gchar *filepath = (const gchar *) sqlite3_column_text(self->stmt, 0);
+        if (filepath == NULL)
+            continue;
+        g_string_truncate(fields, 0);
+        for (gint i = 2; i <= 4; i++) {
+            const gchar *field = (const gchar *) sqlite3_column_text(self->stmt, i);
+            if (field == NULL)
+                continue;
+            if (fields->len > 0)
+                g_string_append_c(fields, '\n');
+            g_string_append(fields, field);
+        }
+        g_autofree gchar *key = g_strdup_printf("%s:%i", filepath, sqlite3_column_int(self->stmt, 1));
+        json_object_set_string_member(result, key, fields->str);
+    }
+    font_manager_database_end_query(self);
+    return result;
+}
+
+/* In-memory index of the codepoints supported by each face, used to answer
+ * character searches without going through fontconfig. Faces are grouped by
+ * the 256 codepoint blocks they cover so that only likely candidates need to
+ * be checked against their actual ranges. */
+
+#define CODEPOINT_BLOCK(c) ((c) >> 8)
+
+typedef struct
+{
+    JsonObject *font;
+    guint32 *ranges;
+    guint n_ranges;
+}
+FaceCodepoints;
+
+struct _CodepointIndex
+{
+    GArray *faces;
+    GHashTable *blocks;
+    gint64 data_version;
+    gint total_changes;
+};
+
+static void
+face_codepoints_clear (FaceCodepoints *face)
+{
+    g_clear_pointer(&face->font, json_object_unref);
+    g_clear_pointer(&face->ranges, g_free);
+    return;
+}
+
+static void
+codepoint_index_free (CodepointIndex *index)
+{
+    g_array_unref(index->faces);
+    g_hash_table_destroy(index->blocks);
+    g_free(index);
+    return;
+}
+
+static gint64
+get_data_version (FontManagerDatabase *self)
+{
+    gint64 version = -1;
+    sqlite3_stmt *stmt = NULL;
+    if (sqlite3_prepare_v2(self->db, "PRAGMA data_version;", -1, &stmt, NULL) == SQLITE_OK
+        && sqlite3_step(stmt) == SQLITE_ROW)
+        version = sqlite3_column_int64(stmt, 0);
+    sqlite3_finalize(stmt);
+    return version;
+}
+
+/* data_version catches changes made through other connections, total_changes our own */
+static gboolean
+codepoint_index_is_current (FontManagerDatabase *self)
+{
+    return self->codepoints != NULL
+        && self->codepoints->total_changes == sqlite3_total_changes(self->db)
+        && self->codepoints->data_version == get_data_version(self);
+}
+
+static void
+codepoint_index_add_face (CodepointIndex *index, FaceCodepoints *face)
+{
+    guint id = index->faces->len;
+    g_array_append_val(index->faces, *face);
+    for (guint i = 0; i < face->n_ranges; i++) {
+        guint32 first = CODEPOINT_BLOCK(face->ranges[i * 2]);
+        guint32 last = CODEPOINT_BLOCK(face->ranges[i * 2 + 1]);
+        for (guint32 block = first; block <= last; block++) {
+            GArray *ids = g_hash_table_lookup(index->blocks, GUINT_TO_POINTER(block));
+            if (ids == NULL) {
+                ids = g_array_new(FALSE, FALSE, sizeof(guint));
+                g_hash_table_insert(index->blocks, GUINT_TO_POINTER(block), ids);
+            } else if (g_array_index(ids, guint, ids->len - 1) == id) {
+                continue;
+            }
+            g_array_append_val(ids, id);
+        }
+    }
+    return;
+}
+
+/* Returns NULL without setting error if coverage is missing for some faces */
+static CodepointIndex *
+codepoint_index_new (FontManagerDatabase *self, GError **error)
+{
+    font_manager_database_execute_query(self, SELECT_CODEPOINTS_COMPLETE, error);
+    if (error != NULL && *error != NULL)
+        return NULL;
+    gboolean complete = sqlite3_step_succeeded(self, SQLITE_ROW) && sqlite3_column_int(self->stmt, 0);
+    font_manager_database_end_query(self);
+    if (!complete)
+        return NULL;
+
+    font_manager_database_execute_query(self, SELECT_CODEPOINTS, error);
+    if (error != NULL && *error != NULL)
+        return NULL;
+    CodepointIndex *index = g_new0(CodepointIndex, 1);
+    index->faces = g_array_new(FALSE, FALSE, sizeof(FaceCodepoints));
+    g_array_set_clear_func(index->faces, (GDestroyNotify) face_codepoints_clear);
+    index->blocks = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+                                          NULL, (GDestroyNotify) g_array_unref);
+    while (sqlite3_step_succeeded(self, SQLITE_ROW)) {
+        FaceCodepoints face = { NULL, NULL, 0 };
+        const void *blob = sqlite3_column_blob(self->stmt, 9);
+        gsize size = (gsize) sqlite3_column_bytes(self->stmt, 9);
+        face.n_ranges = size / (2 * sizeof(guint32));
+        face.ranges = g_new(guint32, face.n_ranges * 2);
+        if (face.n_ranges > 0)
+            memcpy(face.ranges, blob, face.n_ranges * 2 * sizeof(guint32));
+        for (guint i = 0; i < face.n_ranges * 2; i++)
+            face.ranges[i] = GUINT32_FROM_LE(face.ranges[i]);
+        face.font = json_object_new();
+        json_object_set_string_member(face.font, "filepath", (const gchar *) sqlite3_column_text(self->stmt, 0));
+        json_object_set_int_member(face.font, "findex", sqlite3_column_int(self->stmt, 1));
+        json_object_set_string_member(face.font, "family", (const gchar *) sqlite3_column_text(self->stmt, 2));
+        json_object_set_string_member(face.font, "style", (const gchar *) sqlite3_column_text(self->stmt, 3));
+        json_object_set_int_member(face.font, "spacing", sqlite3_column_int(self->stmt, 4));
+        json_object_set_int_member(face.font, "slant", sqlite3_column_int(self->stmt, 5));
+        json_object_set_int_member(face.font, "weight", sqlite3_column_int(self->stmt, 6));
+        json_object_set_int_member(face.font, "width", sqlite3_column_int(self->stmt, 7));
+        json_object_set_string_member(face.font, "description", (const gchar *) sqlite3_column_text(self->stmt, 8));
+        json_object_set_boolean_member(face.font, "active", TRUE);
+        /* Shared with every result this face appears in */
+        json_object_seal(face.font);
+        codepoint_index_add_face(index, &face);
+    }
+    font_manager_database_end_query(self);
+    index->data_version = get_data_version(self);
+    index->total_changes = sqlite3_total_changes(self->db);
+    return index;
+}
+
+static gboolean
+face_has_codepoint (const FaceCodepoints *face, gunichar wc)
+{
+    guint low = 0, high = face->n_ranges;
+    while (low < high) {
+        guint mid = low + (high - low) / 2;
+        if (wc < face->ranges[mid * 2])
+            high = mid;
+        else if (wc > face->ranges[mid * 2 + 1])
+            low = mid + 1;
+        else
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/**
+ * font_manager_database_get_available_fonts_for_chars:
+ * @self:   #FontManagerDatabase
+ * @chars:  string of characters to search for
+ * @error: (nullable): #GError or %NULL to ignore errors
+ *
+ * Same as #font_manager_get_available_fonts_for_chars but answered from
+ * the codepoint coverage stored in the database. Falls back to querying
+ * fontconfig until coverage is available for every font in the database.
+ *
+ * Returns: (transfer full) (nullable): A newly created #JsonObject which should be
+ * freed using #json_object_unref() when no longer needed or %NULL on error.
+ */
+JsonObject *
+font_manager_database_get_available_fonts_for_chars (FontManagerDatabase *self,
+                                                     const gchar *chars,
+                                                     GError **error)
+{
+    g_return_val_if_fail(FONT_MANAGER_IS_DATABASE(self), NULL);
+    g_return_val_if_fail(chars != NULL, NULL);
+    g_return_val_if_fail((error == NULL || *error == NULL), NULL);
+
+    if (sqlite3_open_failed(self, error))
+        return NULL;
+
+    if (!codepoint_index_is_current(self)) {
+        g_clear_pointer(&self->codepoints, codepoint_index_free);
+        self->codepoints = codepoint_index_new(self, error);
+        if (error != NULL && *error != NULL)
+            return NULL;
+    }
+
+    if (self->codepoints == NULL)
+        return font_manager_get_available_fonts_for_chars(chars);
+
+    CodepointIndex *index = self->codepoints;
+    JsonObject *result = json_object_new();
+    g_autoptr(GArray) needles = g_array_new(FALSE, FALSE, sizeof(gunichar));
+    GArray *candidates = NULL;
+
+    for (const gchar *p = chars; *p; p = g_utf8_next_char(p)) {
+        gunichar wc = g_utf8_get_char(p);
+        GArray *ids = g_hash_table_lookup(index->blocks, GUINT_TO_POINTER(CODEPOINT_BLOCK(wc)));
+        /* Nothing covers this character */
+        if (ids == NULL)
+            return result;
+        if (candidates == NULL || ids->len < candidates->len)
+            candidates = ids;
+        g_array_append_val(needles, wc);
+    }
+
+    guint n_candidates = candidates ? candidates->len : index->faces->len;
+    for (guint i = 0; i < n_candidates; i++) {
+        guint id = candidates ? g_array_index(candidates, guint, i) : i;
+        FaceCodepoints *face = &g_array_index(index->faces, FaceCodepoints, id);
+        gboolean match = TRUE;
+        for (guint n = 0; match && n < needles->len; n++)
+            match = face_has_codepoint(face, g_array_index(needles, gunichar, n));
+        if (!match)
+            continue;
+        const gchar *family = json_object_get_string_member(face->font, "family");
+        const gchar *style = json_object_get_string_member(face->font, "style");
+        if (!json_object_has_member(result, family))
+            json_object_set_object_member(result, family, json_object_new());
+        JsonObject *family_obj = json_object_get_object_member(result, family);
+        json_object_set_object_member(family_obj, style, json_object_ref(face->font));
+    }
+
+    return result;
+}
+
 /**
  * font_manager_database_new:
  *
@@ -479,24 +1478,53 @@ font_manager_database_new (void)
     return g_object_new(FONT_MANAGER_TYPE_DATABASE, NULL);
 }
 
+static GPrivate readers = G_PRIVATE_INIT(g_object_unref);
+
+/**
+ * font_manager_database_get_reader:
+ *
+ * Each thread gets its own read-only connection, along with its own
+ * statement cache, which lives as long as the thread does.
+ * Queries run through it see the last committed state of the database
+ * and never wait on a sync in progress.
+ *
+ * Returns: (transfer full): Read-only #FontManagerDatabase for the calling thread
+ */
+FontManagerDatabase *
+font_manager_database_get_reader (void)
+{
+    static gsize initialized = 0;
+    if (g_once_init_enter(&initialized)) {
+        /* Make sure the database exists and is current before opening it read-only */
+        g_object_unref(font_manager_database_new());
+        g_once_init_leave(&initialized, 1);
+    }
+    FontManagerDatabase *reader = g_private_get(&readers);
+    if (reader == NULL) {
+        reader = g_object_new(FONT_MANAGER_TYPE_DATABASE, "read-only", TRUE, NULL);
+        g_private_set(&readers, reader);
+    }
+    return g_object_ref(reader);
+}
+
 /* Related functions */
 
 typedef struct
 {
     FontManagerDatabase *db;
-    JsonArray *available_fonts;
+    FontManagerFontTable *available_fonts;
     FontManagerProgressCallback progress;
 }
 DatabaseSyncData;
 
 static DatabaseSyncData *
 sync_data_new (FontManagerDatabase *db,
-               JsonArray *available_fonts,
+               FontManagerFontTable *available_fonts,
                FontManagerProgressCallback progress)
 {
     DatabaseSyncData *sync_data = g_new0(DatabaseSyncData, 1);
     sync_data->db = g_object_ref(db);
-    sync_data->available_fonts = json_array_ref(available_fonts);
+    sync_data->available_fonts = g_object_ref(available_fonts);
     sync_data->progress = progress;
     return sync_data;
 }
@@ -505,11 +1533,210 @@ static void
 sync_data_free (DatabaseSyncData *data)
 {
     g_clear_object(&data->db);
-    g_clear_pointer(&data->available_fonts, json_array_unref);
+    g_clear_object(&data->available_fonts);
     g_clear_pointer(&data, g_free);
     return;
 }
 
+/*
+ * Metadata extraction is handed off to a pool of worker threads.
+ *
+ * The thread running the sync acts as the only writer. It queues a FaceScan
+ * for every new or modified file, workers fill in the results and push them
+ * onto the results queue, which the writer drains between families.
+ */
+
+typedef struct
+{
+    gint64 mtime;
+    gint64 size;
+    guint64 inode;
+}
+FileState;
+
+typedef struct
+{
+    gint64 uid;
+    gchar *signature;
+    gboolean seen;
+}
+FontRow;
+
+typedef struct
+{
+    /* Owned by available_fonts, which outlives the pipeline */
+    const gchar *filepath;
+    gint index;
+    guint family;
+    FileState state;
+    /* Whether rows left over from a previous scan might exist */
+    gboolean known;
+    /* Shared between every queued face stored in the same file */
+    FontManagerFontFile *file;
+    /* Filled in by worker */
+    JsonObject *metadata;
+    JsonObject *orthography;
+    GBytes *codepoints;
+    GError *error;
+}
+FaceScan;
+
+typedef struct
+{
+    GAsyncQueue *results;
+    GCancellable *cancellable;
+}
+ScanPipeline;
+
+static void
+font_row_free (FontRow *row)
+{
+    g_free(row->signature);
+    g_free(row);
+    return;
+}
+
+static void
+face_scan_free (FaceScan *scan)
+{
+    g_clear_pointer(&scan->metadata, json_object_unref);
+    g_clear_pointer(&scan->orthography, json_object_unref);
+    g_clear_pointer(&scan->codepoints, g_bytes_unref);
+    g_clear_pointer(&scan->file, font_manager_font_file_unref);
+    g_clear_error(&scan->error);
+    g_free(scan);
+    return;
+}
+
+static GBytes *
+encode_codepoint_ranges (const hb_set_t *charset)
+{
+    GArray *ranges = g_array_new(FALSE, FALSE, sizeof(guint32));
+    hb_codepoint_t first = HB_SET_VALUE_INVALID, last = HB_SET_VALUE_INVALID;
+    while (hb_set_next_range(charset, &first, &last)) {
+        guint32 range[2] = { GUINT32_TO_LE(first), GUINT32_TO_LE(last) };
+        g_array_append_vals(ranges, range, 2);
+    }
+    gsize size = ranges->len * sizeof(guint32);
+    return g_bytes_new_take(g_array_free(ranges, FALSE), size);
+}
+
+static void
+scan_face_thread (FaceScan *scan, ScanPipeline *pipeline)
+{
+    if (!g_cancellable_is_cancelled(pipeline->cancellable)) {
+        scan->metadata = font_manager_font_file_get_metadata(scan->file, scan->index, &scan->error);
+        if (scan->error == NULL) {
+            hb_set_t *charset = font_manager_get_charset_from_font_file(scan->file, scan->index);
+            scan->orthography = font_manager_get_orthography_results_for_charset(charset);
+            scan->codepoints = encode_codepoint_ranges(charset);
+            hb_set_destroy(charset);
+        }
+    }
+    /* Always report back, the writer counts results to know when it's done */
+    g_async_queue_push(pipeline->results, scan);
+    return;
+}
+
+/* Files with scans in flight, keyed by filepath */
+typedef struct
+{
+    FontManagerFontFile *file;
+    guint pending;
+}
+OpenFontFile;
+
+static void
+open_font_file_free (OpenFontFile *open_file)
+{
+    font_manager_font_file_unref(open_file->file);
+    g_free(open_file);
+    return;
+}
+
+static FontManagerFontFile *
+acquire_font_file (GHashTable *open_files, const gchar *filepath)
+{
+    OpenFontFile *open_file = g_hash_table_lookup(open_files, filepath);
+    if (open_file == NULL) {
+        open_file = g_new0(OpenFontFile, 1);
+        open_file->file = font_manager_font_file_new(filepath);
+        g_hash_table_insert(open_files, (gpointer) filepath, open_file);
+    }
+    open_file->pending++;
+    return font_manager_font_file_ref(open_file->file);
+}
+
+/* Drops the mapping once no more scans for this file are in flight */
+static void
+release_font_file (GHashTable *open_files, const gchar *filepath)
+{
+    OpenFontFile *open_file = g_hash_table_lookup(open_files, filepath);
+    g_return_if_fail(open_file != NULL);
+    if (--open_file->pending == 0)
+        g_hash_table_remove(open_files, filepath);
+    return;
+}
+
+static guint
+get_worker_count (FontManagerDatabase *db)
+{
+    guint n_workers = db->max_workers;
+    if (n_workers == 0)
+        n_workers = g_get_num_processors();
+    return CLAMP(n_workers, 1, 64);
+}
+
+static gchar *
+get_face_key (const gchar *filepath, gint index)
+{
+    return g_strdup_printf("%i:%s", index, filepath);
+}
+
+static gboolean
+get_file_state (const gchar *filepath, FileState *state)
+{
+    GStatBuf st;
+    if (g_stat(filepath, &st) != 0)
+        return FALSE;
+    state->mtime = (gint64) st.st_mtime;
+    state->size = (gint64) st.st_size;
+    state->inode = (guint64) st.st_ino;
+    return TRUE;
+}
+
+static gboolean
+file_state_equal (const FileState *a, const FileState *b)
+{
+    return a->mtime == b->mtime && a->size == b->size && a->inode == b->inode;
+}
+
+static gchar *
+get_font_row_signature (const gchar *family,
+                        const gchar *style,
+                        gint spacing,
+                        gint slant,
+                        gint weight,
+                        gint width,
+                        const gchar *description)
+{
+    return g_strdup_printf("%s\x1f%s\x1f%i\x1f%i\x1f%i\x1f%i\x1f%s",
+                           family, style, spacing, slant, weight, width, description);
+}
+
+static gchar *
+get_face_signature (FontManagerFontTable *table, guint face)
+{
+    guint family = font_manager_font_table_get_family(table, face);
+    return get_font_row_signature(font_manager_font_table_get_family_name(table, family),
+                                  font_manager_font_table_get_style(table, face),
+                                  font_manager_font_table_get_spacing(table, face),
+                                  font_manager_font_table_get_slant(table, face),
+                                  font_manager_font_table_get_weight(table, face),
+                                  font_manager_font_table_get_width(table, face),
+                                  font_manager_font_table_get_description(table, face));
+}
+
 static void
 bind_from_properties (sqlite3_stmt *stmt,
                       JsonObject *json,
@@ -538,14 +1765,14 @@ bind_from_properties (sqlite3_stmt *stmt,
     return;
 }
 
-static FontManagerStringSet *
+/* Returns a hash table mapping face keys to the FileState stored when last scanned */
+static GHashTable *
 get_known_files (FontManagerDatabase *db)
 {
-    FontManagerStringSet *result = font_manager_string_set_new();
+    GHashTable *result = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
     g_return_val_if_fail(FONT_MANAGER_IS_DATABASE(db), result);
-    const gchar *sql = "SELECT DISTINCT filepath FROM Metadata";
     g_autoptr(GError) error = NULL;
-    font_manager_database_execute_query(db, sql, &error);
+    font_manager_database_execute_query(db, SELECT_FILE_STATES, &error);
     if (error != NULL) {
         g_critical("%s", error->message);
         return result;
@@ -553,20 +1780,212 @@ get_known_files (FontManagerDatabase *db)
     g_autoptr(FontManagerDatabaseIterator) iter = font_manager_database_iterator(db);
     while (font_manager_database_iterator_next(iter)) {
         sqlite3_stmt *stmt = font_manager_database_iterator_get(iter);
-        const gchar *val = (const gchar *) sqlite3_column_text(stmt, 0);
-        if (val)
-            font_manager_string_set_add(result, val);
+        const gchar *filepath = (const gchar *) sqlite3_column_text(stmt, 0);
+        if (!filepath)
+            continue;
+        FileState *state = g_new0(FileState, 1);
+        state->mtime = sqlite3_column_int64(stmt, 2);
+        state->size = sqlite3_column_int64(stmt, 3);
+        state->inode = (guint64) sqlite3_column_int64(stmt, 4);
+        g_hash_table_replace(result, get_face_key(filepath, sqlite3_column_int(stmt, 1)), state);
     }
     font_manager_database_end_query(db);
     return result;
 }
 
-static const gchar *FONT_MANAGER_SKIP_ORTH_SCAN[] = {
-     /* Adobe Blank can take several minutes to process due to number of codepoints. */
-    "Adobe Blank",
-    NULL
-};
+/* Returns a hash table mapping face keys to the current contents of the Fonts table */
+static GHashTable *
+get_known_fonts (FontManagerDatabase *db)
+{
+    GHashTable *result = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                               (GDestroyNotify) font_row_free);
+    g_return_val_if_fail(FONT_MANAGER_IS_DATABASE(db), result);
+    g_autoptr(GError) error = NULL;
+    font_manager_database_execute_query(db, SELECT_FONT_ROWS, &error);
+    if (error != NULL) {
+        g_critical("%s", error->message);
+        return result;
+    }
+    g_autoptr(FontManagerDatabaseIterator) iter = font_manager_database_iterator(db);
+    while (font_manager_database_iterator_next(iter)) {
+        sqlite3_stmt *stmt = font_manager_database_iterator_get(iter);
+        const gchar *filepath = (const gchar *) sqlite3_column_text(stmt, 1);
+        if (!filepath)
+            continue;
+        FontRow *row = g_new0(FontRow, 1);
+        row->uid = sqlite3_column_int64(stmt, 0);
+        row->signature = get_font_row_signature((const gchar *) sqlite3_column_text(stmt, 3),
+                                                (const gchar *) sqlite3_column_text(stmt, 4),
+                                                sqlite3_column_int(stmt, 5),
+                                                sqlite3_column_int(stmt, 6),
+                                                sqlite3_column_int(stmt, 7),
+                                                sqlite3_column_int(stmt, 8),
+                                                (const gchar *) sqlite3_column_text(stmt, 9));
+        g_hash_table_replace(result, get_face_key(filepath, sqlite3_column_int(stmt, 2)), row);
+    }
+    font_manager_database_end_query(db);
+    return result;
+}
+
+static void
+insert_font_row (FontManagerDatabase *db, JsonObject *face, FontRow *existing, GError **error)
+{
+    g_return_if_fail(error == NULL || *error == NULL);
+    execute_cached_query(db, existing ? REPLACE_FONT_ROW : INSERT_FONT_ROW, error);
+    g_return_if_fail(error == NULL || *error == NULL);
+    bind_from_properties(db->stmt, face, FONT_PROPERTIES, G_N_ELEMENTS(FONT_PROPERTIES));
+    if (existing)
+        g_assert(sqlite3_bind_int64(db->stmt, 10, existing->uid) == SQLITE_OK);
+    g_assert(sqlite3_step_succeeded(db, SQLITE_DONE));
+    font_manager_database_end_query(db);
+    return;
+}
+
+static void
+remove_stale_font_rows (FontManagerDatabase *db, GHashTable *known_fonts, GError **error)
+{
+    g_return_if_fail(error == NULL || *error == NULL);
+    GHashTableIter iter;
+    gpointer row;
+    g_hash_table_iter_init(&iter, known_fonts);
+    while (g_hash_table_iter_next(&iter, NULL, &row)) {
+        if (((FontRow *) row)->seen)
+            continue;
+        execute_cached_query(db, DELETE_FONT_ROW, error);
+        g_return_if_fail(error == NULL || *error == NULL);
+        g_assert(sqlite3_bind_int64(db->stmt, 1, ((FontRow *) row)->uid) == SQLITE_OK);
+        g_assert(sqlite3_step_succeeded(db, SQLITE_DONE));
+        font_manager_database_end_query(db);
+    }
+    return;
+}
+
+/*
+ * A face without @codepoints is stored with empty ranges. It never matches a
+ * character search but still counts as scanned, so a single font which can't
+ * be read doesn't keep the codepoint index from being used for every other one.
+ */
+static void
+insert_codepoints_row (FontManagerDatabase *db,
+                       const gchar *filepath,
+                       gint index,
+                       GBytes *codepoints,
+                       GError **error)
+{
+    g_return_if_fail(error == NULL || *error == NULL);
+    gsize size = 0;
+    gconstpointer ranges = codepoints != NULL ? g_bytes_get_data(codepoints, &size) : NULL;
+    execute_cached_query(db, INSERT_CODEPOINTS_ROW, error);
+    g_return_if_fail(error == NULL || *error == NULL);
+    g_assert(sqlite3_bind_text(db->stmt, 1, filepath, -1, SQLITE_STATIC) == SQLITE_OK);
+    g_assert(sqlite3_bind_int(db->stmt, 2, index) == SQLITE_OK);
+    g_assert(sqlite3_bind_blob(db->stmt, 3, ranges, (int) size, SQLITE_STATIC) == SQLITE_OK);
+    g_assert(sqlite3_step_succeeded(db, SQLITE_DONE));
+    font_manager_database_end_query(db);
+    return;
+}
 
+static void
+insert_scan_results (FontManagerDatabase *db, FaceScan *scan, GError **error)
+{
+    g_return_if_fail(error == NULL || *error == NULL);
+    gint64 span = font_manager_profiler_begin();
+    const gchar *filepath = scan->filepath;
+    gint index = scan->index;
+    // Drop anything left over from a previous version of this file
+    for (gint i = 0; scan->known && DELETE_FACE_ROWS[i] != NULL; i++) {
+        execute_cached_query(db, DELETE_FACE_ROWS[i], error);
+        g_return_if_fail(error == NULL || *error == NULL);
+        g_assert(sqlite3_bind_text(db->stmt, 1, filepath, -1, SQLITE_STATIC) == SQLITE_OK);
+        g_assert(sqlite3_bind_int(db->stmt, 2, index) == SQLITE_OK);
+        g_assert(sqlite3_step_succeeded(db, SQLITE_DONE));
+        font_manager_database_end_query(db);
+    }
+    // Metadata table
+    execute_cached_query(db, INSERT_INFO_ROW, error);
+    g_return_if_fail(error == NULL || *error == NULL);
+    bind_from_properties(db->stmt, scan->metadata, INFO_PROPERTIES, G_N_ELEMENTS(INFO_PROPERTIES));
+    g_assert(sqlite3_step_succeeded(db, SQLITE_DONE));
+    font_manager_database_end_query(db);
+    // Panose table
+    if (json_object_has_member(scan->metadata, "panose")) {
+        JsonArray *panose = json_object_get_array_member(scan->metadata, "panose");
+        if (panose && json_array_get_length(panose) > 0) {
+            execute_cached_query(db, INSERT_PANOSE_ROW, error);
+            g_return_if_fail(error == NULL || *error == NULL);
+            for (int i = 0; i < 10; i++) {
+                int _index = i + 1;
+                int val = (int) json_array_get_int_element(panose, i);
+                g_assert(sqlite3_bind_int(db->stmt, _index, val) == SQLITE_OK);
+            }
+            g_assert(sqlite3_bind_text(db->stmt, 11, filepath, -1, SQLITE_STATIC) == SQLITE_OK);
+            g_assert(sqlite3_bind_int(db->stmt, 12, index) == SQLITE_OK);
+            g_assert(sqlite3_step_succeeded(db, SQLITE_DONE));
+            font_manager_database_end_query(db);
+        }
+    }
+    // Orthogaphy table
+    const gchar *sample = json_object_get_string_member(scan->orthography, "sample");
+    execute_cached_query(db, INSERT_ORTH_ROW, error);
+    g_return_if_fail(error == NULL || *error == NULL);
+    g_assert(sqlite3_bind_text(db->stmt, 1, filepath, -1, SQLITE_STATIC) == SQLITE_OK);
+    g_assert(sqlite3_bind_int(db->stmt, 2, index) == SQLITE_OK);
+    g_assert(sqlite3_bind_text(db->stmt, 3, sample, -1, SQLITE_STATIC) == SQLITE_OK);
+    g_assert(sqlite3_step_succeeded(db, SQLITE_DONE));
+    font_manager_database_end_query(db);
+    // Coverage table
+    JsonObjectIter iter;
+    const gchar *name;
+    JsonNode *node;
+    json_object_iter_init(&iter, scan->orthography);
+    while (json_object_iter_next(&iter, &name, &node)) {
+        // Skip anything which isn't an object representing an orthography
+        if (!JSON_NODE_HOLDS_OBJECT(node))
+            continue;
+        gdouble coverage = json_object_get_double_member(json_node_get_object(node), "coverage");
+        execute_cached_query(db, INSERT_COVERAGE_ROW, error);
+        g_return_if_fail(error == NULL || *error == NULL);
+        g_assert(sqlite3_bind_text(db->stmt, 1, filepath, -1, SQLITE_STATIC) == SQLITE_OK);
+        g_assert(sqlite3_bind_int(db->stmt, 2, index) == SQLITE_OK);
+        g_assert(sqlite3_bind_text(db->stmt, 3, name, -1, SQLITE_STATIC) == SQLITE_OK);
+        g_assert(sqlite3_bind_double(db->stmt, 4, coverage) == SQLITE_OK);
+        g_assert(sqlite3_step_succeeded(db, SQLITE_DONE));
+        font_manager_database_end_query(db);
+    }
+    // Codepoints table
+    insert_codepoints_row(db, filepath, index, scan->codepoints, error);
+    g_return_if_fail(error == NULL || *error == NULL);
+    // FileState table, written last so a failed scan is retried next time
+    execute_cached_query(db, INSERT_FILE_STATE_ROW, error);
+    g_return_if_fail(error == NULL || *error == NULL);
+    g_assert(sqlite3_bind_text(db->stmt, 1, filepath, -1, SQLITE_STATIC) == SQLITE_OK);
+    g_assert(sqlite3_bind_int(db->stmt, 2, index) == SQLITE_OK);
+    g_assert(sqlite3_bind_int64(db->stmt, 3, scan->state.mtime) == SQLITE_OK);
+    g_assert(sqlite3_bind_int64(db->stmt, 4, scan->state.size) == SQLITE_OK);
+    g_assert(sqlite3_bind_int64(db->stmt, 5, (sqlite3_int64) scan->state.inode) == SQLITE_OK);
+    g_assert(sqlite3_step_succeeded(db, SQLITE_DONE));
+    font_manager_database_end_query(db);
+    font_manager_profiler_end(span, "Database.insert");
+    return;
+}
+
+static void
+report_progress (DatabaseSyncData *data, FontManagerProgressData *progress, guint processed, guint64 bytes)
+{
+    font_manager_profiler_counter("Database.processed", processed);
+    font_manager_progress_data_update(progress, NULL, processed, bytes);
+    font_manager_progress_data_dispatch(progress, data->progress);
+    return;
+}
+
+/*
+ * Only rows which actually changed are written.
+ *
+ * Fonts rows are compared against the current listing and inserted, replaced
+ * or deleted as needed. Metadata, Panose and Orthography rows are only
+ * regenerated for faces whose file is new or whose mtime, size or inode
+ * no longer match the values recorded in the FileState table.
+ */
 static void
 update_available_fonts (DatabaseSyncData *data,
                         GCancellable *cancellable,
@@ -577,105 +1996,162 @@ update_available_fonts (DatabaseSyncData *data,
 
     FontManagerDatabase *db = FONT_MANAGER_DATABASE(data->db);
 
-    uint processed = 0;
-    uint total = json_array_get_length(data->available_fonts);
+    gint64 span = font_manager_profiler_begin();
+    uint processed = 0, committed = 0;
+    guint64 bytes = 0;
+    FontManagerFontTable *table = data->available_fonts;
+    uint total = font_manager_font_table_get_n_families(table);
     const gchar *message = _("Updating Database…");
-    g_autoptr(FontManagerStringSet) known_files = get_known_files(db);
+    g_autoptr(GHashTable) known_files = get_known_files(db);
+    g_autoptr(GHashTable) known_fonts = get_known_fonts(db);
     FontManagerProgressData *progress = font_manager_progress_data_new(message, processed, total);
+    /* Nothing to replace when populating an empty database */
+    gboolean bulk_insert = g_hash_table_size(known_files) == 0 && g_hash_table_size(known_fonts) == 0;
+
+    if (sqlite3_open_failed(db, error)) {
+        g_object_unref(progress);
+        return;
+    }
+
+    /* Settings which can't be changed once a transaction has started */
+    sqlite3_exec(db->db, "PRAGMA journal_mode = WAL;", NULL, 0, 0);
+    sqlite3_exec(db->db, "PRAGMA synchronous = NORMAL;", NULL, 0, 0);
+    sqlite3_exec(db->db, "PRAGMA temp_store = MEMORY;", NULL, 0, 0);
+    sqlite3_exec(db->db, "PRAGMA cache_size = -32768;", NULL, 0, 0);
 
     font_manager_database_begin_transaction(db, error);
-    g_return_if_fail(error == NULL || *error == NULL);
+    if (error != NULL && *error != NULL) {
+        g_object_unref(progress);
+        g_return_if_reached();
+    }
+
+    for (gint i = 0; bulk_insert && DROP_DEFERRED_INDEXES[i] != NULL; i++)
+        sqlite3_exec(db->db, DROP_DEFERRED_INDEXES[i], NULL, 0, 0);
+
+    GError *err = NULL;
+    guint n_workers = get_worker_count(db);
+    /* Limit the number of finished results waiting on the writer */
+    guint max_pending = n_workers * 8;
+    guint n_pending = 0;
+    /* Number of outstanding scans per family, a family is processed once it reaches 0 */
+    guint *family_pending = g_new0(guint, total > 0 ? total : 1);
+    /* Faces stored in the same file share a single mapping while being scanned */
+    g_autoptr(GHashTable) open_files = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+                                                              (GDestroyNotify) open_font_file_free);
+    ScanPipeline pipeline = { g_async_queue_new(), cancellable };
+    GThreadPool *pool = g_thread_pool_new((GFunc) scan_face_thread, &pipeline, n_workers, FALSE, NULL);
+    g_debug("Database.update_available_fonts : using %i worker threads", n_workers);
+
+    for (uint i = 0; i <= total; i++) {
+
+        /* Drain finished scans, blocking if too many are in flight or once
+         * everything has been queued and we're just waiting on workers */
+        while (n_pending > 0) {
+            gboolean wait = (i == total || n_pending >= max_pending);
+            FaceScan *scan = wait ? g_async_queue_pop(pipeline.results)
+                                  : g_async_queue_try_pop(pipeline.results);
+            if (scan == NULL)
+                break;
+            n_pending--;
+            if (scan->error != NULL && err == NULL) {
+                g_critical("Failed to get metadata for %s::%i - %s",
+                           scan->filepath, scan->index, scan->error->message);
+                /* No FileState row is written, the scan is retried next time */
+                insert_codepoints_row(db, scan->filepath, scan->index, NULL, &err);
+                if (err == NULL)
+                    g_propagate_error(&err, g_steal_pointer(&scan->error));
+            } else if (scan->metadata != NULL && scan->orthography != NULL && err == NULL) {
+                insert_scan_results(db, scan, &err);
+            }
+            bytes += (guint64) scan->state.size;
+            if (--family_pending[scan->family] == 0) {
+                processed++;
+                report_progress(data, progress, processed, bytes);
+            }
+            release_font_file(open_files, scan->filepath);
+            face_scan_free(scan);
+        }
+
+        if (i == total || err != NULL || g_cancellable_is_cancelled(cancellable))
+            continue;
 
-    for (uint i = 0; i < total; i++) {
-        if (g_cancellable_is_cancelled(cancellable))
-            break;
         /* Stash results periodically so we don't lose everything if closed */
-        if (processed > 0 && processed % 500 == 0) {
-            font_manager_database_commit_transaction(db, error);
-            g_return_if_fail(error == NULL || *error == NULL);
-            font_manager_database_begin_transaction(db, error);
-            g_return_if_fail(error == NULL || *error == NULL);
+        if (processed - committed >= 500) {
+            committed = processed;
+            font_manager_database_commit_transaction(db, &err);
+            if (err == NULL)
+                font_manager_database_begin_transaction(db, &err);
+            if (err != NULL)
+                continue;
         }
-        JsonObject *family = json_array_get_object_element(data->available_fonts, i);
-        const gchar *family_name = json_object_get_string_member(family, "family");
-        JsonArray *variations = json_object_get_array_member(family, "variations");
-        uint n_variations = json_array_get_length(variations);
-        for (uint v = 0; v < n_variations; v++) {
-            // g_autofree gchar *json_data = font_manager_print_json_object(json, FALSE);
-            // g_debug("Database.update_available_fonts : processing : %s", json_data);
-            JsonObject *face = json_array_get_object_element(variations, v);
-            int index = json_object_get_int_member(face, "findex");
-            const gchar *filepath = json_object_get_string_member(face, "filepath");
+
+        guint first_face = font_manager_font_table_get_first_face(table, i);
+        guint n_variations = font_manager_font_table_get_n_variations(table, i);
+        for (guint face = first_face; face < first_face + n_variations; face++) {
+            int index = font_manager_font_table_get_findex(table, face);
+            const gchar *filepath = font_manager_font_table_get_filepath(table, face);
+            g_autofree gchar *key = get_face_key(filepath, index);
             // Font table
-            font_manager_database_execute_query(db, INSERT_FONT_ROW, error);
-            g_return_if_fail(error == NULL || *error == NULL);
-            bind_from_properties(db->stmt, face, FONT_PROPERTIES, G_N_ELEMENTS(FONT_PROPERTIES));
-            g_assert(sqlite3_step_succeeded(db, SQLITE_DONE));
-            g_return_if_fail(error == NULL || *error == NULL);
-            font_manager_database_end_query(db);
-            if (font_manager_string_set_contains(known_files, filepath)) {
+            FontRow *row = g_hash_table_lookup(known_fonts, key);
+            g_autofree gchar *signature = get_face_signature(table, face);
+            if (row == NULL || g_strcmp0(row->signature, signature) != 0) {
+                /* Only faces which need to be written are converted */
+                g_autoptr(JsonObject) face_obj = font_manager_font_table_get_face_object(table, face);
+                insert_font_row(db, face_obj, row, &err);
+                if (err != NULL)
+                    break;
+            }
+            if (row != NULL)
+                row->seen = TRUE;
+            // Everything else
+            FileState state = { 0, 0, 0 };
+            FileState *known_state = g_hash_table_lookup(known_files, key);
+            if (!get_file_state(filepath, &state))
+                g_warning("Failed to stat %s", filepath);
+            if (known_state && file_state_equal(known_state, &state)) {
                 /* g_debug("Database.update_available_fonts : ignoring known font path : %i : %s", index, filepath); */
                 continue;
-            } else {
-                g_debug("Database.update_available_fonts : adding new font path : %i : %s", index, filepath);
-                // Metadata table
-                g_autoptr(JsonObject) _face = font_manager_get_metadata(filepath, index, error);
-                if (error != NULL && *error != NULL) {
-                    GError *err = *error;
-                    g_critical("Failed to get metadata for %s::%i - %s", filepath, index, err->message);
-                    g_return_if_fail(error == NULL || *error == NULL);
-                }
-                font_manager_database_execute_query(db, INSERT_INFO_ROW, error);
-                g_return_if_fail(error == NULL || *error == NULL);
-                bind_from_properties(db->stmt, _face, INFO_PROPERTIES, G_N_ELEMENTS(INFO_PROPERTIES));
-                g_assert(sqlite3_step_succeeded(db, SQLITE_DONE));
-                font_manager_database_end_query(db);
-                // Panose table
-                if (json_object_has_member(_face, "panose")) {
-                    JsonArray *panose = json_object_get_array_member(_face, "panose");
-                    if (panose && json_array_get_length(panose) > 0) {
-                        font_manager_database_execute_query(db, INSERT_PANOSE_ROW, error);
-                        g_return_if_fail(error == NULL || *error == NULL);
-                        for (int i = 0; i < 10; i++) {
-                            int _index = i + 1;
-                            int val = (int) json_array_get_int_element(panose, i);
-                            g_assert(sqlite3_bind_int(db->stmt, _index, val) == SQLITE_OK);
-                        }
-                        g_assert(sqlite3_bind_text(db->stmt, 11, filepath, -1, SQLITE_STATIC) == SQLITE_OK);
-                        g_assert(sqlite3_bind_int(db->stmt, 12, index) == SQLITE_OK);
-                        g_assert(sqlite3_step_succeeded(db, SQLITE_DONE));
-                        font_manager_database_end_query(db);
-                    }
-                }
-                // Orthogaphy table
-                gboolean blank_font = FALSE;
-                if (g_strv_contains(FONT_MANAGER_SKIP_ORTH_SCAN, family_name))
-                    blank_font = TRUE;
-                g_autoptr(JsonObject) orth = font_manager_get_orthography_results(blank_font ? NULL : face);
-                g_autofree gchar *json_obj = font_manager_print_json_object(orth, FALSE);
-                const gchar *sample = json_object_get_string_member(orth, "sample");
-                font_manager_database_execute_query(db, INSERT_ORTH_ROW, error);
-                g_assert(sqlite3_bind_text(db->stmt, 1, filepath, -1, SQLITE_STATIC) == SQLITE_OK);
-                g_assert(sqlite3_bind_int(db->stmt, 2, index) == SQLITE_OK);
-                g_assert(sqlite3_bind_text(db->stmt, 3, json_obj, -1, SQLITE_STATIC) == SQLITE_OK);
-                g_assert(sqlite3_bind_text(db->stmt, 4, sample, -1, SQLITE_STATIC) == SQLITE_OK);
-                g_assert(sqlite3_step_succeeded(db, SQLITE_DONE));
-                font_manager_database_end_query(db);
             }
+            g_debug("Database.update_available_fonts : %s font path : %i : %s",
+                    known_state ? "updating modified" : "adding new", index, filepath);
+            FaceScan *scan = g_new0(FaceScan, 1);
+            scan->filepath = filepath;
+            scan->index = index;
+            scan->family = i;
+            scan->state = state;
+            scan->file = acquire_font_file(open_files, filepath);
+            scan->known = !bulk_insert;
+            family_pending[i]++;
+            n_pending++;
+            g_thread_pool_push(pool, scan, NULL);
         }
-        processed++;
-        if (data->progress) {
-            g_object_ref(progress);
-            g_object_set(progress, "processed", processed, "total", total, NULL);
-            g_main_context_invoke_full(g_main_context_get_thread_default(),
-                                       G_PRIORITY_HIGH_IDLE,
-                                       (GSourceFunc) data->progress,
-                                       progress,
-                                       (GDestroyNotify) g_object_unref);
+
+        if (family_pending[i] == 0) {
+            processed++;
+            report_progress(data, progress, processed, bytes);
         }
+
     }
-    font_manager_database_commit_transaction(db, error);
+
+    g_thread_pool_free(pool, FALSE, TRUE);
+    g_async_queue_unref(pipeline.results);
+    g_free(family_pending);
+    /* Only safe to drop rows for missing faces if we made it all the way through */
+    if (err == NULL && !g_cancellable_is_cancelled(cancellable))
+        remove_stale_font_rows(db, known_fonts, &err);
+    if (db->in_transaction) {
+        if (err == NULL)
+            font_manager_database_commit_transaction(db, &err);
+        else
+            font_manager_database_commit_transaction(db, NULL);
+    }
+    for (gint i = 0; bulk_insert && CREATE_DEFERRED_INDEXES[i] != NULL; i++)
+        sqlite3_exec(db->db, CREATE_DEFERRED_INDEXES[i], NULL, 0, 0);
+    sqlite3_exec(db->db, "PRAGMA cache_size = -2000;", NULL, 0, 0);
+    if (err != NULL)
+        g_propagate_error(error, err);
     g_object_unref(progress);
+    font_manager_profiler_end(span, "Database.sync");
     return;
 }
 
@@ -693,11 +2169,19 @@ font_manager_update_database_sync (DatabaseSyncData *data,
     if (data->db->db == NULL)
         font_manager_database_open(data->db, NULL);
 
-    sqlite3_exec(data->db->db, "DELETE FROM Fonts;", NULL, 0, 0);
-    sqlite3_exec(data->db->db, CREATE_FONTS_TABLE, NULL, 0, 0);
-    sqlite3_exec(data->db->db, CREATE_FONT_MATCH_INDEX, NULL, 0, 0);
     update_available_fonts(data, cancellable, error);
     g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+    /* Orphaned rows can only be identified once every font has been seen */
+    if (!g_cancellable_is_cancelled(cancellable)) {
+        GError *err = NULL;
+        font_manager_database_run_maintenance(data->db, &err);
+        if (err != NULL) {
+            g_warning("Database maintenance failed : %s", err->message);
+            g_clear_error(&err);
+        }
+    }
+
     return TRUE;
 }
 
@@ -723,7 +2207,7 @@ sync_database_thread (GTask *task,
 /**
  * font_manager_update_database:
  * @db: #FontManagerDatabase instance
- * @available_fonts: #JsonArray returned by #font_manager_sort_json_listing
+ * @available_fonts: #FontManagerFontTable returned by #font_manager_get_available_font_table
  * @progress: (scope call) (nullable): #FontManagerProgressCallback
  * @cancellable: (nullable): #GCancellable or %NULL
  * @callback: (nullable) (scope async): #GAsyncReadyCallback or %NULL
@@ -733,7 +2217,7 @@ sync_database_thread (GTask *task,
  */
 void
 font_manager_update_database (FontManagerDatabase *db,
-                              JsonArray *available_fonts,
+                              FontManagerFontTable *available_fonts,
                               FontManagerProgressCallback progress,
                               GCancellable *cancellable,
                               GAsyncReadyCallback callback,
@@ -40,12 +40,13 @@
 #include "font-manager-string-set.h"
 #include "font-manager-utils.h"
 
-#define FONT_MANAGER_CURRENT_DATABASE_VERSION 5
+#define FONT_MANAGER_CURRENT_DATABASE_VERSION 9
 
 #define FONT_MANAGER_TYPE_DATABASE font_manager_database_get_type()
 G_DECLARE_FINAL_TYPE(FontManagerDatabase, font_manager_database, FONT_MANAGER, DATABASE, GObject)
 
 FontManagerDatabase * font_manager_database_new (void);
+FontManagerDatabase * font_manager_database_get_reader (void);
 void font_manager_database_open (FontManagerDatabase *self, GError **error);
 void font_manager_database_close (FontManagerDatabase *self, GError **error);
 void font_manager_database_begin_transaction (FontManagerDatabase *self, GError **error);
@@ -54,13 +55,27 @@ void font_manager_database_execute_query (FontManagerDatabase *self, const gchar
 void font_manager_database_end_query (FontManagerDatabase *self);
 sqlite3_stmt * font_manager_database_get_cursor (FontManagerDatabase *self);
 void font_manager_database_vacuum (FontManagerDatabase *self, GError **error);
+gint64 font_manager_database_run_maintenance (FontManagerDatabase *self, GError **error);
 void font_manager_database_initialize (FontManagerDatabase *self, GError **error);
+gint font_manager_database_get_version (FontManagerDatabase *self, GError **error);
 JsonObject * font_manager_database_get_object (FontManagerDatabase *self, const gchar *sql, GError **error);
+JsonObject * font_manager_database_get_orthography (FontManagerDatabase *self,
+                                                    const gchar *filepath,
+                                                    gint index,
+                                                    GError **error);
+JsonObject * font_manager_database_get_available_fonts_for_chars (FontManagerDatabase *self,
+                                                                  const gchar *chars,
+                                                                  GError **error);
+JsonArray * font_manager_database_search (FontManagerDatabase *self,
+                                          const gchar *search_term,
+                                          GError **error);
+JsonObject * font_manager_database_get_search_metadata (FontManagerDatabase *self,
+                                                       GError **error);
 
 /* Related functions */
 
 void font_manager_update_database (FontManagerDatabase *db,
-                                   JsonArray *available_fonts,
+                                   FontManagerFontTable *available_fonts,
                                    FontManagerProgressCallback progress,
                                    GCancellable *cancellable,
                                    GAsyncReadyCallback callback,
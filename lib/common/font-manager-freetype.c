@@ -163,6 +163,159 @@ font_manager_get_font_revision (const gchar *filepath)
     return result;
 }
 
+struct _FontManagerFontFile
+{
+    gint ref_count;
+    GMutex lock;
+    gchar *filepath;
+    GMappedFile *mapping;
+    gchar *checksum;
+};
+
+/**
+ * font_manager_font_file_new: (skip)
+ * @filepath:   full path to font file
+ *
+ * #FontManagerFontFile maps @filepath into memory the first time its contents
+ * are needed and shares that mapping, and its checksum, between every face
+ * read from it. It is safe to use from multiple threads.
+ *
+ * Returns: (transfer full): #FontManagerFontFile.
+ * Free the returned object using #font_manager_font_file_unref when no longer needed.
+ */
+FontManagerFontFile *
+font_manager_font_file_new (const gchar *filepath)
+{
+    g_return_val_if_fail(filepath != NULL, NULL);
+    FontManagerFontFile *self = g_new0(FontManagerFontFile, 1);
+    self->ref_count = 1;
+    g_mutex_init(&self->lock);
+    self->filepath = g_strdup(filepath);
+    return self;
+}
+
+/**
+ * font_manager_font_file_ref: (skip)
+ * @self:   #FontManagerFontFile
+ *
+ * Returns: (transfer full): @self
+ */
+FontManagerFontFile *
+font_manager_font_file_ref (FontManagerFontFile *self)
+{
+    g_return_val_if_fail(self != NULL, NULL);
+    g_atomic_int_inc(&self->ref_count);
+    return self;
+}
+
+/**
+ * font_manager_font_file_unref: (skip)
+ * @self:   #FontManagerFontFile
+ */
+void
+font_manager_font_file_unref (FontManagerFontFile *self)
+{
+    g_return_if_fail(self != NULL);
+    if (!g_atomic_int_dec_and_test(&self->ref_count))
+        return;
+    g_clear_pointer(&self->mapping, g_mapped_file_unref);
+    g_clear_pointer(&self->checksum, g_free);
+    g_clear_pointer(&self->filepath, g_free);
+    g_mutex_clear(&self->lock);
+    g_free(self);
+    return;
+}
+
+/**
+ * font_manager_font_file_get_filepath: (skip)
+ * @self:   #FontManagerFontFile
+ *
+ * Returns: (transfer none): full path to font file
+ */
+const gchar *
+font_manager_font_file_get_filepath (FontManagerFontFile *self)
+{
+    g_return_val_if_fail(self != NULL, NULL);
+    return self->filepath;
+}
+
+/**
+ * font_manager_font_file_get_data: (skip)
+ * @self:   #FontManagerFontFile
+ * @size: (out): size of returned data
+ * @error:      #GError or %NULL to ignore errors
+ *
+ * Returns: (transfer none) (nullable): contents of the font file, valid for the
+ * lifetime of @self or %NULL if the file could not be mapped.
+ */
+const gchar *
+font_manager_font_file_get_data (FontManagerFontFile *self, gsize *size, GError **error)
+{
+    g_return_val_if_fail(self != NULL, NULL);
+    g_return_val_if_fail((error == NULL || *error == NULL), NULL);
+    g_mutex_lock(&self->lock);
+    if (self->mapping == NULL)
+        self->mapping = g_mapped_file_new(self->filepath, FALSE, error);
+    GMappedFile *mapping = self->mapping;
+    g_mutex_unlock(&self->lock);
+    if (mapping == NULL)
+        return NULL;
+    /* Empty files have no contents to map */
+    if (g_mapped_file_get_length(mapping) == 0) {
+        g_set_error(error, G_FILE_ERROR, G_FILE_ERROR_INVAL, "File is empty");
+        return NULL;
+    }
+    *size = g_mapped_file_get_length(mapping);
+    return g_mapped_file_get_contents(mapping);
+}
+
+/**
+ * font_manager_font_file_get_checksum: (skip)
+ * @self:   #FontManagerFontFile
+ *
+ * Returns: (transfer none) (nullable): MD5 checksum of the font file, computed once
+ * or %NULL if the file could not be mapped.
+ */
+const gchar *
+font_manager_font_file_get_checksum (FontManagerFontFile *self)
+{
+    g_return_val_if_fail(self != NULL, NULL);
+    gsize size = 0;
+    const gchar *data = font_manager_font_file_get_data(self, &size, NULL);
+    if (data == NULL)
+        return NULL;
+    g_mutex_lock(&self->lock);
+    if (self->checksum == NULL)
+        self->checksum = g_compute_checksum_for_data(G_CHECKSUM_MD5, (const guchar *) data, size);
+    g_mutex_unlock(&self->lock);
+    return self->checksum;
+}
+
+static void
+free_thread_library (FT_Library library)
+{
+    FT_Done_FreeType(library);
+    return;
+}
+
+/* Initializing FreeType is not free, each thread keeps its own instance */
+static GPrivate thread_library = G_PRIVATE_INIT((GDestroyNotify) free_thread_library);
+
+static FT_Library
+get_thread_library (GError **error)
+{
+    FT_Library library = g_private_get(&thread_library);
+    if (library == NULL) {
+        FT_Error ft_error = FT_Init_FreeType(&library);
+        if (G_UNLIKELY(ft_error)) {
+            set_error(ft_error, "FT_Init_FreeType", error);
+            return NULL;
+        }
+        g_private_set(&thread_library, library);
+    }
+    return library;
+}
+
 /**
  * font_manager_get_metadata:
  * @filepath:   full path to font file to examine
@@ -179,13 +332,38 @@ font_manager_get_metadata (const gchar *filepath, gint index, GError **error)
 {
     g_return_val_if_fail(filepath != NULL, NULL);
     g_return_val_if_fail((error == NULL || *error == NULL), NULL);
+    FontManagerFontFile *file = font_manager_font_file_new(filepath);
+    JsonObject *result = font_manager_font_file_get_metadata(file, index, error);
+    font_manager_font_file_unref(file);
+    return result;
+}
+
+/**
+ * font_manager_font_file_get_metadata: (skip)
+ * @self:       #FontManagerFontFile
+ * @index:      face index to examine
+ * @error:      #GError or %NULL to ignore errors
+ *
+ * Same as #font_manager_get_metadata, reusing the mapping held by @self.
+ *
+ * Returns: (transfer full) (nullable): A newly created #JsonObject or %NULL if there was an error.
+ * Free the returned object using #json_object_unref when no longer needed.
+ */
+JsonObject *
+font_manager_font_file_get_metadata (FontManagerFontFile *self, gint index, GError **error)
+{
+    g_return_val_if_fail(self != NULL, NULL);
+    g_return_val_if_fail((error == NULL || *error == NULL), NULL);
 
     FT_Face         face;
     FT_Library      library;
     FT_Error        ft_error;
 
     gsize           filesize = 0;
-    g_autofree gchar *font = NULL;
+    const gchar    *filepath = self->filepath;
+    const gchar    *font = NULL;
+    GError         *read_error = NULL;
+    gint64          span = font_manager_profiler_begin();
 
     g_autoptr(JsonObject) json_obj = json_object_new();
 
@@ -193,17 +371,18 @@ font_manager_get_metadata (const gchar *filepath, gint index, GError **error)
     json_object_set_int_member(json_obj, "findex", index);
     json_object_set_int_member(json_obj, "owner", font_manager_get_file_owner(filepath));
 
-    if (G_UNLIKELY(!g_file_get_contents(filepath, &font, &filesize, error))) {
-        g_critical("%s : %s", (*error)->message, filepath);
+    font = font_manager_font_file_get_data(self, &filesize, &read_error);
+
+    if (G_UNLIKELY(font == NULL)) {
+        g_critical("%s : %s", read_error->message, filepath);
+        g_propagate_error(error, read_error);
         return NULL;
     }
 
-    ft_error = FT_Init_FreeType(&library);
+    library = get_thread_library(error);
 
-    if (G_UNLIKELY(ft_error)) {
-        set_error(ft_error, "FT_Init_FreeType", error);
+    if (G_UNLIKELY(library == NULL))
         return NULL;
-    }
 
     ft_error = FT_New_Memory_Face(library, (const FT_Byte *) font, (FT_Long) filesize, index, &face);
 
@@ -213,9 +392,8 @@ font_manager_get_metadata (const gchar *filepath, gint index, GError **error)
     }
 
     g_autofree gchar *_size = g_format_size(filesize);
-    g_autofree gchar *_md5 = g_compute_checksum_for_data(G_CHECKSUM_MD5, (const guchar *) font, filesize);
     json_object_set_string_member(json_obj, "filesize", _size);
-    json_object_set_string_member(json_obj, "checksum", _md5);
+    json_object_set_string_member(json_obj, "checksum", font_manager_font_file_get_checksum(self));
 
     /* Fontconfig modifies invalid PostScript names by replacing illegal characters with - */
     json_object_set_string_member(json_obj, "psname", FT_Get_Postscript_Name(face));
@@ -291,7 +469,7 @@ font_manager_get_metadata (const gchar *filepath, gint index, GError **error)
             json_object_set_string_member(json_obj, ensure_member[i], NULL);
 
     FT_Done_Face(face);
-    FT_Done_FreeType(library);
+    font_manager_profiler_end(span, "Freetype.metadata");
     return g_steal_pointer(&json_obj);
 }
 
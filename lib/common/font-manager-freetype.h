@@ -55,6 +55,23 @@ typedef enum
 }
 FontManagerFreetypeError;
 
+/**
+ * FontManagerFontFile: (skip)
+ *
+ * Opaque, reference counted handle to a memory mapped font file.
+ */
+typedef struct _FontManagerFontFile FontManagerFontFile;
+
+FontManagerFontFile * font_manager_font_file_new (const gchar *filepath);
+FontManagerFontFile * font_manager_font_file_ref (FontManagerFontFile *self);
+void font_manager_font_file_unref (FontManagerFontFile *self);
+const gchar * font_manager_font_file_get_filepath (FontManagerFontFile *self);
+const gchar * font_manager_font_file_get_data (FontManagerFontFile *self, gsize *size, GError **error);
+const gchar * font_manager_font_file_get_checksum (FontManagerFontFile *self);
+JsonObject * font_manager_font_file_get_metadata (FontManagerFontFile *self,
+                                                  gint index,
+                                                  GError **error);
+
 glong font_manager_get_face_count (const gchar * filepath, GError **error);
 gfloat font_manager_get_font_revision (const gchar *filepath);
 
@@ -40,15 +40,110 @@
 #define GET_COVERAGE(n) HAS_COVERAGE(n) ? json_object_get_double_member(GET_OBJECT(n), "coverage") : 0.0
 #define LEN_CHARSET(n) json_array_get_length(json_object_get_array_member(GET_OBJECT(n), "filter"))
 
-static GList *
-_hb_set_to_list (const hb_set_t *charset)
+/*
+ * Every orthography is compiled into an hb_set_t the first time it's needed.
+ *
+ * hb_set_t stores codepoints as a sparse paged bitmap, so coverage can be
+ * determined by intersecting the orthography with the charset of a font
+ * instead of testing each codepoint individually.
+ *
+ * hb_set_t caches its population internally the first time it is queried,
+ * so the population of each set is stored alongside it while the tables are
+ * built. The sets are shared between scan threads and must not be modified,
+ * queried for their population, or otherwise written to after that.
+ */
+
+typedef struct
+{
+    const FontManagerOrthographyData *data;
+    gint len;
+    hb_set_t **sets;
+    guint *populations;
+}
+OrthographyTable;
+
+static hb_set_t *ArabicSets[N_ARABIC];
+static guint ArabicPopulations[N_ARABIC];
+static hb_set_t *ChineseSets[N_CHINESE];
+static guint ChinesePopulations[N_CHINESE];
+static hb_set_t *GreekSets[N_GREEK];
+static guint GreekPopulations[N_GREEK];
+static hb_set_t *JapaneseSets[N_JAPANESE];
+static guint JapanesePopulations[N_JAPANESE];
+static hb_set_t *KoreanSets[N_KOREAN];
+static guint KoreanPopulations[N_KOREAN];
+static hb_set_t *LatinSets[N_LATIN];
+static guint LatinPopulations[N_LATIN];
+static hb_set_t *MiscSets[N_MISC];
+static guint MiscPopulations[N_MISC];
+
+static const OrthographyTable ArabicTable = { ArabicOrthographies, N_ARABIC, ArabicSets, ArabicPopulations };
+static const OrthographyTable ChineseTable = { ChineseOrthographies, N_CHINESE, ChineseSets, ChinesePopulations };
+static const OrthographyTable GreekTable = { GreekOrthographies, N_GREEK, GreekSets, GreekPopulations };
+static const OrthographyTable JapaneseTable = { JapaneseOrthographies, N_JAPANESE, JapaneseSets, JapanesePopulations };
+static const OrthographyTable KoreanTable = { KoreanOrthographies, N_KOREAN, KoreanSets, KoreanPopulations };
+static const OrthographyTable LatinTable = { LatinOrthographies, N_LATIN, LatinSets, LatinPopulations };
+static const OrthographyTable MiscTable = { UncategorizedOrthographies, N_MISC, MiscSets, MiscPopulations };
+
+static const OrthographyTable *OrthographyTables[] = {
+    &ArabicTable,
+    &ChineseTable,
+    &GreekTable,
+    &JapaneseTable,
+    &KoreanTable,
+    &LatinTable,
+    &MiscTable
+};
+
+static hb_set_t *
+compile_orthography (const FontManagerOrthographyData *data)
 {
-    GList *result = NULL;
+    hb_set_t *result = hb_set_create();
+    for (int i = 0; data->values[i] != FONT_MANAGER_END_OF_DATA; i++) {
+        if (data->values[i] == FONT_MANAGER_START_RANGE_PAIR) {
+            gunichar start = data->values[++i];
+            gunichar end = data->values[++i];
+            hb_set_add_range(result, start, end);
+        } else {
+            hb_set_add(result, data->values[i]);
+        }
+    }
+    return result;
+}
+
+/* Maps orthography names to their entry in one of the tables above */
+static GHashTable *OrthographyNames = NULL;
+
+static void
+ensure_orthography_sets (void)
+{
+    static gsize initialized = 0;
+    if (g_once_init_enter(&initialized)) {
+        OrthographyNames = g_hash_table_new(g_str_hash, g_str_equal);
+        for (guint t = 0; t < G_N_ELEMENTS(OrthographyTables); t++) {
+            const OrthographyTable *table = OrthographyTables[t];
+            for (gint i = 0; i < table->len; i++) {
+                table->sets[i] = compile_orthography(&table->data[i]);
+                table->populations[i] = hb_set_get_population(table->sets[i]);
+                g_hash_table_insert(OrthographyNames,
+                                    (gpointer) table->data[i].name,
+                                    (gpointer) &table->data[i]);
+            }
+        }
+        g_once_init_leave(&initialized, 1);
+    }
+    return;
+}
+
+static GArray *
+_hb_set_to_array (const hb_set_t *charset)
+{
+    GArray *result = g_array_sized_new(FALSE, FALSE, sizeof(gunichar), hb_set_get_population(charset));
     hb_codepoint_t codepoint = HB_SET_VALUE_INVALID;
     while (hb_set_next(charset, &codepoint))
         if (font_manager_unicode_unichar_isgraph(codepoint))
-            result = g_list_prepend(result, GINT_TO_POINTER(codepoint));
-    return g_list_reverse(result);
+            g_array_append_val(result, codepoint);
+    return result;
 }
 
 static JsonArray *
@@ -62,8 +157,15 @@ _hb_set_to_json_array (const hb_set_t *charset)
     return result;
 }
 
-static hb_set_t *
-get_charset_from_font_object (JsonObject *font)
+/**
+ * font_manager_get_charset_from_font_object: (skip)
+ * @font: #JsonObject
+ *
+ * Returns: (transfer full): #hb_set_t containing every codepoint mapped by @font.
+ * Free the returned set using #hb_set_destroy() when no longer needed.
+ */
+hb_set_t *
+font_manager_get_charset_from_font_object (JsonObject *font)
 {
     hb_blob_t *blob = hb_blob_create_from_file(json_object_get_string_member(font, "filepath"));
     hb_face_t *face = hb_face_create(blob, json_object_get_int_member(font, "findex"));
@@ -74,6 +176,34 @@ get_charset_from_font_object (JsonObject *font)
     return charset;
 }
 
+/**
+ * font_manager_get_charset_from_font_file: (skip)
+ * @file:   #FontManagerFontFile
+ * @index:  face index
+ *
+ * Same as #font_manager_get_charset_from_font_object, reusing the mapping held by @file.
+ *
+ * Returns: (transfer full): #hb_set_t containing every codepoint mapped by the face.
+ * Free the returned set using #hb_set_destroy() when no longer needed.
+ */
+hb_set_t *
+font_manager_get_charset_from_font_file (FontManagerFontFile *file, gint index)
+{
+    gsize size = 0;
+    hb_set_t *charset = hb_set_create();
+    const gchar *data = font_manager_font_file_get_data(file, &size, NULL);
+    if (data == NULL)
+        return charset;
+    hb_blob_t *blob = hb_blob_create(data, (unsigned int) size, HB_MEMORY_MODE_READONLY,
+                                     font_manager_font_file_ref(file),
+                                     (hb_destroy_func_t) font_manager_font_file_unref);
+    hb_face_t *face = hb_face_create(blob, index);
+    hb_face_collect_unicodes(face, charset);
+    hb_blob_destroy(blob);
+    hb_face_destroy(face);
+    return charset;
+}
+
 static gint
 sort_by_charset_size (gconstpointer a, gconstpointer b)
 {
@@ -91,14 +221,14 @@ sort_by_coverage (gconstpointer a, gconstpointer b)
 }
 
 static gchar *
-get_sample_from_charlist (GList *charlist)
+get_sample_from_chararray (GArray *chararray)
 {
     GString *res = g_string_new(NULL);
-    guint length = g_list_length(charlist);
+    guint length = chararray->len;
     if (length > 0)
         for (int i = 0; i < 24; i++) {
             int rand = g_random_int_range(0, length);
-            gunichar ch = GPOINTER_TO_INT(g_list_nth_data(charlist, rand));
+            gunichar ch = g_array_index(chararray, gunichar, rand);
             g_string_append_unichar(res, ch);
         }
     return g_string_free(res, FALSE);
@@ -107,9 +237,9 @@ get_sample_from_charlist (GList *charlist)
 static gchar *
 get_sample_from_charset (hb_set_t *charset)
 {
-    GList *charlist = _hb_set_to_list(charset);
-    gchar *res = get_sample_from_charlist(charlist);
-    g_list_free(charlist);
+    GArray *chararray = _hb_set_to_array(charset);
+    gchar *res = get_sample_from_chararray(chararray);
+    g_array_unref(chararray);
     return res;
 }
 
@@ -128,50 +258,44 @@ get_default_orthography (JsonObject *orthography)
     return res;
 }
 
-static double
-get_coverage_from_charset (JsonObject *results,
-                           hb_set_t *charset,
-                           const FontManagerOrthographyData *data)
+static JsonArray *
+get_filter_from_orthography (const FontManagerOrthographyData *data)
 {
-    int hits = 0, tries = 0;
-    JsonArray *filter = NULL;
-
-    /* If it doesn't contain key there's no point in going further */
-    if (!hb_set_has(charset, data->key))
-        return 0;
-
-    if (results)
-        filter = json_array_new();
-
+    JsonArray *filter = json_array_new();
     for (int i = 0; data->values[i] != FONT_MANAGER_END_OF_DATA; i++) {
-
         if (data->values[i] == FONT_MANAGER_START_RANGE_PAIR) {
-
             gunichar start = data->values[++i];
             gunichar end = data->values[++i];
-
-            for (gunichar codepoint = start; codepoint <= end; codepoint++) {
-                tries++;
-                if (hb_set_has(charset, codepoint))
-                    hits++;
-                if (results)
-                    json_array_add_int_element(filter, (int) codepoint);
-            }
-
+            for (gunichar codepoint = start; codepoint <= end; codepoint++)
+                json_array_add_int_element(filter, (int) codepoint);
         } else {
+            json_array_add_int_element(filter, (int) data->values[i]);
+        }
+    }
+    return filter;
+}
 
-            tries++;
-            if (hb_set_has(charset, data->values[i]))
-                hits++;
-            if (results)
-                json_array_add_int_element(filter, (int) data->values[i]);
+static double
+get_coverage_from_charset (JsonObject *results,
+                           hb_set_t *charset,
+                           const FontManagerOrthographyData *data,
+                           const hb_set_t *orthography,
+                           guint tries)
+{
+    /* If it doesn't contain key there's no point in going further */
+    if (!hb_set_has(charset, data->key))
+        return 0;
 
-        }
+    if (tries == 0)
+        return 0;
 
-    }
+    hb_set_t *intersection = hb_set_copy(orthography);
+    hb_set_intersect(intersection, charset);
+    unsigned int hits = hb_set_get_population(intersection);
+    hb_set_destroy(intersection);
 
     if (results)
-        json_object_set_array_member(results, "filter", filter);
+        json_object_set_array_member(results, "filter", get_filter_from_orthography(data));
 
     return ((double) 100 * hits/tries );
 }
@@ -179,12 +303,16 @@ get_coverage_from_charset (JsonObject *results,
 static gboolean
 check_orthography (JsonObject *results,
                    hb_set_t *charset,
-                   const FontManagerOrthographyData *data)
+                   const OrthographyTable *table,
+                   gint index)
 {
+    const FontManagerOrthographyData *data = &table->data[index];
     g_autoptr(JsonObject) res = NULL;
     if (results)
         res = json_object_new();
-    double coverage = get_coverage_from_charset(res, charset, data);
+    double coverage = get_coverage_from_charset(res, charset, data,
+                                                table->sets[index],
+                                                table->populations[index]);
     if (coverage == 0)
         return FALSE;
     if (!results)
@@ -213,11 +341,10 @@ charset_contains_sample_string (const hb_set_t *charset, const char *sample)
 static void
 check_orthographies (JsonObject *results,
                      hb_set_t *charset,
-                     const FontManagerOrthographyData orth[],
-                     int len)
+                     const OrthographyTable *table)
 {
-    for (int i = 0; i < len; i++)
-        check_orthography(results, charset, &orth[i]);
+    for (int i = 0; i < table->len; i++)
+        check_orthography(results, charset, table, i);
     return;
 }
 
@@ -288,26 +415,44 @@ get_sample_string (JsonObject *orthography, hb_set_t *charset)
 JsonObject *
 font_manager_get_orthography_results (JsonObject *font)
 {
-    hb_set_t *charset = NULL;
-    JsonObject *results = json_object_new();
+    hb_set_t *charset = font ? font_manager_get_charset_from_font_object(font) : NULL;
+    JsonObject *results = font_manager_get_orthography_results_for_charset(charset);
+    if (charset)
+        hb_set_destroy(charset);
+    return results;
+}
 
-    if (font)
-        charset = get_charset_from_font_object(font);
+/**
+ * font_manager_get_orthography_results_for_charset: (skip)
+ * @charset: (nullable): #hb_set_t
+ *
+ * Same as #font_manager_get_orthography_results for callers which
+ * already have the charset of the font at hand.
+ *
+ * Returns: (nullable) (transfer full): #JsonObject containing orthography results
+ */
+JsonObject *
+font_manager_get_orthography_results_for_charset (hb_set_t *charset)
+{
+    gint64 span = font_manager_profiler_begin();
+    JsonObject *results = json_object_new();
 
     if (charset) {
-        if (check_orthography(NULL, charset, LatinOrthographies))
-            check_orthographies(results, charset, LatinOrthographies, N_LATIN);
+        ensure_orthography_sets();
 
-        if (check_orthography(NULL, charset, GreekOrthographies))
-            check_orthographies(results, charset, GreekOrthographies, N_GREEK);
+        if (check_orthography(NULL, charset, &LatinTable, 0))
+            check_orthographies(results, charset, &LatinTable);
 
-        if (check_orthography(NULL, charset, ArabicOrthographies))
-            check_orthographies(results, charset, ArabicOrthographies, N_ARABIC);
+        if (check_orthography(NULL, charset, &GreekTable, 0))
+            check_orthographies(results, charset, &GreekTable);
 
-        check_orthographies(results, charset, ChineseOrthographies, N_CHINESE);
-        check_orthographies(results, charset, JapaneseOrthographies, N_JAPANESE);
-        check_orthographies(results, charset, KoreanOrthographies, N_KOREAN);
-        check_orthographies(results, charset, UncategorizedOrthographies, N_MISC);
+        if (check_orthography(NULL, charset, &ArabicTable, 0))
+            check_orthographies(results, charset, &ArabicTable);
+
+        check_orthographies(results, charset, &ChineseTable);
+        check_orthographies(results, charset, &JapaneseTable);
+        check_orthographies(results, charset, &KoreanTable);
+        check_orthographies(results, charset, &MiscTable);
     }
 
     if (charset && !hb_set_is_empty(charset)) {
@@ -330,9 +475,7 @@ font_manager_get_orthography_results (JsonObject *font)
 
     }
 
-    if (charset)
-        hb_set_destroy(charset);
-
+    font_manager_profiler_end(span, "Orthography.scan");
     return results;
 }
 
@@ -347,7 +490,7 @@ gchar *
 font_manager_get_sample_string (JsonObject *font)
 {
     const char *local_sample = pango_language_get_sample_string(NULL);
-    hb_set_t *charset = get_charset_from_font_object(font);
+    hb_set_t *charset = font_manager_get_charset_from_font_object(font);
     if (charset_contains_sample_string(charset, local_sample)) {
         hb_set_destroy(charset);
         return NULL;
@@ -360,3 +503,75 @@ font_manager_get_sample_string (JsonObject *font)
     return sample;
 }
 
+/**
+ * font_manager_get_orthography_data: (skip)
+ * @name:   Untranslated name of an orthography
+ *
+ * Returns: (transfer none) (nullable): #FontManagerOrthographyData for @name
+ * or %NULL if @name is not a known orthography
+ */
+const FontManagerOrthographyData *
+font_manager_get_orthography_data (const gchar *name)
+{
+    g_return_val_if_fail(name != NULL, NULL);
+    ensure_orthography_sets();
+    return g_hash_table_lookup(OrthographyNames, name);
+}
+
+/**
+ * font_manager_get_orthography_filter:
+ * @name:   Untranslated name of an orthography
+ *
+ * Returns: (element-type uint) (transfer container) (nullable): #GList containing
+ * every codepoint which is part of the orthography, in the order they are defined,
+ * or %NULL if @name is not a known orthography.
+ * Free the returned #GList using #g_list_free().
+ */
+GList *
+font_manager_get_orthography_filter (const gchar *name)
+{
+    const FontManagerOrthographyData *data = font_manager_get_orthography_data(name);
+    if (data == NULL)
+        return NULL;
+    GList *charlist = NULL;
+    for (int i = 0; data->values[i] != FONT_MANAGER_END_OF_DATA; i++) {
+        if (data->values[i] == FONT_MANAGER_START_RANGE_PAIR) {
+            gunichar start = data->values[++i];
+            gunichar end = data->values[++i];
+            for (gunichar codepoint = start; codepoint <= end; codepoint++)
+                charlist = g_list_prepend(charlist, GINT_TO_POINTER(codepoint));
+        } else {
+            charlist = g_list_prepend(charlist, GINT_TO_POINTER(data->values[i]));
+        }
+    }
+    return g_list_reverse(charlist);
+}
+
+/**
+ * font_manager_get_orthography_entry:
+ * @name:       Untranslated name of an orthography
+ * @coverage:   Coverage for this orthography
+ *
+ * The returned object has the same structure as the members of the object
+ * returned by #font_manager_get_orthography_results(), without the filter member.
+ * Use #font_manager_get_orthography_filter() to retrieve the codepoints.
+ *
+ * Returns: (transfer full) (nullable): #JsonObject or %NULL if @name is not a known orthography
+ */
+JsonObject *
+font_manager_get_orthography_entry (const gchar *name, gdouble coverage)
+{
+    const FontManagerOrthographyData *data = font_manager_get_orthography_data(name);
+    /* Stored for fonts which don't match any known orthography */
+    gboolean uncategorized = (data == NULL && g_strcmp0(name, "Uncategorized") == 0);
+    if (data == NULL && !uncategorized)
+        return NULL;
+    JsonObject *res = json_object_new();
+    json_object_set_string_member(res, "name", name);
+    if (data) {
+        json_object_set_string_member(res, "native", data->native);
+        json_object_set_string_member(res, "sample", data->sample);
+    }
+    json_object_set_double_member(res, "coverage", coverage);
+    return res;
+}
@@ -26,10 +26,16 @@
 #include <pango/pango-language.h>
 
 #include "unicode-info.h"
+#include "font-manager-freetype.h"
 #include "font-manager-orthography.h"
 
+hb_set_t * font_manager_get_charset_from_font_object (JsonObject *font);
+hb_set_t * font_manager_get_charset_from_font_file (FontManagerFontFile *file, gint index);
 JsonObject * font_manager_get_orthography_results (JsonObject *font);
+JsonObject * font_manager_get_orthography_results_for_charset (hb_set_t *charset);
 gchar * font_manager_get_sample_string (JsonObject *font);
+GList * font_manager_get_orthography_filter (const gchar *name);
+JsonObject * font_manager_get_orthography_entry (const gchar *name, gdouble coverage);
 
 #define FONT_MANAGER_START_RANGE_PAIR 0x0002
 #define FONT_MANAGER_END_OF_DATA 0x0000
@@ -54,6 +60,8 @@ typedef struct
 }
 FontManagerOrthographyData;
 
+const FontManagerOrthographyData * font_manager_get_orthography_data (const gchar *name);
+
 static const FontManagerOrthographyData ArabicOrthographies [] = {
 #include "Arabic"
 #include "Farsi"
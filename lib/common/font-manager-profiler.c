@@ -0,0 +1,296 @@
+/* font-manager-profiler.c
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#include "config.h"
+
+#include <unistd.h>
+#include <fontconfig/fontconfig.h>
+#include <sqlite3.h>
+
+#include "font-manager-profiler.h"
+
+/**
+ * SECTION: font-manager-profiler
+ * @title: Profiler
+ * @short_description: Lightweight timing instrumentation
+ * @include: font-manager-profiler.h
+ *
+ * Named spans, counters and per-span duration histograms.
+ *
+ * Nothing is recorded unless the profiler has been enabled, either through
+ * #font_manager_profiler_enable or by setting the FONT_MANAGER_PROFILE
+ * environment variable to the path of the file to write. While disabled,
+ * instrumentation costs a single atomic read.
+ *
+ * Results are written in the Chrome trace event format, which can be opened
+ * in sysprof, Perfetto or chrome://tracing. The histograms and a description
+ * of the system the trace was recorded on are included in the same file so
+ * that runs can be compared over time, i.e.
+ * `FONT_MANAGER_PROFILE=trace.json font-manager --update`.
+ *
+ * |[<!-- language="C" -->
+ * gint64 start = font_manager_profiler_begin();
+ * do_work();
+ * font_manager_profiler_end(start, "Work");
+ * ]|
+ */
+
+#define PROFILE_ENV_VAR "FONT_MANAGER_PROFILE"
+/* Keep memory use bounded during long sessions, histograms are still updated */
+#define MAX_EVENTS (1 << 20)
+/* Durations are bucketed by powers of two, in microseconds */
+#define N_BUCKETS 32
+
+typedef struct
+{
+    const gchar *name;
+    gchar phase;
+    guint tid;
+    gint64 ts;
+    gint64 value;
+}
+TraceEvent;
+
+typedef struct
+{
+    guint64 count;
+    gint64 total;
+    gint64 min;
+    gint64 max;
+    guint64 buckets[N_BUCKETS];
+}
+Histogram;
+
+static gint enabled = 0;
+static gint next_tid = 0;
+static gint64 epoch = 0;
+static gchar *output = NULL;
+static GArray *events = NULL;
+static GHashTable *histograms = NULL;
+static GMutex lock;
+static GPrivate thread_id;
+
+static guint
+get_thread_id (void)
+{
+    guint tid = GPOINTER_TO_UINT(g_private_get(&thread_id));
+    if (tid == 0) {
+        tid = (guint) g_atomic_int_add(&next_tid, 1) + 1;
+        g_private_set(&thread_id, GUINT_TO_POINTER(tid));
+    }
+    return tid;
+}
+
+static void
+record_event (const gchar *name, gchar phase, gint64 ts, gint64 value)
+{
+    TraceEvent event = { g_intern_string(name), phase, get_thread_id(), ts - epoch, value };
+    g_mutex_lock(&lock);
+    if (events->len < MAX_EVENTS)
+        g_array_append_val(events, event);
+    if (phase == 'X') {
+        Histogram *histogram = g_hash_table_lookup(histograms, event.name);
+        if (histogram == NULL) {
+            histogram = g_new0(Histogram, 1);
+            histogram->min = G_MAXINT64;
+            g_hash_table_insert(histograms, (gpointer) event.name, histogram);
+        }
+        histogram->count++;
+        histogram->total += value;
+        histogram->min = MIN(histogram->min, value);
+        histogram->max = MAX(histogram->max, value);
+        histogram->buckets[MIN(g_bit_storage((gulong) MAX(value, 0)), N_BUCKETS - 1)]++;
+    }
+    g_mutex_unlock(&lock);
+    return;
+}
+
+/**
+ * font_manager_profiler_enable:
+ * @filepath: (nullable): file to write results to or %NULL to use
+ * the value of the FONT_MANAGER_PROFILE environment variable, if set
+ *
+ * Start recording. Results are written by #font_manager_profiler_flush.
+ *
+ * Returns: %TRUE if the profiler is enabled
+ */
+gboolean
+font_manager_profiler_enable (const gchar *filepath)
+{
+    if (filepath == NULL)
+        filepath = g_getenv(PROFILE_ENV_VAR);
+    if (filepath == NULL || *filepath == '\0' || font_manager_profiler_is_enabled())
+        return font_manager_profiler_is_enabled();
+    g_mutex_lock(&lock);
+    output = g_strdup(filepath);
+    events = g_array_sized_new(FALSE, FALSE, sizeof(TraceEvent), 4096);
+    histograms = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    epoch = g_get_monotonic_time();
+    g_mutex_unlock(&lock);
+    g_atomic_int_set(&enabled, 1);
+    g_debug("Profiler enabled, writing results to %s", filepath);
+    return TRUE;
+}
+
+/**
+ * font_manager_profiler_is_enabled:
+ *
+ * Returns: %TRUE if the profiler is recording
+ */
+gboolean
+font_manager_profiler_is_enabled (void)
+{
+    return g_atomic_int_get(&enabled);
+}
+
+/**
+ * font_manager_profiler_begin:
+ *
+ * Start a span, pass the returned value to #font_manager_profiler_end.
+ *
+ * Returns: Start time of span or 0 if the profiler is disabled
+ */
+gint64
+font_manager_profiler_begin (void)
+{
+    if (!g_atomic_int_get(&enabled))
+        return 0;
+    return g_get_monotonic_time();
+}
+
+/**
+ * font_manager_profiler_end:
+ * @start:  value returned by #font_manager_profiler_begin
+ * @name:   name of span
+ *
+ * End a span and add its duration to the histogram for @name.
+ */
+void
+font_manager_profiler_end (gint64 start, const gchar *name)
+{
+    if (start == 0 || !g_atomic_int_get(&enabled))
+        return;
+    g_return_if_fail(name != NULL);
+    gint64 now = g_get_monotonic_time();
+    record_event(name, 'X', start, now - start);
+    return;
+}
+
+/**
+ * font_manager_profiler_counter:
+ * @name:   name of counter
+ * @value:  current value
+ *
+ * Record the current value of a counter.
+ */
+void
+font_manager_profiler_counter (const gchar *name, gint64 value)
+{
+    if (!g_atomic_int_get(&enabled))
+        return;
+    g_return_if_fail(name != NULL);
+    record_event(name, 'C', g_get_monotonic_time(), value);
+    return;
+}
+
+static void
+append_escaped (GString *str, const gchar *name)
+{
+    g_autofree gchar *escaped = g_strescape(name, NULL);
+    g_string_append_printf(str, "\"%s\"", escaped);
+    return;
+}
+
+static void
+append_histograms (GString *str)
+{
+    GHashTableIter iter;
+    gpointer key, value;
+    gboolean first = TRUE;
+    g_string_append(str, "\"histograms\":{");
+    g_hash_table_iter_init(&iter, histograms);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        Histogram *histogram = value;
+        if (!first)
+            g_string_append_c(str, ',');
+        first = FALSE;
+        append_escaped(str, key);
+        g_string_append_printf(str, ":{\"count\":%" G_GUINT64_FORMAT ",\"total\":%" G_GINT64_FORMAT
+                               ",\"min\":%" G_GINT64_FORMAT ",\"max\":%" G_GINT64_FORMAT ",\"buckets\":[",
+                               histogram->count, histogram->total, histogram->min, histogram->max);
+        /* Trailing empty buckets are left out */
+        gint last = N_BUCKETS - 1;
+        while (last > 0 && histogram->buckets[last] == 0)
+            last--;
+        for (gint i = 0; i <= last; i++)
+            g_string_append_printf(str, "%s%" G_GUINT64_FORMAT, i > 0 ? "," : "", histogram->buckets[i]);
+        g_string_append(str, "]}");
+    }
+    g_string_append_c(str, '}');
+    return;
+}
+
+/**
+ * font_manager_profiler_flush:
+ * @error: (nullable): #GError or %NULL to ignore errors
+ *
+ * Write everything recorded so far to the file passed to
+ * #font_manager_profiler_enable. Does nothing if the profiler is disabled.
+ *
+ * All times are in microseconds. Histogram bucket n holds spans which
+ * took less than 2^n microseconds.
+ *
+ * Returns: %TRUE on success
+ */
+gboolean
+font_manager_profiler_flush (GError **error)
+{
+    g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+    if (!font_manager_profiler_is_enabled())
+        return TRUE;
+    pid_t pid = getpid();
+    GString *str = g_string_sized_new(4096);
+    g_mutex_lock(&lock);
+    g_string_append(str, "{\"traceEvents\":[");
+    for (guint i = 0; i < events->len; i++) {
+        TraceEvent *event = &g_array_index(events, TraceEvent, i);
+        if (i > 0)
+            g_string_append(str, ",\n");
+        g_string_append(str, "{\"name\":");
+        append_escaped(str, event->name);
+        g_string_append_printf(str, ",\"cat\":\"%s\",\"ph\":\"%c\",\"pid\":%i,\"tid\":%u,\"ts\":%" G_GINT64_FORMAT,
+                               PACKAGE_NAME, event->phase, (gint) pid, event->tid, event->ts);
+        if (event->phase == 'X')
+            g_string_append_printf(str, ",\"dur\":%" G_GINT64_FORMAT "}", event->value);
+        else
+            g_string_append_printf(str, ",\"args\":{\"value\":%" G_GINT64_FORMAT "}}", event->value);
+    }
+    g_string_append(str, "],\n\"displayTimeUnit\":\"ms\",\n");
+    g_string_append_printf(str, "\"otherData\":{\"version\":\"%s\",\"processors\":\"%u\","
+                           "\"fontconfig\":\"%i\",\"sqlite\":\"%s\"},\n",
+                           PACKAGE_VERSION, g_get_num_processors(), FcGetVersion(), sqlite3_libversion());
+    append_histograms(str);
+    g_string_append(str, "}\n");
+    gboolean result = g_file_set_contents(output, str->str, str->len, error);
+    g_mutex_unlock(&lock);
+    g_string_free(str, TRUE);
+    return result;
+}
+
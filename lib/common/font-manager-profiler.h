@@ -0,0 +1,31 @@
+/* font-manager-profiler.h
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#pragma once
+
+#include <glib.h>
+
+gboolean font_manager_profiler_enable (const gchar *filepath);
+gboolean font_manager_profiler_is_enabled (void);
+gint64 font_manager_profiler_begin (void);
+void font_manager_profiler_end (gint64 start, const gchar *name);
+void font_manager_profiler_counter (const gchar *name, gint64 value);
+gboolean font_manager_profiler_flush (GError **error);
+
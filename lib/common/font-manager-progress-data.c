@@ -27,8 +27,18 @@
  * @include: font-manager-progress-data.h
  *
  * #FontManagerProgressData contains data necessary to display progress within the application.
+ *
+ * Long running operations keep a single instance around, update it as work
+ * completes and only hand a copy off for display when
+ * #font_manager_progress_data_ready returns %TRUE. This limits updates to a
+ * fixed rate regardless of how many items are processed.
+ *
+ * Instances are not thread-safe, copies should be passed between threads.
  */
 
+/* Minimum time between reported updates, in microseconds */
+#define PROGRESS_UPDATE_INTERVAL (G_USEC_PER_SEC / 30)
+
 struct _FontManagerProgressData
 {
     GObject parent;
@@ -38,6 +48,9 @@ typedef struct
 {
     guint processed;
     guint total;
+    guint64 bytes;
+    gint64 started;
+    gint64 last_update;
     gchar *message;
 }
 FontManagerProgressDataPrivate;
@@ -51,6 +64,10 @@ enum
     PROP_TOTAL,
     PROP_MESSAGE,
     PROP_PROGRESS,
+    PROP_BYTES,
+    PROP_RATE,
+    PROP_BYTE_RATE,
+    PROP_ETA,
     N_PROPERTIES
 };
 
@@ -67,6 +84,30 @@ font_manager_progress_data_dispose (GObject *gobject)
     return;
 }
 
+static gdouble
+get_elapsed_seconds (FontManagerProgressDataPrivate *priv)
+{
+    return (gdouble) (g_get_monotonic_time() - priv->started) / G_USEC_PER_SEC;
+}
+
+static gdouble
+get_rate (FontManagerProgressDataPrivate *priv, gdouble amount)
+{
+    gdouble elapsed = get_elapsed_seconds(priv);
+    return elapsed > 0.0 ? amount / elapsed : 0.0;
+}
+
+static gdouble
+get_eta (FontManagerProgressDataPrivate *priv)
+{
+    gdouble rate = get_rate(priv, (gdouble) priv->processed);
+    if (rate <= 0.0 || priv->total == 0)
+        return -1.0;
+    if (priv->processed >= priv->total)
+        return 0.0;
+    return (gdouble) (priv->total - priv->processed) / rate;
+}
+
 static void
 font_manager_progress_data_get_property (GObject *gobject,
                                          guint property_id,
@@ -76,7 +117,7 @@ font_manager_progress_data_get_property (GObject *gobject,
     g_return_if_fail(gobject != NULL);
     FontManagerProgressData *self = FONT_MANAGER_PROGRESS_DATA(gobject);
     FontManagerProgressDataPrivate *priv = font_manager_progress_data_get_instance_private(self);
-    gdouble fraction = ((gdouble) priv->processed / (gdouble) priv->total);
+    gdouble fraction = priv->total > 0 ? ((gdouble) priv->processed / (gdouble) priv->total) : 0.0;
     switch (property_id) {
         case PROP_PROCESSED:
             g_value_set_uint(value, priv->processed);
@@ -88,7 +129,19 @@ font_manager_progress_data_get_property (GObject *gobject,
             g_value_set_string(value, priv->message);
             break;
         case PROP_PROGRESS:
-            g_value_set_double(value, fraction);
+            g_value_set_double(value, CLAMP(fraction, 0.0, 1.0));
+            break;
+        case PROP_BYTES:
+            g_value_set_uint64(value, priv->bytes);
+            break;
+        case PROP_RATE:
+            g_value_set_double(value, get_rate(priv, (gdouble) priv->processed));
+            break;
+        case PROP_BYTE_RATE:
+            g_value_set_double(value, get_rate(priv, (gdouble) priv->bytes));
+            break;
+        case PROP_ETA:
+            g_value_set_double(value, get_eta(priv));
             break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
@@ -118,6 +171,9 @@ font_manager_progress_data_set_property (GObject *gobject,
                 g_free(priv->message);
             priv->message = g_value_dup_string(value);
             break;
+        case PROP_BYTES:
+            priv->bytes = g_value_get_uint64(value);
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
             break;
@@ -177,14 +233,151 @@ font_manager_progress_data_class_init (FontManagerProgressDataClass *klass)
                                                         0.0, 1.0, 0.0,
                                                         G_PARAM_READABLE);
 
+    /**
+     * FontManagerProgressData:bytes
+     *
+     * Amount of data processed so far, in bytes
+     */
+    obj_properties[PROP_BYTES] = g_param_spec_uint64("bytes",
+                                                      NULL,
+                                                      "Amount of data processed",
+                                                      0, G_MAXUINT64, 0,
+                                                      G_PARAM_READWRITE);
+
+    /**
+     * FontManagerProgressData:rate
+     *
+     * Average number of items processed per second
+     */
+    obj_properties[PROP_RATE] = g_param_spec_double("rate",
+                                                    NULL,
+                                                    "Items processed per second",
+                                                    0.0, G_MAXDOUBLE, 0.0,
+                                                    G_PARAM_READABLE);
+
+    /**
+     * FontManagerProgressData:byte-rate
+     *
+     * Average number of bytes processed per second
+     */
+    obj_properties[PROP_BYTE_RATE] = g_param_spec_double("byte-rate",
+                                                         NULL,
+                                                         "Bytes processed per second",
+                                                         0.0, G_MAXDOUBLE, 0.0,
+                                                         G_PARAM_READABLE);
+
+    /**
+     * FontManagerProgressData:eta
+     *
+     * Estimated number of seconds remaining or -1 if unknown
+     */
+    obj_properties[PROP_ETA] = g_param_spec_double("eta",
+                                                   NULL,
+                                                   "Estimated seconds remaining",
+                                                   -1.0, G_MAXDOUBLE, -1.0,
+                                                   G_PARAM_READABLE);
+
     g_object_class_install_properties(object_class, N_PROPERTIES, obj_properties);
     return;
 }
 
 static void
-font_manager_progress_data_init (G_GNUC_UNUSED FontManagerProgressData *self)
+font_manager_progress_data_init (FontManagerProgressData *self)
 {
     g_return_if_fail(self != NULL);
+    FontManagerProgressDataPrivate *priv = font_manager_progress_data_get_instance_private(self);
+    priv->started = g_get_monotonic_time();
+    return;
+}
+
+/**
+ * font_manager_progress_data_update:
+ * @self:       #FontManagerProgressData
+ * @message: (nullable): string suitable for display or %NULL to keep the current one
+ * @processed:  amount processed so far
+ * @bytes:      amount of data processed so far, in bytes
+ *
+ * Update progress without emitting any notifications.
+ */
+void
+font_manager_progress_data_update (FontManagerProgressData *self,
+                                   const gchar *message,
+                                   guint processed,
+                                   guint64 bytes)
+{
+    g_return_if_fail(self != NULL);
+    FontManagerProgressDataPrivate *priv = font_manager_progress_data_get_instance_private(self);
+    if (message != NULL && g_strcmp0(message, priv->message) != 0) {
+        g_free(priv->message);
+        priv->message = g_strdup(message);
+    }
+    priv->processed = processed;
+    priv->bytes = bytes;
+    return;
+}
+
+/**
+ * font_manager_progress_data_ready:
+ * @self:   #FontManagerProgressData
+ *
+ * Returns: %TRUE if enough time has passed since the last time this function
+ * returned %TRUE or processing is complete, %FALSE otherwise
+ */
+gboolean
+font_manager_progress_data_ready (FontManagerProgressData *self)
+{
+    g_return_val_if_fail(self != NULL, FALSE);
+    FontManagerProgressDataPrivate *priv = font_manager_progress_data_get_instance_private(self);
+    gint64 now = g_get_monotonic_time();
+    if (priv->processed < priv->total && now - priv->last_update < PROGRESS_UPDATE_INTERVAL)
+        return FALSE;
+    priv->last_update = now;
+    return TRUE;
+}
+
+/**
+ * font_manager_progress_data_copy:
+ * @self:   #FontManagerProgressData
+ *
+ * Returns: (transfer full): A copy of @self which is safe to hand off to another thread.
+ * Free the returned object using #g_object_unref().
+ */
+FontManagerProgressData *
+font_manager_progress_data_copy (FontManagerProgressData *self)
+{
+    g_return_val_if_fail(self != NULL, NULL);
+    FontManagerProgressDataPrivate *priv = font_manager_progress_data_get_instance_private(self);
+    FontManagerProgressData *copy = font_manager_progress_data_new(priv->message,
+                                                                   priv->processed,
+                                                                   priv->total);
+    FontManagerProgressDataPrivate *copy_priv = font_manager_progress_data_get_instance_private(copy);
+    copy_priv->bytes = priv->bytes;
+    copy_priv->started = priv->started;
+    copy_priv->last_update = priv->last_update;
+    return copy;
+}
+
+/**
+ * font_manager_progress_data_dispatch: (skip)
+ * @self:       #FontManagerProgressData
+ * @callback: (nullable): #FontManagerProgressCallback
+ *
+ * Invoke @callback with a copy of @self in the default main context
+ * if #font_manager_progress_data_ready returns %TRUE.
+ */
+void
+font_manager_progress_data_dispatch (FontManagerProgressData *self,
+                                     FontManagerProgressCallback callback)
+{
+    g_return_if_fail(self != NULL);
+    if (!callback || !font_manager_progress_data_ready(self))
+        return;
+    g_main_context_invoke_full(g_main_context_get_thread_default(),
+                               G_PRIORITY_HIGH_IDLE,
+                               (GSourceFunc) callback,
+                               font_manager_progress_data_copy(self),
+                               (GDestroyNotify) g_object_unref);
+    return;
 }
 
 /**
@@ -199,8 +392,8 @@ gboolean
 font_manager_progress_data_print (FontManagerProgressData *self)
 {
     gint width = 72;
-    gdouble progress;
-    g_object_get(self, "progress", &progress, NULL);
+    gdouble progress, rate, eta;
+    g_object_get(self, "progress", &progress, "rate", &rate, "eta", &eta, NULL);
     if (progress < 1.0) {
         gint position = (gint) (((gdouble) width) * progress);
         fprintf(stdout, "\r[");
@@ -213,9 +406,14 @@ font_manager_progress_data_print (FontManagerProgressData *self)
                 fprintf(stdout, " ");
         }
         if (progress >= 0.99)
-            fprintf(stdout, "] %i%% \r", 100);
+            fprintf(stdout, "] %i%%", 100);
         else
-            fprintf(stdout, "] %i%% \r", (gint) (progress * 100.0));
+            fprintf(stdout, "] %i%%", (gint) (progress * 100.0));
+        if (eta >= 0.0) {
+            gint remaining = (gint) eta;
+            fprintf(stdout, " %.1f/s ETA %i:%02i", rate, remaining / 60, remaining % 60);
+        }
+        fprintf(stdout, "  \r");
         fflush(stdout);
     }
     return G_SOURCE_REMOVE;
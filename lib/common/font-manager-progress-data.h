@@ -31,4 +31,12 @@ typedef gboolean (*FontManagerProgressCallback) (FontManagerProgressData *data);
 
 FontManagerProgressData * font_manager_progress_data_new (const gchar *message, guint processed, guint total);
 gboolean font_manager_progress_data_print (FontManagerProgressData *self);
+void font_manager_progress_data_update (FontManagerProgressData *self,
+                                        const gchar *message,
+                                        guint processed,
+                                        guint64 bytes);
+gboolean font_manager_progress_data_ready (FontManagerProgressData *self);
+FontManagerProgressData * font_manager_progress_data_copy (FontManagerProgressData *self);
+void font_manager_progress_data_dispatch (FontManagerProgressData *self,
+                                          FontManagerProgressCallback callback);
 
@@ -29,9 +29,26 @@
  * #FontManagerStringSet provides a convenient way to store and access a set of strings.
  */
 
+/*
+ * Strings are kept in insertion order in a GPtrArray, a GHashTable maps each
+ * string to its position in that array so lookups don't require a scan.
+ *
+ * Removal leaves a hole (NULL) in the array rather than shifting every
+ * following element. The positions of those holes are kept in a small sorted
+ * array so that index based access can skip them, once there are more than
+ * MAX_HOLES the array is compacted by the function that removed the string.
+ *
+ * Only functions which modify the set ever rearrange its storage, so any
+ * number of threads may read from a set as long as none of them modify it.
+ */
+
+#define MAX_HOLES 32
+
 typedef struct
 {
     GPtrArray *strings;
+    GHashTable *positions;
+    GArray *holes;
 }
 FontManagerStringSetPrivate;
 
@@ -58,8 +75,11 @@ font_manager_string_set_dispose (GObject *gobject)
     g_return_if_fail(gobject != NULL);
     FontManagerStringSet *self = FONT_MANAGER_STRING_SET(gobject);
     FontManagerStringSetPrivate *priv = font_manager_string_set_get_instance_private(self);
+    g_clear_pointer(&priv->positions, g_hash_table_destroy);
+    g_clear_pointer(&priv->holes, g_array_unref);
     if (priv->strings)
         g_ptr_array_free(priv->strings, TRUE);
+    priv->strings = NULL;
     G_OBJECT_CLASS(font_manager_string_set_parent_class)->dispose(gobject);
     return;
 }
@@ -126,9 +146,103 @@ font_manager_string_set_init (FontManagerStringSet *self)
     g_return_if_fail(self != NULL);
     FontManagerStringSetPrivate *priv = font_manager_string_set_get_instance_private(self);
     priv->strings = g_ptr_array_new_with_free_func((GDestroyNotify) g_free);
+    /* Keys are owned by strings */
+    priv->positions = g_hash_table_new(g_str_hash, g_str_equal);
+    priv->holes = g_array_new(FALSE, FALSE, sizeof(guint));
+    return;
+}
+
+/* Entries past length have either been moved or freed already */
+static void
+truncate_strings (FontManagerStringSetPrivate *priv, guint length)
+{
+    for (guint i = length; i < priv->strings->len; i++)
+        priv->strings->pdata[i] = NULL;
+    g_ptr_array_set_size(priv->strings, length);
+    return;
+}
+
+/* Must only be called by functions which modify the set */
+static void
+ensure_compact (FontManagerStringSetPrivate *priv)
+{
+    if (priv->holes->len == 0)
+        return;
+    guint n = 0;
+    for (guint i = 0; i < priv->strings->len; i++) {
+        gchar *str = g_ptr_array_index(priv->strings, i);
+        if (str == NULL)
+            continue;
+        priv->strings->pdata[n] = str;
+        g_hash_table_insert(priv->positions, str, GUINT_TO_POINTER(n));
+        n++;
+    }
+    truncate_strings(priv, n);
+    g_array_set_size(priv->holes, 0);
+    return;
+}
+
+static void
+add_hole (FontManagerStringSetPrivate *priv, guint index)
+{
+    guint i = priv->holes->len;
+    while (i > 0 && g_array_index(priv->holes, guint, i - 1) > index)
+        i--;
+    g_array_insert_val(priv->holes, i, index);
     return;
 }
 
+/* Maps an index which ignores holes to a position in strings */
+static guint
+get_position (FontManagerStringSetPrivate *priv, guint index)
+{
+    guint position = index;
+    for (guint i = 0; i < priv->holes->len; i++) {
+        if (g_array_index(priv->holes, guint, i) > position)
+            break;
+        position++;
+    }
+    return position;
+}
+
+static void
+rebuild_positions (FontManagerStringSetPrivate *priv)
+{
+    g_hash_table_remove_all(priv->positions);
+    for (guint i = 0; i < priv->strings->len; i++)
+        g_hash_table_insert(priv->positions, g_ptr_array_index(priv->strings, i), GUINT_TO_POINTER(i));
+    return;
+}
+
+static gboolean
+add_string (FontManagerStringSetPrivate *priv, const gchar *str)
+{
+    if (g_hash_table_contains(priv->positions, str))
+        return FALSE;
+    gchar *entry = g_strdup(str);
+    g_hash_table_insert(priv->positions, entry, GUINT_TO_POINTER(priv->strings->len));
+    g_ptr_array_add(priv->strings, entry);
+    return TRUE;
+}
+
+static gboolean
+remove_string (FontManagerStringSetPrivate *priv, const gchar *str)
+{
+    gpointer position;
+    if (!g_hash_table_lookup_extended(priv->positions, str, NULL, &position))
+        return FALSE;
+    guint index = GPOINTER_TO_UINT(position);
+    g_hash_table_remove(priv->positions, str);
+    if (index == priv->strings->len - 1) {
+        g_ptr_array_remove_index(priv->strings, index);
+    } else {
+        g_free(g_ptr_array_index(priv->strings, index));
+        priv->strings->pdata[index] = NULL;
+        add_hole(priv, index);
+    }
+    return TRUE;
+}
+
 /**
  * font_manager_string_set_add:
  * @self:   #FontManagerStringSet
@@ -140,8 +254,7 @@ font_manager_string_set_add (FontManagerStringSet *self, const gchar *str)
     g_return_if_fail(self != NULL);
     g_return_if_fail(str != NULL);
     FontManagerStringSetPrivate *priv = font_manager_string_set_get_instance_private(self);
-    if (!font_manager_string_set_contains(self, str))
-        g_ptr_array_add(priv->strings, g_strdup(str));
+    add_string(priv, str);
     g_signal_emit(self, signals[CHANGED], 0);
     return;
 }
@@ -150,16 +263,46 @@ font_manager_string_set_add (FontManagerStringSet *self, const gchar *str)
  * font_manager_string_set_add_all:
  * @self:                   #FontManagerStringSet
  * @add: (transfer none):   #FontManagerStringSet to add to @self
+ *
+ * #FontManagerStringSet::changed is emitted once, if any strings were added.
  */
 void
 font_manager_string_set_add_all (FontManagerStringSet *self, FontManagerStringSet *add)
 {
     g_return_if_fail(self != NULL);
-    g_object_freeze_notify(G_OBJECT(self));
-    guint n_strings = font_manager_string_set_size(add);
-    for (guint i = 0; i < n_strings; i++)
-        font_manager_string_set_add(self, font_manager_string_set_get(add, i));
-    g_object_thaw_notify(G_OBJECT(self));
+    g_return_if_fail(add != NULL);
+    FontManagerStringSetPrivate *priv = font_manager_string_set_get_instance_private(self);
+    FontManagerStringSetPrivate *other = font_manager_string_set_get_instance_private(add);
+    gboolean changed = FALSE;
+    for (guint i = 0; i < other->strings->len; i++) {
+        const gchar *str = g_ptr_array_index(other->strings, i);
+        if (str != NULL)
+            changed |= add_string(priv, str);
+    }
+    if (changed)
+        g_signal_emit(self, signals[CHANGED], 0);
+    return;
+}
+
+/**
+ * font_manager_string_set_add_strv:
+ * @self:   #FontManagerStringSet
+ * @strv: (array zero-terminated=1) (element-type utf8) (transfer none):
+ * %NULL terminated array of strings to add to @self
+ *
+ * #FontManagerStringSet::changed is emitted once, if any strings were added.
+ */
+void
+font_manager_string_set_add_strv (FontManagerStringSet *self, GStrv strv)
+{
+    g_return_if_fail(self != NULL);
+    g_return_if_fail(strv != NULL);
+    FontManagerStringSetPrivate *priv = font_manager_string_set_get_instance_private(self);
+    gboolean changed = FALSE;
+    for (gint i = 0; strv[i] != NULL; i++)
+        changed |= add_string(priv, strv[i]);
+    if (changed)
+        g_signal_emit(self, signals[CHANGED], 0);
     return;
 }
 
@@ -173,10 +316,10 @@ font_manager_string_set_add_all (FontManagerStringSet *self, FontManagerStringSe
 gboolean
 font_manager_string_set_contains (FontManagerStringSet *self, const gchar *str)
 {
-    if (!self || !str || font_manager_string_set_size(self) < 1)
+    if (!self || !str)
         return FALSE;
     FontManagerStringSetPrivate *priv = font_manager_string_set_get_instance_private(self);
-    return g_ptr_array_find_with_equal_func(priv->strings, str, (GEqualFunc) g_str_equal, NULL);
+    return g_hash_table_contains(priv->positions, str);
 }
 
 /**
@@ -190,9 +333,16 @@ gboolean
 font_manager_string_set_contains_all (FontManagerStringSet *self, FontManagerStringSet *contents)
 {
     g_return_val_if_fail(self != NULL, FALSE);
-    guint n_strings = font_manager_string_set_size(contents);
-    for (guint i = 0; i < n_strings; i++)
-        if (!font_manager_string_set_contains(self, font_manager_string_set_get(contents, i)))
+    g_return_val_if_fail(contents != NULL, FALSE);
+    FontManagerStringSetPrivate *priv = font_manager_string_set_get_instance_private(self);
+    FontManagerStringSetPrivate *other = font_manager_string_set_get_instance_private(contents);
+    if (font_manager_string_set_size(contents) > font_manager_string_set_size(self))
+        return FALSE;
+    GHashTableIter iter;
+    gpointer str;
+    g_hash_table_iter_init(&iter, other->positions);
+    while (g_hash_table_iter_next(&iter, &str, NULL))
+        if (!g_hash_table_contains(priv->positions, str))
             return FALSE;
     return TRUE;
 }
@@ -207,9 +357,8 @@ font_manager_string_set_remove (FontManagerStringSet *self, const gchar *str)
 {
     g_return_if_fail(self != NULL);
     FontManagerStringSetPrivate *priv = font_manager_string_set_get_instance_private(self);
-    guint index;
-    if (g_ptr_array_find_with_equal_func(priv->strings, str, (GEqualFunc) g_str_equal, &index))
-        g_ptr_array_remove_index(priv->strings, index);
+    if (str != NULL && remove_string(priv, str) && priv->holes->len > MAX_HOLES)
+        ensure_compact(priv);
     g_signal_emit(self, signals[CHANGED], 0);
     return;
 }
@@ -218,16 +367,33 @@ font_manager_string_set_remove (FontManagerStringSet *self, const gchar *str)
  * font_manager_string_set_remove_all:
  * @self:                       #FontManagerStringSet
  * @remove: (transfer none):    #FontManagerStringSet containing strings to remove
+ *
+ * #FontManagerStringSet::changed is emitted once, if any strings were removed.
  */
 void
 font_manager_string_set_remove_all (FontManagerStringSet *self, FontManagerStringSet *remove)
 {
     g_return_if_fail(self != NULL);
-    g_object_freeze_notify(G_OBJECT(self));
-    guint n_strings = font_manager_string_set_size(remove);
-    for (guint i = 0; i < n_strings; i++)
-        font_manager_string_set_remove(self, font_manager_string_set_get(remove, i));
-    g_object_thaw_notify(G_OBJECT(self));
+    g_return_if_fail(remove != NULL);
+    FontManagerStringSetPrivate *priv = font_manager_string_set_get_instance_private(self);
+    FontManagerStringSetPrivate *other = font_manager_string_set_get_instance_private(remove);
+    gboolean changed = FALSE;
+    if (self == remove) {
+        changed = priv->strings->len > 0;
+        g_hash_table_remove_all(priv->positions);
+        g_ptr_array_set_size(priv->strings, 0);
+        g_array_set_size(priv->holes, 0);
+    } else {
+        for (guint i = 0; i < other->strings->len; i++) {
+            const gchar *str = g_ptr_array_index(other->strings, i);
+            if (str != NULL)
+                changed |= remove_string(priv, str);
+        }
+        if (priv->holes->len > MAX_HOLES)
+            ensure_compact(priv);
+    }
+    if (changed)
+        g_signal_emit(self, signals[CHANGED], 0);
     return;
 }
 
@@ -242,17 +408,20 @@ void
 font_manager_string_set_retain_all (FontManagerStringSet *self, FontManagerStringSet *retain)
 {
     g_return_if_fail(self != NULL);
+    g_return_if_fail(retain != NULL);
     FontManagerStringSetPrivate *priv = font_manager_string_set_get_instance_private(self);
-    GPtrArray *tmp = g_ptr_array_new_with_free_func((GDestroyNotify) g_free);
-    guint n_strings = font_manager_string_set_size(retain);
-    for (guint i = 0; i < n_strings; i++) {
-        guint index;
-        const gchar *entry = font_manager_string_set_get(retain, i);
-        if (g_ptr_array_find_with_equal_func(priv->strings, entry, (GEqualFunc) g_str_equal, &index))
-            g_ptr_array_add(tmp, g_ptr_array_steal_index_fast(priv->strings, index));
+    FontManagerStringSetPrivate *other = font_manager_string_set_get_instance_private(retain);
+    ensure_compact(priv);
+    guint n = 0;
+    for (guint i = 0; i < priv->strings->len; i++) {
+        gchar *str = g_ptr_array_index(priv->strings, i);
+        if (g_hash_table_contains(other->positions, str))
+            priv->strings->pdata[n++] = str;
+        else
+            g_free(str);
     }
-    g_ptr_array_free(priv->strings, TRUE);
-    priv->strings = tmp;
+    truncate_strings(priv, n);
+    rebuild_positions(priv);
     g_signal_emit(self, signals[CHANGED], 0);
     return;
 }
@@ -268,7 +437,7 @@ font_manager_string_set_size (FontManagerStringSet *self)
 {
     g_return_val_if_fail(self != NULL, 0);
     FontManagerStringSetPrivate *priv = font_manager_string_set_get_instance_private(self);
-    return priv->strings->len;
+    return priv->strings->len - priv->holes->len;
 }
 
 /**
@@ -285,8 +454,11 @@ font_manager_string_set_list (FontManagerStringSet *self)
     g_return_val_if_fail(self != NULL, NULL);
     FontManagerStringSetPrivate *priv = font_manager_string_set_get_instance_private(self);
     GList *result = NULL;
-    for (guint i = 0; i < priv->strings->len; i++)
-        result = g_list_prepend(result, g_strdup(g_ptr_array_index(priv->strings, i)));
+    for (guint i = 0; i < priv->strings->len; i++) {
+        const gchar *str = g_ptr_array_index(priv->strings, i);
+        if (str != NULL)
+            result = g_list_prepend(result, g_strdup(str));
+    }
     result = g_list_reverse(result);
     return result;
 }
@@ -305,7 +477,11 @@ font_manager_string_set_foreach(FontManagerStringSet *self, GFunc func, gpointer
 {
     g_return_if_fail(self != NULL);
     FontManagerStringSetPrivate *priv = font_manager_string_set_get_instance_private(self);
-    g_ptr_array_foreach(priv->strings, func, user_data);
+    for (guint i = 0; i < priv->strings->len; i++) {
+        gpointer str = g_ptr_array_index(priv->strings, i);
+        if (str != NULL)
+            func(str, user_data);
+    }
     return;
 }
 
@@ -320,7 +496,9 @@ font_manager_string_set_clear (FontManagerStringSet *self)
 {
     g_return_if_fail(self != NULL);
     FontManagerStringSetPrivate *priv = font_manager_string_set_get_instance_private(self);
-    g_ptr_array_remove_range(priv->strings, 0, priv->strings->len);
+    g_hash_table_remove_all(priv->positions);
+    g_ptr_array_set_size(priv->strings, 0);
+    g_array_set_size(priv->holes, 0);
     g_signal_emit(self, signals[CHANGED], 0);
     return;
 }
@@ -345,7 +523,9 @@ font_manager_string_set_sort(FontManagerStringSet *self)
 {
     g_return_if_fail(self != NULL);
     FontManagerStringSetPrivate *priv = font_manager_string_set_get_instance_private(self);
+    ensure_compact(priv);
     g_ptr_array_sort_values(priv->strings, compare_func);
+    rebuild_positions(priv);
     return;
 }
 
@@ -362,8 +542,8 @@ font_manager_string_set_get (FontManagerStringSet *self, guint index)
 {
     g_return_val_if_fail(self != NULL, NULL);
     FontManagerStringSetPrivate *priv = font_manager_string_set_get_instance_private(self);
-    g_return_val_if_fail(index >= 0 && index < priv->strings->len, NULL);
-    return g_ptr_array_index(priv->strings, index);
+    g_return_val_if_fail(index < font_manager_string_set_size(self), NULL);
+    return g_ptr_array_index(priv->strings, get_position(priv, index));
 }
 
 static void
@@ -412,8 +592,7 @@ FontManagerStringSet *
 font_manager_string_set_new_from_strv (GStrv strv)
 {
     FontManagerStringSet *set = font_manager_string_set_new();
-    for (int i = 0; strv[i] != NULL; i++)
-        font_manager_string_set_add(set, strv[i]);
+    font_manager_string_set_add_strv(set, strv);
     return set;
 }
 
@@ -39,6 +39,7 @@ guint font_manager_string_set_size (FontManagerStringSet *self);
 const gchar * font_manager_string_set_get (FontManagerStringSet *self, guint index);
 void font_manager_string_set_add (FontManagerStringSet *self, const gchar *str);
 void font_manager_string_set_add_all (FontManagerStringSet *self, FontManagerStringSet *add);
+void font_manager_string_set_add_strv (FontManagerStringSet *self, GStrv strv);
 gboolean font_manager_string_set_contains (FontManagerStringSet *self, const gchar *str);
 gboolean font_manager_string_set_contains_all (FontManagerStringSet *self, FontManagerStringSet *contents);
 void font_manager_string_set_remove (FontManagerStringSet *self, const gchar *str);
@@ -503,3 +503,66 @@ font_manager_free_gsettings () {
     return;
 }
 
+typedef struct
+{
+    guint start;
+    guint end;
+}
+IndexRange;
+
+typedef struct
+{
+    FontManagerRangeFunc func;
+    gpointer user_data;
+}
+ParallelFor;
+
+static void
+run_range (IndexRange *range, ParallelFor *context)
+{
+    context->func(range->start, range->end, context->user_data);
+    return;
+}
+
+/**
+ * font_manager_parallel_for: (skip)
+ * @n_items:    number of items to process
+ * @chunk_size: number of items processed by each call to @func
+ * @func:       #FontManagerRangeFunc
+ * @user_data:  user data to pass to @func
+ *
+ * Splits @n_items into ranges of @chunk_size items and processes them
+ * using a pool of threads. Does not return until every range has been
+ * processed. Ranges never overlap, @func must be safe to call from
+ * multiple threads at once for different ranges.
+ */
+void
+font_manager_parallel_for (guint n_items,
+                           guint chunk_size,
+                           FontManagerRangeFunc func,
+                           gpointer user_data)
+{
+    g_return_if_fail(func != NULL);
+    g_return_if_fail(chunk_size > 0);
+    guint n_threads = g_get_num_processors();
+    if (n_threads < 2 || n_items <= chunk_size) {
+        func(0, n_items, user_data);
+        return;
+    }
+    guint n_ranges = (n_items + chunk_size - 1) / chunk_size;
+    g_autofree IndexRange *ranges = g_new(IndexRange, n_ranges);
+    ParallelFor context = { func, user_data };
+    GThreadPool *pool = g_thread_pool_new((GFunc) run_range,
+                                          &context,
+                                          MIN(n_threads, n_ranges),
+                                          FALSE,
+                                          NULL);
+    for (guint i = 0; i < n_ranges; i++) {
+        ranges[i].start = i * chunk_size;
+        ranges[i].end = MIN(n_items, ranges[i].start + chunk_size);
+        g_thread_pool_push(pool, &ranges[i], NULL);
+    }
+    /* Waits for every queued range to be processed */
+    g_thread_pool_free(pool, FALSE, TRUE);
+    return;
+}
@@ -40,6 +40,7 @@
 #include <sqlite3.h>
 
 #include "font-manager-freetype.h"
+#include "font-manager-profiler.h"
 #include "font-manager-string-set.h"
 
 #define FONT_MANAGER_TMP_TMPL "font-manager_XXXXXX"
@@ -61,6 +62,14 @@ typedef struct _ObjectProperty
 }
 FontManagerObjectProperty;
 
+/**
+ * FontManagerRangeFunc:
+ * @start:      first index in range
+ * @end:        index following the last index in range
+ * @user_data:  user data passed to #font_manager_parallel_for
+ */
+typedef void (*FontManagerRangeFunc) (guint start, guint end, gpointer user_data);
+
 void font_manager_setup_i18n (void);
 void font_manager_print_os_info (void);
 void font_manager_print_library_versions (void);
@@ -81,4 +90,8 @@ gchar * font_manager_to_filename (const gchar *str) G_GNUC_PURE;
 GSettings * font_manager_get_gsettings (const gchar *schema_id);
 void font_manager_free_gsettings ();
 FontManagerStringSet * font_manager_get_command_line_files (GApplicationCommandLine *cmdline);
+void font_manager_parallel_for (guint n_items,
+                                guint chunk_size,
+                                FontManagerRangeFunc func,
+                                gpointer user_data);
 
@@ -0,0 +1,1052 @@
+/* font-manager-font-table.c
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#include "font-manager-font-table.h"
+#include "font-manager-fontconfig.h"
+
+/**
+ * SECTION: font-manager-font-table
+ * @short_description: Compact listing of available fonts
+ * @title: Font Table
+ * @include: font-manager-font-table.h
+ * @see_also: #font_manager_get_available_font_table
+ *
+ * #FontManagerFontTable holds the same information as the listing returned by
+ * #font_manager_sort_json_font_listing without allocating an object per font.
+ *
+ * Faces are identified by their position in the table. Once sorted, the faces
+ * belonging to a family are stored contiguously, ordered the same way as the
+ * variations in a JSON listing, and families are sorted by name.
+ *
+ * Face and family ids remain valid for the lifetime of the table.
+ *
+ * A sorted table can be saved to disk using #font_manager_font_table_save
+ * and loaded again using #font_manager_font_table_load, which is much faster
+ * than querying Fontconfig.
+ */
+
+/*
+ * Each attribute is stored in its own array, indexed by face or family id.
+ * Strings are interned in a single GStringChunk so that values shared by
+ * many faces, such as filepaths of collections or family names, are only
+ * stored once.
+ *
+ * While building the table, each family also owns a hash table mapping its
+ * styles to face ids. These are used to replace duplicate entries, the same
+ * way a JSON listing would, and are dropped once the table is sorted.
+ *
+ * Saved tables consist of a SnapshotHeader followed by the family columns,
+ * the face columns and finally every string, each terminated by a nul byte.
+ * String columns are stored as offsets into that last section. When a table
+ * is loaded the file stays mapped and strings point directly into it.
+ */
+
+struct _FontManagerFontTable
+{
+    GObject parent;
+
+    GStringChunk *strings;
+
+    /* Per face */
+    GArray *face_family;
+    GArray *filepath;
+    GArray *style;
+    GArray *description;
+    GArray *findex;
+    GArray *weight;
+    GArray *slant;
+    GArray *width;
+    GArray *spacing;
+
+    /* Per family */
+    GArray *family_name;
+    GArray *first_face;
+    GArray *n_variations;
+    GArray *default_face;
+
+    GHashTable *families;
+    GPtrArray *styles;
+
+    GMappedFile *snapshot;
+};
+
+#define SNAPSHOT_MAGIC "FMFT"
+#define SNAPSHOT_VERSION 1
+
+typedef struct
+{
+    gchar magic[4];
+    guint32 version;
+    guint32 n_families;
+    guint32 n_faces;
+    guint32 strings_size;
+    /* Offset of the stamp passed to font_manager_font_table_save */
+    guint32 stamp;
+}
+SnapshotHeader;
+
+G_DEFINE_TYPE(FontManagerFontTable, font_manager_font_table, G_TYPE_OBJECT)
+
+#define COLUMN(a, t, i) g_array_index((a), t, (i))
+#define GET_FAMILY_ID(p) (GPOINTER_TO_UINT(p) - 1)
+#define SET_FAMILY_ID(i) (GUINT_TO_POINTER((i) + 1))
+
+static void
+font_manager_font_table_finalize (GObject *gobject)
+{
+    g_return_if_fail(gobject != NULL);
+    FontManagerFontTable *self = FONT_MANAGER_FONT_TABLE(gobject);
+    g_clear_pointer(&self->face_family, g_array_unref);
+    g_clear_pointer(&self->filepath, g_array_unref);
+    g_clear_pointer(&self->style, g_array_unref);
+    g_clear_pointer(&self->description, g_array_unref);
+    g_clear_pointer(&self->findex, g_array_unref);
+    g_clear_pointer(&self->weight, g_array_unref);
+    g_clear_pointer(&self->slant, g_array_unref);
+    g_clear_pointer(&self->width, g_array_unref);
+    g_clear_pointer(&self->spacing, g_array_unref);
+    g_clear_pointer(&self->family_name, g_array_unref);
+    g_clear_pointer(&self->first_face, g_array_unref);
+    g_clear_pointer(&self->n_variations, g_array_unref);
+    g_clear_pointer(&self->default_face, g_array_unref);
+    g_clear_pointer(&self->families, g_hash_table_destroy);
+    g_clear_pointer(&self->styles, g_ptr_array_unref);
+    g_clear_pointer(&self->strings, g_string_chunk_free);
+    g_clear_pointer(&self->snapshot, g_mapped_file_unref);
+    G_OBJECT_CLASS(font_manager_font_table_parent_class)->finalize(gobject);
+    return;
+}
+
+static void
+font_manager_font_table_class_init (FontManagerFontTableClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    object_class->finalize = font_manager_font_table_finalize;
+    return;
+}
+
+static void
+font_manager_font_table_init (FontManagerFontTable *self)
+{
+    g_return_if_fail(self != NULL);
+    self->strings = g_string_chunk_new(4096);
+    self->face_family = g_array_new(FALSE, FALSE, sizeof(guint));
+    self->filepath = g_array_new(FALSE, FALSE, sizeof(const gchar *));
+    self->style = g_array_new(FALSE, FALSE, sizeof(const gchar *));
+    self->description = g_array_new(FALSE, FALSE, sizeof(const gchar *));
+    self->findex = g_array_new(FALSE, FALSE, sizeof(gint));
+    self->weight = g_array_new(FALSE, FALSE, sizeof(gint16));
+    self->slant = g_array_new(FALSE, FALSE, sizeof(gint16));
+    self->width = g_array_new(FALSE, FALSE, sizeof(gint16));
+    self->spacing = g_array_new(FALSE, FALSE, sizeof(gint16));
+    self->family_name = g_array_new(FALSE, FALSE, sizeof(const gchar *));
+    self->first_face = g_array_new(FALSE, FALSE, sizeof(guint));
+    self->n_variations = g_array_new(FALSE, FALSE, sizeof(guint));
+    self->default_face = g_array_new(FALSE, FALSE, sizeof(guint));
+    self->families = g_hash_table_new(g_str_hash, g_str_equal);
+    self->styles = g_ptr_array_new_with_free_func((GDestroyNotify) g_hash_table_destroy);
+    return;
+}
+
+static const gchar *
+intern (FontManagerFontTable *self, const gchar *str)
+{
+    return g_string_chunk_insert_const(self->strings, str);
+}
+
+static guint
+get_family_id (FontManagerFontTable *self, const gchar *family)
+{
+    gpointer id = g_hash_table_lookup(self->families, family);
+    if (id)
+        return GET_FAMILY_ID(id);
+    guint family_id = self->family_name->len;
+    const gchar *name = intern(self, family);
+    g_array_append_val(self->family_name, name);
+    g_hash_table_insert(self->families, (gpointer) name, SET_FAMILY_ID(family_id));
+    /* Interned strings can be compared directly */
+    g_ptr_array_add(self->styles, g_hash_table_new(g_direct_hash, g_direct_equal));
+    return family_id;
+}
+
+/**
+ * font_manager_font_table_new:
+ *
+ * Returns: (transfer full): A newly created, empty #FontManagerFontTable.
+ * Free the returned object using #g_object_unref().
+ */
+FontManagerFontTable *
+font_manager_font_table_new (void)
+{
+    return g_object_new(FONT_MANAGER_TYPE_FONT_TABLE, NULL);
+}
+
+/**
+ * font_manager_font_table_add_pattern: (skip)
+ * @self:       #FontManagerFontTable
+ * @pattern:    #FcPattern to add
+ *
+ * Adds the font described by @pattern to @self.
+ * See #font_manager_get_attributes_from_fontconfig_pattern for the
+ * information @pattern is expected to contain.
+ *
+ * If @self already contains a font with the same family and style,
+ * that entry is replaced.
+ *
+ * Call #font_manager_font_table_sort once all fonts have been added.
+ */
+void
+font_manager_font_table_add_pattern (FontManagerFontTable *self, FcPattern *pattern)
+{
+    g_return_if_fail(self != NULL);
+    g_return_if_fail(self->styles != NULL);
+    g_return_if_fail(pattern != NULL);
+
+    int index;
+    int slant;
+    int weight;
+    int width;
+    int spacing;
+    FcChar8 *file;
+    FcChar8 *family;
+    FcChar8 *style;
+
+    /* These should never fail. If they do, we're screwed */
+    g_assert(FcPatternGetString(pattern, FC_FILE, 0, &file) == FcResultMatch);
+    g_assert(FcPatternGetString(pattern, FC_FAMILY, 0, &family) == FcResultMatch);
+
+    /* If any of these fail, just set a sane default and continue on */
+    if (FcPatternGetInteger(pattern, FC_INDEX, 0, &index) != FcResultMatch)
+        index = 0;
+    if (FcPatternGetInteger(pattern, FC_SPACING, 0, &spacing) != FcResultMatch)
+        spacing = FC_PROPORTIONAL;
+    if (FcPatternGetInteger(pattern, FC_SLANT, 0, &slant) != FcResultMatch)
+        slant = FC_SLANT_ROMAN;
+    if (FcPatternGetInteger(pattern, FC_WEIGHT, 0, &weight) != FcResultMatch)
+        weight = FC_WEIGHT_MEDIUM;
+    if (FcPatternGetInteger(pattern, FC_WIDTH, 0, &width) != FcResultMatch)
+        width = FC_WIDTH_NORMAL;
+
+    const gchar *_style = NULL;
+    if (FcPatternGetString (pattern, FC_STYLE, 0, &style) == FcResultMatch)
+        _style = intern(self, (const gchar *) style);
+    else
+        _style = intern(self, font_manager_get_fallback_style(weight, slant));
+
+    PangoFontDescription *descr = pango_fc_font_description_from_pattern(pattern, FALSE);
+    g_autofree gchar *font_desc = pango_font_description_to_string(descr);
+    pango_font_description_free(descr);
+
+    guint family_id = get_family_id(self, (const gchar *) family);
+    const gchar *filepath = intern(self, (const gchar *) file);
+    const gchar *description = intern(self, font_desc);
+    gint16 _weight = (gint16) weight, _slant = (gint16) slant;
+    gint16 _width = (gint16) width, _spacing = (gint16) spacing;
+
+    GHashTable *styles = g_ptr_array_index(self->styles, family_id);
+    gpointer existing = g_hash_table_lookup(styles, _style);
+    if (existing) {
+        guint face = GPOINTER_TO_UINT(existing) - 1;
+        COLUMN(self->filepath, const gchar *, face) = filepath;
+        COLUMN(self->description, const gchar *, face) = description;
+        COLUMN(self->findex, gint, face) = index;
+        COLUMN(self->weight, gint16, face) = _weight;
+        COLUMN(self->slant, gint16, face) = _slant;
+        COLUMN(self->width, gint16, face) = _width;
+        COLUMN(self->spacing, gint16, face) = _spacing;
+        return;
+    }
+
+    guint face = self->face_family->len;
+    g_array_append_val(self->face_family, family_id);
+    g_array_append_val(self->filepath, filepath);
+    g_array_append_val(self->style, _style);
+    g_array_append_val(self->description, description);
+    g_array_append_val(self->findex, index);
+    g_array_append_val(self->weight, _weight);
+    g_array_append_val(self->slant, _slant);
+    g_array_append_val(self->width, _width);
+    g_array_append_val(self->spacing, _spacing);
+    g_hash_table_insert(styles, (gpointer) _style, GUINT_TO_POINTER(face + 1));
+    return;
+}
+
+#define SORT_CHUNK_SIZE 256
+
+typedef struct
+{
+    guint id;
+    guint64 style;
+    gchar *key;
+}
+SortEntry;
+
+typedef struct
+{
+    FontManagerFontTable *table;
+    GArray *families;
+    /* Faces belonging to each family, in the order they were added */
+    GArray **faces;
+}
+SortContext;
+
+static void
+sort_entry_clear (SortEntry *entry)
+{
+    g_clear_pointer(&entry->key, g_free);
+    return;
+}
+
+/* Same order as font_manager_compare_json_font_node for faces */
+static gint
+compare_sort_entry (const SortEntry *a, const SortEntry *b)
+{
+    if (a->style != b->style)
+        return a->style < b->style ? -1 : 1;
+    return g_strcmp0(a->key, b->key);
+}
+
+/* Generates sort keys for a range of families and sorts their faces.
+ * Only reads from the table, safe to run for different ranges at once. */
+static void
+prepare_sort_entries (guint start, guint end, SortContext *context)
+{
+    FontManagerFontTable *self = context->table;
+    for (guint i = start; i < end; i++) {
+        SortEntry *family = &g_array_index(context->families, SortEntry, i);
+        family->key = g_utf8_collate_key_for_filename(COLUMN(self->family_name, const gchar *, i), -1);
+        GArray *faces = context->faces[i];
+        for (guint f = 0; f < faces->len; f++) {
+            SortEntry *entry = &g_array_index(faces, SortEntry, f);
+            guint face = entry->id;
+            entry->style = FONT_MANAGER_STYLE_SORT_KEY(COLUMN(self->width, gint16, face),
+                                                       COLUMN(self->weight, gint16, face),
+                                                       COLUMN(self->slant, gint16, face));
+            entry->key = g_utf8_collate_key_for_filename(COLUMN(self->style, const gchar *, face), -1);
+        }
+        g_array_sort(faces, (GCompareFunc) compare_sort_entry);
+    }
+    return;
+}
+
+static GArray *
+reorder (GArray *column, const guint *order, guint n)
+{
+    guint size = g_array_get_element_size(column);
+    GArray *result = g_array_sized_new(FALSE, FALSE, size, n);
+    for (guint i = 0; i < n; i++)
+        g_array_append_vals(result, column->data + (gsize) order[i] * size, 1);
+    g_array_unref(column);
+    return result;
+}
+
+/**
+ * font_manager_font_table_sort: (skip)
+ * @self:       #FontManagerFontTable
+ *
+ * Sorts families by name and groups the faces belonging to each family.
+ * No more fonts can be added to @self once it has been sorted.
+ */
+void
+font_manager_font_table_sort (FontManagerFontTable *self)
+{
+    g_return_if_fail(self != NULL);
+    g_return_if_fail(self->styles != NULL);
+
+    gint64 span = font_manager_profiler_begin();
+    guint n_families = self->family_name->len;
+    guint n_faces = self->face_family->len;
+
+    /* Collation keys are generated once per string rather than per comparison */
+    g_autoptr(GArray) families = g_array_sized_new(FALSE, TRUE, sizeof(SortEntry), n_families);
+    g_array_set_clear_func(families, (GDestroyNotify) sort_entry_clear);
+    g_array_set_size(families, n_families);
+    g_autofree GArray **faces = g_new(GArray *, n_families);
+    for (guint i = 0; i < n_families; i++) {
+        g_array_index(families, SortEntry, i).id = i;
+        faces[i] = g_array_new(FALSE, TRUE, sizeof(SortEntry));
+        g_array_set_clear_func(faces[i], (GDestroyNotify) sort_entry_clear);
+    }
+    for (guint face = 0; face < n_faces; face++) {
+        SortEntry entry = { face, 0, NULL };
+        g_array_append_val(faces[COLUMN(self->face_family, guint, face)], entry);
+    }
+    SortContext context = { self, families, faces };
+    font_manager_parallel_for(n_families, SORT_CHUNK_SIZE, (FontManagerRangeFunc) prepare_sort_entries, &context);
+    g_array_sort(families, (GCompareFunc) compare_sort_entry);
+
+    g_autofree guint *face_order = g_new(guint, n_faces);
+    g_autofree guint *family_order = g_new(guint, n_families);
+    g_autoptr(GArray) face_family = g_array_sized_new(FALSE, FALSE, sizeof(guint), n_faces);
+    GArray *first_face = g_array_sized_new(FALSE, FALSE, sizeof(guint), n_families);
+    GArray *n_variations = g_array_sized_new(FALSE, FALSE, sizeof(guint), n_families);
+    GArray *default_face = g_array_sized_new(FALSE, FALSE, sizeof(guint), n_families);
+    guint position = 0;
+
+    for (guint i = 0; i < n_families; i++) {
+        guint family = g_array_index(families, SortEntry, i).id;
+        GArray *sorted = faces[family];
+        family_order[i] = family;
+        guint first = position, _default = position;
+        /* Try to find "default" variation for this family */
+        gboolean have_default = FALSE;
+        for (guint f = 0; f < sorted->len; f++) {
+            guint face = g_array_index(sorted, SortEntry, f).id;
+            face_order[position] = face;
+            g_array_append_val(face_family, i);
+            if (!have_default && font_manager_is_default_variant(COLUMN(self->style, const gchar *, face))) {
+                _default = position;
+                have_default = TRUE;
+            }
+            position++;
+        }
+        guint n = sorted->len;
+        g_array_append_val(first_face, first);
+        g_array_append_val(n_variations, n);
+        /* No suitable "default" found for this family, first face is used */
+        g_array_append_val(default_face, _default);
+    }
+
+    for (guint i = 0; i < n_families; i++)
+        g_array_unref(faces[i]);
+
+    g_assert(position == n_faces);
+    self->filepath = reorder(self->filepath, face_order, n_faces);
+    self->style = reorder(self->style, face_order, n_faces);
+    self->description = reorder(self->description, face_order, n_faces);
+    self->findex = reorder(self->findex, face_order, n_faces);
+    self->weight = reorder(self->weight, face_order, n_faces);
+    self->slant = reorder(self->slant, face_order, n_faces);
+    self->width = reorder(self->width, face_order, n_faces);
+    self->spacing = reorder(self->spacing, face_order, n_faces);
+    self->family_name = reorder(self->family_name, family_order, n_families);
+    g_array_unref(self->face_family);
+    self->face_family = g_steal_pointer(&face_family);
+    g_array_unref(self->first_face);
+    g_array_unref(self->n_variations);
+    g_array_unref(self->default_face);
+    self->first_face = first_face;
+    self->n_variations = n_variations;
+    self->default_face = default_face;
+
+    /* Only needed while building, families can be found by name after this */
+    g_clear_pointer(&self->styles, g_ptr_array_unref);
+    g_hash_table_remove_all(self->families);
+    for (guint i = 0; i < n_families; i++)
+        g_hash_table_insert(self->families,
+                            (gpointer) COLUMN(self->family_name, const gchar *, i),
+                            SET_FAMILY_ID(i));
+    font_manager_profiler_end(span, "FontTable.sort");
+    return;
+}
+
+/**
+ * font_manager_font_table_get_n_families:
+ * @self:       #FontManagerFontTable
+ *
+ * Returns: number of families in @self
+ */
+guint
+font_manager_font_table_get_n_families (FontManagerFontTable *self)
+{
+    g_return_val_if_fail(self != NULL, 0);
+    return self->family_name->len;
+}
+
+/**
+ * font_manager_font_table_get_n_faces:
+ * @self:       #FontManagerFontTable
+ *
+ * Returns: number of faces in @self
+ */
+guint
+font_manager_font_table_get_n_faces (FontManagerFontTable *self)
+{
+    g_return_val_if_fail(self != NULL, 0);
+    return self->face_family->len;
+}
+
+/**
+ * font_manager_font_table_find_family:
+ * @self:       #FontManagerFontTable
+ * @family:     family name
+ *
+ * Returns: id of @family or -1 if @self does not contain @family
+ */
+gint
+font_manager_font_table_find_family (FontManagerFontTable *self, const gchar *family)
+{
+    g_return_val_if_fail(self != NULL, -1);
+    g_return_val_if_fail(family != NULL, -1);
+    gpointer id = g_hash_table_lookup(self->families, family);
+    return id ? (gint) GET_FAMILY_ID(id) : -1;
+}
+
+/* Family columns are only filled in once the table is sorted */
+#define RETURN_FAMILY_COLUMN(a, t) \
+    g_return_val_if_fail(self != NULL, 0); \
+    g_return_val_if_fail(self->styles == NULL, 0); \
+    g_return_val_if_fail(family < self->family_name->len, 0); \
+    return COLUMN((a), t, family);
+
+#define RETURN_FACE_COLUMN(a, t) \
+    g_return_val_if_fail(self != NULL, 0); \
+    g_return_val_if_fail(face < self->face_family->len, 0); \
+    return COLUMN((a), t, face);
+
+/**
+ * font_manager_font_table_get_family_name:
+ * @self:       #FontManagerFontTable
+ * @family:     family id
+ *
+ * Returns: (transfer none): name of @family
+ */
+const gchar *
+font_manager_font_table_get_family_name (FontManagerFontTable *self, guint family)
+{
+    RETURN_FAMILY_COLUMN(self->family_name, const gchar *)
+}
+
+/**
+ * font_manager_font_table_get_first_face:
+ * @self:       #FontManagerFontTable
+ * @family:     family id
+ *
+ * Returns: id of the first face belonging to @family
+ */
+guint
+font_manager_font_table_get_first_face (FontManagerFontTable *self, guint family)
+{
+    RETURN_FAMILY_COLUMN(self->first_face, guint)
+}
+
+/**
+ * font_manager_font_table_get_n_variations:
+ * @self:       #FontManagerFontTable
+ * @family:     family id
+ *
+ * Returns: number of faces belonging to @family
+ */
+guint
+font_manager_font_table_get_n_variations (FontManagerFontTable *self, guint family)
+{
+    RETURN_FAMILY_COLUMN(self->n_variations, guint)
+}
+
+/**
+ * font_manager_font_table_get_default_face:
+ * @self:       #FontManagerFontTable
+ * @family:     family id
+ *
+ * Returns: id of the face used to represent @family
+ */
+guint
+font_manager_font_table_get_default_face (FontManagerFontTable *self, guint family)
+{
+    RETURN_FAMILY_COLUMN(self->default_face, guint)
+}
+
+/**
+ * font_manager_font_table_get_family:
+ * @self:       #FontManagerFontTable
+ * @face:       face id
+ *
+ * Returns: id of the family @face belongs to
+ */
+guint
+font_manager_font_table_get_family (FontManagerFontTable *self, guint face)
+{
+    RETURN_FACE_COLUMN(self->face_family, guint)
+}
+
+/**
+ * font_manager_font_table_get_filepath:
+ * @self:       #FontManagerFontTable
+ * @face:       face id
+ *
+ * Returns: (transfer none): filepath of @face
+ */
+const gchar *
+font_manager_font_table_get_filepath (FontManagerFontTable *self, guint face)
+{
+    RETURN_FACE_COLUMN(self->filepath, const gchar *)
+}
+
+/**
+ * font_manager_font_table_get_style:
+ * @self:       #FontManagerFontTable
+ * @face:       face id
+ *
+ * Returns: (transfer none): style of @face
+ */
+const gchar *
+font_manager_font_table_get_style (FontManagerFontTable *self, guint face)
+{
+    RETURN_FACE_COLUMN(self->style, const gchar *)
+}
+
+/**
+ * font_manager_font_table_get_description:
+ * @self:       #FontManagerFontTable
+ * @face:       face id
+ *
+ * Returns: (transfer none): Pango font description of @face
+ */
+const gchar *
+font_manager_font_table_get_description (FontManagerFontTable *self, guint face)
+{
+    RETURN_FACE_COLUMN(self->description, const gchar *)
+}
+
+/**
+ * font_manager_font_table_get_findex:
+ * @self:       #FontManagerFontTable
+ * @face:       face id
+ *
+ * Returns: index of @face within its file
+ */
+gint
+font_manager_font_table_get_findex (FontManagerFontTable *self, guint face)
+{
+    RETURN_FACE_COLUMN(self->findex, gint)
+}
+
+/**
+ * font_manager_font_table_get_weight:
+ * @self:       #FontManagerFontTable
+ * @face:       face id
+ *
+ * Returns: #FontManagerWeight of @face
+ */
+gint
+font_manager_font_table_get_weight (FontManagerFontTable *self, guint face)
+{
+    RETURN_FACE_COLUMN(self->weight, gint16)
+}
+
+/**
+ * font_manager_font_table_get_slant:
+ * @self:       #FontManagerFontTable
+ * @face:       face id
+ *
+ * Returns: #FontManagerSlant of @face
+ */
+gint
+font_manager_font_table_get_slant (FontManagerFontTable *self, guint face)
+{
+    RETURN_FACE_COLUMN(self->slant, gint16)
+}
+
+/**
+ * font_manager_font_table_get_width:
+ * @self:       #FontManagerFontTable
+ * @face:       face id
+ *
+ * Returns: #FontManagerWidth of @face
+ */
+gint
+font_manager_font_table_get_width (FontManagerFontTable *self, guint face)
+{
+    RETURN_FACE_COLUMN(self->width, gint16)
+}
+
+/**
+ * font_manager_font_table_get_spacing:
+ * @self:       #FontManagerFontTable
+ * @face:       face id
+ *
+ * Returns: #FontManagerSpacing of @face
+ */
+gint
+font_manager_font_table_get_spacing (FontManagerFontTable *self, guint face)
+{
+    RETURN_FACE_COLUMN(self->spacing, gint16)
+}
+
+/**
+ * font_manager_font_table_get_face_object:
+ * @self:       #FontManagerFontTable
+ * @face:       face id
+ *
+ * See #FontManagerFont for a description of the #JsonObject returned by this function.
+ *
+ * Returns: (transfer full): A newly created #JsonObject which should be
+ * freed using #json_object_unref() when no longer needed.
+ */
+JsonObject *
+font_manager_font_table_get_face_object (FontManagerFontTable *self, guint face)
+{
+    g_return_val_if_fail(self != NULL, NULL);
+    g_return_val_if_fail(self->styles == NULL, NULL);
+    g_return_val_if_fail(face < self->face_family->len, NULL);
+    guint family = COLUMN(self->face_family, guint, face);
+    JsonObject *json_obj = json_object_new();
+    json_object_set_string_member(json_obj, "filepath", COLUMN(self->filepath, const gchar *, face));
+    json_object_set_string_member(json_obj, "family", COLUMN(self->family_name, const gchar *, family));
+    json_object_set_int_member(json_obj, "findex", COLUMN(self->findex, gint, face));
+    json_object_set_int_member(json_obj, "spacing", COLUMN(self->spacing, gint16, face));
+    json_object_set_int_member(json_obj, "slant", COLUMN(self->slant, gint16, face));
+    json_object_set_int_member(json_obj, "weight", COLUMN(self->weight, gint16, face));
+    json_object_set_int_member(json_obj, "width", COLUMN(self->width, gint16, face));
+    json_object_set_string_member(json_obj, "style", COLUMN(self->style, const gchar *, face));
+    json_object_set_string_member(json_obj, "description", COLUMN(self->description, const gchar *, face));
+    json_object_set_boolean_member(json_obj, "active", TRUE);
+    json_object_set_int_member(json_obj, "_index", face - COLUMN(self->first_face, guint, family));
+    return json_obj;
+}
+
+/**
+ * font_manager_font_table_get_family_object:
+ * @self:       #FontManagerFontTable
+ * @family:     family id
+ *
+ * See #FontManagerFamily for a description of the #JsonObject returned by this function.
+ *
+ * Returns: (transfer full): A newly created #JsonObject which should be
+ * freed using #json_object_unref() when no longer needed.
+ */
+JsonObject *
+font_manager_font_table_get_family_object (FontManagerFontTable *self, guint family)
+{
+    g_return_val_if_fail(self != NULL, NULL);
+    g_return_val_if_fail(self->styles == NULL, NULL);
+    g_return_val_if_fail(family < self->family_name->len, NULL);
+    guint first = COLUMN(self->first_face, guint, family);
+    guint n_variations = COLUMN(self->n_variations, guint, family);
+    guint default_face = COLUMN(self->default_face, guint, family);
+    JsonArray *variations = json_array_sized_new(n_variations);
+    JsonObject *json_obj = json_object_new();
+    json_object_set_string_member(json_obj, "family", COLUMN(self->family_name, const gchar *, family));
+    json_object_set_int_member(json_obj, "n-variations", n_variations);
+    json_object_set_array_member(json_obj, "variations", variations);
+    json_object_set_boolean_member(json_obj, "active", TRUE);
+    json_object_set_int_member(json_obj, "_index", family);
+    for (guint face = first; face < first + n_variations; face++)
+        json_array_add_object_element(variations, font_manager_font_table_get_face_object(self, face));
+    json_object_set_string_member(json_obj, "description", COLUMN(self->description, const gchar *, default_face));
+    return json_obj;
+}
+
+/**
+ * font_manager_font_table_to_json:
+ * @self:       #FontManagerFontTable
+ *
+ * See #font_manager_sort_json_font_listing for a description of the
+ * #JsonArray returned by this function.
+ *
+ * Returns: (transfer full): #JsonArray
+ */
+JsonArray *
+font_manager_font_table_to_json (FontManagerFontTable *self)
+{
+    g_return_val_if_fail(self != NULL, NULL);
+    g_return_val_if_fail(self->styles == NULL, NULL);
+    guint n_families = self->family_name->len;
+    JsonArray *result = json_array_sized_new(n_families);
+    for (guint i = 0; i < n_families; i++)
+        json_array_add_object_element(result, font_manager_font_table_get_family_object(self, i));
+    return result;
+}
+
+/**
+ * font_manager_font_table_equal:
+ * @self:       #FontManagerFontTable
+ * @other:      #FontManagerFontTable
+ *
+ * Returns: %TRUE if @self and @other contain the same fonts, in the same order
+ */
+gboolean
+font_manager_font_table_equal (FontManagerFontTable *self, FontManagerFontTable *other)
+{
+    g_return_val_if_fail(self != NULL && other != NULL, FALSE);
+    g_return_val_if_fail(self->styles == NULL && other->styles == NULL, FALSE);
+    guint n_families = self->family_name->len;
+    guint n_faces = self->face_family->len;
+    if (n_families != other->family_name->len || n_faces != other->face_family->len)
+        return FALSE;
+    /* Family ranges are implied by the face columns */
+    if (memcmp(self->face_family->data, other->face_family->data, n_faces * sizeof(guint)) != 0 ||
+        memcmp(self->findex->data, other->findex->data, n_faces * sizeof(gint)) != 0 ||
+        memcmp(self->weight->data, other->weight->data, n_faces * sizeof(gint16)) != 0 ||
+        memcmp(self->slant->data, other->slant->data, n_faces * sizeof(gint16)) != 0 ||
+        memcmp(self->width->data, other->width->data, n_faces * sizeof(gint16)) != 0 ||
+        memcmp(self->spacing->data, other->spacing->data, n_faces * sizeof(gint16)) != 0)
+        return FALSE;
+    for (guint i = 0; i < n_families; i++)
+        if (g_strcmp0(COLUMN(self->family_name, const gchar *, i),
+                      COLUMN(other->family_name, const gchar *, i)) != 0)
+            return FALSE;
+    GArray *columns[3][2] = {
+        { self->filepath, other->filepath },
+        { self->style, other->style },
+        { self->description, other->description }
+    };
+    for (guint c = 0; c < G_N_ELEMENTS(columns); c++)
+        for (guint i = 0; i < n_faces; i++)
+            if (g_strcmp0(COLUMN(columns[c][0], const gchar *, i),
+                          COLUMN(columns[c][1], const gchar *, i)) != 0)
+                return FALSE;
+    return TRUE;
+}
+
+/**
+ * font_manager_font_table_family_equal:
+ * @self:           #FontManagerFontTable
+ * @family:         family id in @self
+ * @other:          #FontManagerFontTable
+ * @other_family:   family id in @other
+ *
+ * Used to find which families changed between two listings, ids of
+ * unchanged families may still differ.
+ *
+ * Returns: %TRUE if @family and @other_family contain the same faces, in the same order
+ */
+gboolean
+font_manager_font_table_family_equal (FontManagerFontTable *self,
+                                      guint                 family,
+                                      FontManagerFontTable *other,
+                                      guint                 other_family)
+{
+    g_return_val_if_fail(self != NULL && other != NULL, FALSE);
+    g_return_val_if_fail(self->styles == NULL && other->styles == NULL, FALSE);
+    g_return_val_if_fail(family < self->family_name->len, FALSE);
+    g_return_val_if_fail(other_family < other->family_name->len, FALSE);
+    guint n = COLUMN(self->n_variations, guint, family);
+    if (n != COLUMN(other->n_variations, guint, other_family) ||
+        COLUMN(self->default_face, guint, family) - COLUMN(self->first_face, guint, family) !=
+        COLUMN(other->default_face, guint, other_family) - COLUMN(other->first_face, guint, other_family) ||
+        g_strcmp0(COLUMN(self->family_name, const gchar *, family),
+                  COLUMN(other->family_name, const gchar *, other_family)) != 0)
+        return FALSE;
+    guint a = COLUMN(self->first_face, guint, family);
+    guint b = COLUMN(other->first_face, guint, other_family);
+    for (guint i = 0; i < n; i++, a++, b++) {
+        if (COLUMN(self->findex, gint, a) != COLUMN(other->findex, gint, b) ||
+            COLUMN(self->weight, gint16, a) != COLUMN(other->weight, gint16, b) ||
+            COLUMN(self->slant, gint16, a) != COLUMN(other->slant, gint16, b) ||
+            COLUMN(self->width, gint16, a) != COLUMN(other->width, gint16, b) ||
+            COLUMN(self->spacing, gint16, a) != COLUMN(other->spacing, gint16, b) ||
+            g_strcmp0(COLUMN(self->filepath, const gchar *, a), COLUMN(other->filepath, const gchar *, b)) != 0 ||
+            g_strcmp0(COLUMN(self->style, const gchar *, a), COLUMN(other->style, const gchar *, b)) != 0 ||
+            g_strcmp0(COLUMN(self->description, const gchar *, a), COLUMN(other->description, const gchar *, b)) != 0)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+static guint32
+get_string_offset (GHashTable *offsets, GByteArray *strings, const gchar *str)
+{
+    /* Strings are interned, so identical strings share an offset */
+    gpointer offset = NULL;
+    if (g_hash_table_lookup_extended(offsets, str, NULL, &offset))
+        return GPOINTER_TO_UINT(offset);
+    guint32 result = strings->len;
+    g_byte_array_append(strings, (const guint8 *) str, strlen(str) + 1);
+    g_hash_table_insert(offsets, (gpointer) str, GUINT_TO_POINTER(result));
+    return result;
+}
+
+static void
+append_string_column (GByteArray *buffer,
+                      GArray *column,
+                      GHashTable *offsets,
+                      GByteArray *strings)
+{
+    for (guint i = 0; i < column->len; i++) {
+        guint32 offset = get_string_offset(offsets, strings, COLUMN(column, const gchar *, i));
+        g_byte_array_append(buffer, (const guint8 *) &offset, sizeof(guint32));
+    }
+    return;
+}
+
+static void
+append_column (GByteArray *buffer, GArray *column)
+{
+    guint size = g_array_get_element_size(column);
+    g_byte_array_append(buffer, (const guint8 *) column->data, column->len * size);
+    return;
+}
+
+/**
+ * font_manager_font_table_save:
+ * @self:       #FontManagerFontTable
+ * @filepath:   full path to file to save to
+ * @stamp:      string describing the configuration @self was generated from
+ * @error:      #GError or %NULL to ignore errors
+ *
+ * Saves the contents of @self to @filepath.
+ *
+ * Returns: %TRUE on success
+ */
+gboolean
+font_manager_font_table_save (FontManagerFontTable *self,
+                              const gchar *filepath,
+                              const gchar *stamp,
+                              GError **error)
+{
+    g_return_val_if_fail(self != NULL, FALSE);
+    g_return_val_if_fail(self->styles == NULL, FALSE);
+    g_return_val_if_fail(filepath != NULL && stamp != NULL, FALSE);
+    g_return_val_if_fail((error == NULL || *error == NULL), FALSE);
+    g_autoptr(GByteArray) buffer = g_byte_array_new();
+    g_autoptr(GByteArray) strings = g_byte_array_new();
+    g_autoptr(GHashTable) offsets = g_hash_table_new(g_direct_hash, g_direct_equal);
+    SnapshotHeader header = { { 0 } };
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.n_families = self->family_name->len;
+    header.n_faces = self->face_family->len;
+    header.stamp = get_string_offset(offsets, strings, stamp);
+    g_byte_array_append(buffer, (const guint8 *) &header, sizeof(SnapshotHeader));
+    append_string_column(buffer, self->family_name, offsets, strings);
+    append_column(buffer, self->first_face);
+    append_column(buffer, self->n_variations);
+    append_column(buffer, self->default_face);
+    append_column(buffer, self->face_family);
+    append_string_column(buffer, self->filepath, offsets, strings);
+    append_string_column(buffer, self->style, offsets, strings);
+    append_string_column(buffer, self->description, offsets, strings);
+    append_column(buffer, self->findex);
+    append_column(buffer, self->weight);
+    append_column(buffer, self->slant);
+    append_column(buffer, self->width);
+    append_column(buffer, self->spacing);
+    /* Now that every string has been seen, update size in header */
+    ((SnapshotHeader *) buffer->data)->strings_size = strings->len;
+    g_byte_array_append(buffer, strings->data, strings->len);
+    return g_file_set_contents(filepath, (const gchar *) buffer->data, buffer->len, error);
+}
+
+static gboolean
+read_column (GArray *column, const gchar **data, const gchar *end, guint n)
+{
+    gsize size = (gsize) g_array_get_element_size(column) * n;
+    if ((gsize) (end - *data) < size)
+        return FALSE;
+    g_array_set_size(column, 0);
+    g_array_append_vals(column, *data, n);
+    *data += size;
+    return TRUE;
+}
+
+static gboolean
+read_string_column (GArray *column,
+                    const gchar **data,
+                    const gchar *end,
+                    guint n,
+                    const gchar *strings,
+                    guint32 strings_size)
+{
+    gsize size = sizeof(guint32) * n;
+    if ((gsize) (end - *data) < size)
+        return FALSE;
+    g_array_set_size(column, n);
+    for (guint i = 0; i < n; i++) {
+        guint32 offset;
+        memcpy(&offset, *data + i * sizeof(guint32), sizeof(guint32));
+        if (offset >= strings_size)
+            return FALSE;
+        COLUMN(column, const gchar *, i) = strings + offset;
+    }
+    *data += size;
+    return TRUE;
+}
+
+static gboolean
+read_snapshot (FontManagerFontTable *self, const gchar *stamp)
+{
+    gsize length = g_mapped_file_get_length(self->snapshot);
+    const gchar *contents = g_mapped_file_get_contents(self->snapshot);
+    if (contents == NULL || length < sizeof(SnapshotHeader))
+        return FALSE;
+    SnapshotHeader header;
+    memcpy(&header, contents, sizeof(SnapshotHeader));
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 || header.version != SNAPSHOT_VERSION)
+        return FALSE;
+    if (header.strings_size == 0 || header.strings_size > length - sizeof(SnapshotHeader))
+        return FALSE;
+    const gchar *data = contents + sizeof(SnapshotHeader);
+    const gchar *strings = contents + length - header.strings_size;
+    /* Every offset is checked against strings_size, a final nul guarantees termination */
+    if (strings[header.strings_size - 1] != '\0' || header.stamp >= header.strings_size)
+        return FALSE;
+    if (g_strcmp0(strings + header.stamp, stamp) != 0)
+        return FALSE;
+    guint32 n_families = header.n_families, n_faces = header.n_faces, size = header.strings_size;
+    if (!read_string_column(self->family_name, &data, strings, n_families, strings, size) ||
+        !read_column(self->first_face, &data, strings, n_families) ||
+        !read_column(self->n_variations, &data, strings, n_families) ||
+        !read_column(self->default_face, &data, strings, n_families) ||
+        !read_column(self->face_family, &data, strings, n_faces) ||
+        !read_string_column(self->filepath, &data, strings, n_faces, strings, size) ||
+        !read_string_column(self->style, &data, strings, n_faces, strings, size) ||
+        !read_string_column(self->description, &data, strings, n_faces, strings, size) ||
+        !read_column(self->findex, &data, strings, n_faces) ||
+        !read_column(self->weight, &data, strings, n_faces) ||
+        !read_column(self->slant, &data, strings, n_faces) ||
+        !read_column(self->width, &data, strings, n_faces) ||
+        !read_column(self->spacing, &data, strings, n_faces))
+        return FALSE;
+    /* Ids are used as indexes, make sure they are all in range */
+    for (guint i = 0; i < n_faces; i++)
+        if (COLUMN(self->face_family, guint, i) >= n_families)
+            return FALSE;
+    for (guint i = 0; i < n_families; i++) {
+        guint first = COLUMN(self->first_face, guint, i);
+        guint n = COLUMN(self->n_variations, guint, i);
+        guint _default = COLUMN(self->default_face, guint, i);
+        if (first > n_faces || n > n_faces - first || _default < first || _default >= first + n)
+            return FALSE;
+        g_hash_table_insert(self->families,
+                            (gpointer) COLUMN(self->family_name, const gchar *, i),
+                            SET_FAMILY_ID(i));
+    }
+    return TRUE;
+}
+
+/**
+ * font_manager_font_table_load:
+ * @filepath:   full path to a file created by #font_manager_font_table_save
+ * @stamp:      string describing the current configuration
+ * @error:      #GError or %NULL to ignore errors
+ *
+ * Returns: (transfer full) (nullable): A newly created #FontManagerFontTable or
+ * %NULL if @filepath could not be read, is invalid or was saved using a
+ * different @stamp. Free the returned object using #g_object_unref().
+ */
+FontManagerFontTable *
+font_manager_font_table_load (const gchar *filepath, const gchar *stamp, GError **error)
+{
+    g_return_val_if_fail(filepath != NULL && stamp != NULL, NULL);
+    g_return_val_if_fail((error == NULL || *error == NULL), NULL);
+    GMappedFile *snapshot = g_mapped_file_new(filepath, FALSE, error);
+    if (snapshot == NULL)
+        return NULL;
+    FontManagerFontTable *self = font_manager_font_table_new();
+    self->snapshot = snapshot;
+    g_clear_pointer(&self->styles, g_ptr_array_unref);
+    if (!read_snapshot(self, stamp)) {
+        g_debug("Ignoring outdated or invalid font table : %s", filepath);
+        g_object_unref(self);
+        return NULL;
+    }
+    return self;
+}
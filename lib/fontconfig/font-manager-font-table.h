@@ -0,0 +1,65 @@
+/* font-manager-font-table.h
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#pragma once
+
+#include <string.h>
+#include <glib.h>
+#include <glib-object.h>
+#include <fontconfig/fontconfig.h>
+#include <json-glib/json-glib.h>
+
+#define FONT_MANAGER_TYPE_FONT_TABLE (font_manager_font_table_get_type())
+G_DECLARE_FINAL_TYPE(FontManagerFontTable, font_manager_font_table, FONT_MANAGER, FONT_TABLE, GObject)
+
+FontManagerFontTable * font_manager_font_table_new (void);
+void font_manager_font_table_add_pattern (FontManagerFontTable *self, FcPattern *pattern);
+void font_manager_font_table_sort (FontManagerFontTable *self);
+guint font_manager_font_table_get_n_families (FontManagerFontTable *self);
+guint font_manager_font_table_get_n_faces (FontManagerFontTable *self);
+gint font_manager_font_table_find_family (FontManagerFontTable *self, const gchar *family);
+const gchar * font_manager_font_table_get_family_name (FontManagerFontTable *self, guint family);
+guint font_manager_font_table_get_first_face (FontManagerFontTable *self, guint family);
+guint font_manager_font_table_get_n_variations (FontManagerFontTable *self, guint family);
+guint font_manager_font_table_get_default_face (FontManagerFontTable *self, guint family);
+guint font_manager_font_table_get_family (FontManagerFontTable *self, guint face);
+const gchar * font_manager_font_table_get_filepath (FontManagerFontTable *self, guint face);
+const gchar * font_manager_font_table_get_style (FontManagerFontTable *self, guint face);
+const gchar * font_manager_font_table_get_description (FontManagerFontTable *self, guint face);
+gint font_manager_font_table_get_findex (FontManagerFontTable *self, guint face);
+gint font_manager_font_table_get_weight (FontManagerFontTable *self, guint face);
+gint font_manager_font_table_get_slant (FontManagerFontTable *self, guint face);
+gint font_manager_font_table_get_width (FontManagerFontTable *self, guint face);
+gint font_manager_font_table_get_spacing (FontManagerFontTable *self, guint face);
+JsonObject * font_manager_font_table_get_face_object (FontManagerFontTable *self, guint face);
+JsonObject * font_manager_font_table_get_family_object (FontManagerFontTable *self, guint family);
+JsonArray * font_manager_font_table_to_json (FontManagerFontTable *self);
+gboolean font_manager_font_table_equal (FontManagerFontTable *self, FontManagerFontTable *other);
+gboolean font_manager_font_table_family_equal (FontManagerFontTable *self,
+                                              guint family,
+                                              FontManagerFontTable *other,
+                                              guint other_family);
+gboolean font_manager_font_table_save (FontManagerFontTable *self,
+                                       const gchar *filepath,
+                                       const gchar *stamp,
+                                       GError **error);
+FontManagerFontTable * font_manager_font_table_load (const gchar *filepath,
+                                                     const gchar *stamp,
+                                                     GError **error);
@@ -41,6 +41,8 @@ static const gchar *DEFAULT_VARIANTS[5] = {
     "Book"
 };
 
+static gint configuration_serial = 0;
+
 static void
 set_error (const gchar *message, GError **error)
 {
@@ -93,7 +95,26 @@ process_fontset (const FcFontSet *fontset, JsonObject *json_obj)
  */
 gboolean
 font_manager_update_font_configuration (void) {
-    return (FcConfigDestroy(FcConfigGetCurrent()), FcInitReinitialize());
+    gboolean result = (FcConfigDestroy(FcConfigGetCurrent()), FcInitReinitialize());
+    g_atomic_int_inc(&configuration_serial);
+    return result;
+}
+
+/**
+ * font_manager_get_font_configuration_serial:
+ *
+ * The serial is incremented each time the font configuration is reloaded
+ * or application fonts are added or cleared. Font maps created under an
+ * older serial may no longer reflect the fonts that are available.
+ *
+ * This function is thread safe.
+ *
+ * Returns: current font configuration serial
+ */
+guint
+font_manager_get_font_configuration_serial (void)
+{
+    return (guint) g_atomic_int_get(&configuration_serial);
 }
 
 /**
@@ -107,7 +128,9 @@ font_manager_update_font_configuration (void) {
 gboolean
 font_manager_add_application_font (const gchar *filepath)
 {
-    return FcConfigAppFontAddFile(FcConfigGetCurrent(), (FcChar8 *) filepath);
+    gboolean result = FcConfigAppFontAddFile(FcConfigGetCurrent(), (FcChar8 *) filepath);
+    g_atomic_int_inc(&configuration_serial);
+    return result;
 }
 
 /**
@@ -121,7 +144,9 @@ font_manager_add_application_font (const gchar *filepath)
 gboolean
 font_manager_add_application_font_directory (const gchar *dir)
 {
-    return FcConfigAppFontAddDir(FcConfigGetCurrent(), (FcChar8 *) dir);
+    gboolean result = FcConfigAppFontAddDir(FcConfigGetCurrent(), (FcChar8 *) dir);
+    g_atomic_int_inc(&configuration_serial);
+    return result;
 }
 
 /**
@@ -133,6 +158,7 @@ void
 font_manager_clear_application_fonts (void)
 {
     FcConfigAppFontClear(FcConfigGetCurrent());
+    g_atomic_int_inc(&configuration_serial);
     return;
 }
 
@@ -231,6 +257,41 @@ font_manager_get_files_for_family (const char *family)
     return result;
 }
 
+static FcFontSet *
+list_available_fonts (const gchar *family_name)
+{
+    FcPattern *pattern = NULL;
+
+    if (family_name)
+        pattern = FcPatternBuild (NULL,
+                                  FC_FAMILY, FcTypeString, family_name,
+                                  FC_VARIABLE, FcTypeBool, FcFalse,
+                                  NULL);
+    else
+        pattern = FcPatternBuild (NULL,
+                                  FC_VARIABLE, FcTypeBool, FcFalse,
+                                  NULL);
+
+    FcObjectSet *objectset = FcObjectSetBuild(FC_FILE,
+                                              FC_INDEX,
+                                              FC_FAMILY,
+                                              FC_STYLE,
+                                              FC_SLANT,
+                                              FC_WEIGHT,
+                                              FC_WIDTH,
+                                              FC_SPACING,
+                                              FC_LANG,
+                                              FC_FONTFORMAT,
+                                              NULL);
+
+    gint64 span = font_manager_profiler_begin();
+    FcFontSet *fontset = FcFontList(FcConfigGetCurrent(), pattern, objectset);
+    font_manager_profiler_end(span, "Fontconfig.list");
+    FcObjectSetDestroy(objectset);
+    FcPatternDestroy(pattern);
+    return fontset;
+}
+
 /**
  * font_manager_get_available_fonts:
  * @family_name: (nullable): family name or %NULL
@@ -266,35 +327,37 @@ font_manager_get_files_for_family (const char *family)
 JsonObject *
 font_manager_get_available_fonts (const gchar *family_name)
 {
-    FcPattern *pattern = NULL;
-
-    if (family_name)
-        pattern = FcPatternBuild (NULL,
-                                  FC_FAMILY, FcTypeString, family_name,
-                                  FC_VARIABLE, FcTypeBool, FcFalse,
-                                  NULL);
-    else
-        pattern = FcPatternBuild (NULL,
-                                  FC_VARIABLE, FcTypeBool, FcFalse,
-                                  NULL);
-
-    FcObjectSet *objectset = FcObjectSetBuild(FC_FILE,
-                                              FC_INDEX,
-                                              FC_FAMILY,
-                                              FC_STYLE,
-                                              FC_SLANT,
-                                              FC_WEIGHT,
-                                              FC_WIDTH,
-                                              FC_SPACING,
-                                              FC_LANG,
-                                              FC_FONTFORMAT,
-                                              NULL);
-
-    FcFontSet *fontset = FcFontList(FcConfigGetCurrent(), pattern, objectset);
+    FcFontSet *fontset = list_available_fonts(family_name);
     JsonObject *result = json_object_new();
     process_fontset(fontset, result);
-    FcObjectSetDestroy(objectset);
-    FcPatternDestroy(pattern);
+    FcFontSetDestroy(fontset);
+    return result;
+}
+
+/**
+ * font_manager_get_available_font_table:
+ * @family_name: (nullable): family name or %NULL
+ *
+ * If @family_name is not %NULL, only information for fonts belonging to
+ * specified family will be returned.
+ *
+ * Same information as #font_manager_get_available_fonts, already sorted.
+ *
+ * Returns: (transfer full): A newly created #FontManagerFontTable.
+ * Free the returned object using #g_object_unref().
+ */
+FontManagerFontTable *
+font_manager_get_available_font_table (const gchar *family_name)
+{
+    int pango = pango_version();
+    FcFontSet *fontset = list_available_fonts(family_name);
+    FontManagerFontTable *result = font_manager_font_table_new();
+    for (int i = 0; i < fontset->nfont; i++) {
+        if (pango >= PANGO_1_44 && is_legacy_format(fontset->fonts[i]))
+            continue;
+        font_manager_font_table_add_pattern(result, fontset->fonts[i]);
+    }
+    font_manager_font_table_sort(result);
     FcFontSetDestroy(fontset);
     return result;
 }
@@ -440,22 +503,10 @@ font_manager_get_attributes_from_fontconfig_pattern (FcPattern *pattern)
     json_object_set_int_member(json_obj, "weight", weight);
     json_object_set_int_member(json_obj, "width", width);
 
-    if (FcPatternGetString (pattern, FC_STYLE, 0, &style) == FcResultMatch) {
+    if (FcPatternGetString (pattern, FC_STYLE, 0, &style) == FcResultMatch)
         json_object_set_string_member(json_obj, "style", (const gchar *) style);
-    } else {
-        /* Use the same style Pango would if none is given */
-        if (weight <= FC_WEIGHT_MEDIUM) {
-            if (slant == FC_SLANT_ROMAN)
-                json_object_set_string_member(json_obj, "style", "Regular");
-            else
-                json_object_set_string_member(json_obj, "style", "Italic");
-        } else {
-            if (slant == FC_SLANT_ROMAN)
-                json_object_set_string_member(json_obj, "style", "Bold");
-            else
-                json_object_set_string_member(json_obj, "style", "Bold Italic");
-        }
-    }
+    else
+        json_object_set_string_member(json_obj, "style", font_manager_get_fallback_style(weight, slant));
 
     PangoFontDescription *descr = pango_fc_font_description_from_pattern(pattern, FALSE);
     g_autofree gchar *font_desc = pango_font_description_to_string(descr);
@@ -465,6 +516,37 @@ font_manager_get_attributes_from_fontconfig_pattern (FcPattern *pattern)
     return json_obj;
 }
 
+/**
+ * font_manager_get_fallback_style:
+ * @weight: Fontconfig weight
+ * @slant: Fontconfig slant
+ *
+ * Returns: (transfer none): the style name Pango would use for a font
+ * which does not provide one
+ */
+const gchar *
+font_manager_get_fallback_style (gint weight, gint slant)
+{
+    if (weight <= FC_WEIGHT_MEDIUM)
+        return slant == FC_SLANT_ROMAN ? "Regular" : "Italic";
+    return slant == FC_SLANT_ROMAN ? "Bold" : "Bold Italic";
+}
+
+/**
+ * font_manager_is_default_variant:
+ * @style: (nullable): style name
+ *
+ * Returns: %TRUE if @style is suitable as the default variation of a family
+ */
+gboolean
+font_manager_is_default_variant (const gchar *style)
+{
+    for (guint i = 0; i < G_N_ELEMENTS(DEFAULT_VARIANTS); i++)
+        if (g_strcmp0(style, DEFAULT_VARIANTS[i]) == 0)
+            return TRUE;
+    return FALSE;
+}
+
 /**
  * font_manager_get_attributes_from_filepath:
  * @filepath:   full path to font file to query
@@ -498,6 +580,84 @@ font_manager_get_attributes_from_filepath (const gchar *filepath, GError **error
     return json_object_ref(result);
 }
 
+/* Sort keys are computed once per family and variation rather than per comparison */
+
+#define SORT_CHUNK_SIZE 256
+
+typedef struct
+{
+    guint64 key;
+    gchar *style_key;
+    JsonNode *node;
+}
+VariationSortEntry;
+
+typedef struct
+{
+    gchar *key;
+    const gchar *name;
+    JsonObject *family_obj;
+    GArray *variations;
+}
+FamilySortEntry;
+
+static void
+variation_sort_entry_clear (VariationSortEntry *entry)
+{
+    g_clear_pointer(&entry->style_key, g_free);
+    return;
+}
+
+static void
+family_sort_entry_clear (FamilySortEntry *entry)
+{
+    g_clear_pointer(&entry->key, g_free);
+    g_clear_pointer(&entry->variations, g_array_unref);
+    return;
+}
+
+static gint
+compare_family_sort_entry (const FamilySortEntry *a, const FamilySortEntry *b)
+{
+    return g_strcmp0(a->key, b->key);
+}
+
+/* Same order as font_manager_compare_json_font_node */
+static gint
+compare_variation_sort_entry (const VariationSortEntry *a, const VariationSortEntry *b)
+{
+    if (a->key != b->key)
+        return a->key < b->key ? -1 : 1;
+    return g_strcmp0(a->style_key, b->style_key);
+}
+
+/* Only reads from the source listing, safe to run for different ranges at once */
+static void
+prepare_family_sort_entries (guint start, guint end, GArray *families)
+{
+    for (guint i = start; i < end; i++) {
+        FamilySortEntry *family = &g_array_index(families, FamilySortEntry, i);
+        family->key = g_utf8_collate_key_for_filename(family->name, -1);
+        GList *variations = json_object_get_values(family->family_obj);
+        family->variations = g_array_sized_new(FALSE, TRUE, sizeof(VariationSortEntry), g_list_length(variations));
+        g_array_set_clear_func(family->variations, (GDestroyNotify) variation_sort_entry_clear);
+        for (GList *iter = variations; iter != NULL; iter = iter->next) {
+            JsonObject *obj = json_node_get_object(iter->data);
+            VariationSortEntry entry = {
+                FONT_MANAGER_STYLE_SORT_KEY(json_object_get_int_member(obj, "width"),
+                                            json_object_get_int_member(obj, "weight"),
+                                            json_object_get_int_member(obj, "slant")),
+                g_utf8_collate_key_for_filename(json_object_get_string_member(obj, "style"), -1),
+                iter->data
+            };
+            g_array_append_val(family->variations, entry);
+        }
+        g_array_sort(family->variations, (GCompareFunc) compare_variation_sort_entry);
+        g_list_free(variations);
+    }
+    return;
+}
+
 /**
  * font_manager_sort_json_font_listing:
  * @json_obj: #JsonObject returned from #font_manager_get_available_fonts*
@@ -533,41 +693,42 @@ font_manager_get_attributes_from_filepath (const gchar *filepath, GError **error
 JsonArray *
 font_manager_sort_json_font_listing (JsonObject *json_obj)
 {
+    gint64 span = font_manager_profiler_begin();
     GList *members = json_object_get_members(json_obj);
-    members = g_list_sort(members, (GCompareFunc) font_manager_natural_sort);
-    JsonArray *result = json_array_sized_new(g_list_length(members));
-    gint index = 0;
-    GList *iter;
-    for (iter = members; iter != NULL; iter = iter->next) {
-        JsonObject *family_obj = json_object_get_object_member(json_obj, iter->data);
-        GList *variations = json_object_get_values(family_obj);
-        gint n_variations = g_list_length(variations);
+    guint n_families = g_list_length(members);
+    g_autoptr(GArray) families = g_array_sized_new(FALSE, TRUE, sizeof(FamilySortEntry), n_families);
+    g_array_set_clear_func(families, (GDestroyNotify) family_sort_entry_clear);
+    for (GList *iter = members; iter != NULL; iter = iter->next) {
+        FamilySortEntry entry = { NULL, iter->data, json_object_get_object_member(json_obj, iter->data), NULL };
+        g_array_append_val(families, entry);
+    }
+    g_list_free(members);
+    font_manager_parallel_for(n_families, SORT_CHUNK_SIZE, (FontManagerRangeFunc) prepare_family_sort_entries, families);
+    g_array_sort(families, (GCompareFunc) compare_family_sort_entry);
+    JsonArray *result = json_array_sized_new(n_families);
+    for (guint index = 0; index < n_families; index++) {
+        FamilySortEntry *family = &g_array_index(families, FamilySortEntry, index);
+        gint n_variations = family->variations->len;
         JsonArray *_variations = json_array_sized_new(n_variations);
         JsonObject *_family_obj = json_object_new();
-        json_object_set_string_member(_family_obj, "family", iter->data);
+        json_object_set_string_member(_family_obj, "family", family->name);
         json_object_set_int_member(_family_obj, "n-variations", n_variations);
         json_object_set_array_member(_family_obj, "variations", _variations);
         json_object_set_boolean_member(_family_obj, "active", TRUE);
         json_object_set_int_member(_family_obj, "_index", index);
-        variations = g_list_sort(variations, (GCompareFunc) font_manager_compare_json_font_node);
-        gint _index = 0;
-        GList *_iter;
-        for (_iter = variations; _iter != NULL; _iter = _iter->next) {
-            JsonObject *style_obj = json_node_dup_object(_iter->data);
+        for (gint _index = 0; _index < n_variations; _index++) {
+            VariationSortEntry *variation = &g_array_index(family->variations, VariationSortEntry, _index);
+            JsonObject *style_obj = json_node_dup_object(variation->node);
             json_object_set_int_member(style_obj, "_index", _index);
             json_array_add_object_element(_variations, style_obj);
             /* Try to find "default" variation for this family */
             if (!json_object_get_member(_family_obj, "description")) {
                 const gchar *style = json_object_get_string_member(style_obj, "style");
-                for (guint i = 0; i < G_N_ELEMENTS(DEFAULT_VARIANTS); i++) {
-                    if (g_strcmp0(style, DEFAULT_VARIANTS[i]) == 0) {
-                        const gchar *font_desc = json_object_get_string_member(style_obj, "description");
-                        json_object_set_string_member(_family_obj, "description", font_desc);
-                        break;
-                    }
+                if (font_manager_is_default_variant(style)) {
+                    const gchar *font_desc = json_object_get_string_member(style_obj, "description");
+                    json_object_set_string_member(_family_obj, "description", font_desc);
                 }
             }
-            _index++;
         }
         /* No suitable "default" found for this family, set the first result as default */
         if (!json_object_get_member(_family_obj, "description")) {
@@ -576,10 +737,8 @@ font_manager_sort_json_font_listing (JsonObject *json_obj)
             json_object_set_string_member(_family_obj, "description", fallback);
         }
         json_array_add_object_element(result, _family_obj);
-        g_list_free(variations);
-        index++;
     }
-    g_list_free(members);
+    font_manager_profiler_end(span, "Fontconfig.sort_listing");
     return result;
 }
 
@@ -34,6 +34,7 @@
 #include <pango/pango-utils.h>
 #include <pango/pango-version-macros.h>
 
+#include "font-manager-font-table.h"
 #include "font-manager-json.h"
 #include "font-manager-utils.h"
 #include "unicode-info.h"
@@ -55,6 +56,7 @@ void font_manager_clear_application_fonts (void);
 gboolean font_manager_add_application_font (const gchar *filepath);
 gboolean font_manager_add_application_font_directory (const gchar *dir);
 gboolean font_manager_update_font_configuration (void);
+guint font_manager_get_font_configuration_serial (void);
 GList * font_manager_list_available_font_files (void);
 FontManagerStringSet * font_manager_get_files_for_family (const char *family);
 FontManagerStringSet * font_manager_list_available_font_families (void);
@@ -63,7 +65,24 @@ JsonObject * font_manager_get_attributes_from_filepath (const gchar *filepath, G
 JsonObject * font_manager_get_attributes_from_fontconfig_pattern (FcPattern *pattern);
 JsonObject * font_manager_get_available_fonts (const gchar *family_name);
 JsonObject * font_manager_get_available_fonts_for_chars (const gchar *chars);
+FontManagerFontTable * font_manager_get_available_font_table (const gchar *family_name);
 JsonArray * font_manager_sort_json_font_listing (JsonObject *json_obj);
+const gchar * font_manager_get_fallback_style (gint weight, gint slant);
+gboolean font_manager_is_default_variant (const gchar *style);
+
+/**
+ * FONT_MANAGER_STYLE_SORT_KEY:
+ * @width:  Fontconfig width
+ * @weight: Fontconfig weight
+ * @slant:  Fontconfig slant
+ *
+ * Packs style properties into a single integer which sorts the same way
+ * #font_manager_compare_json_font_node compares them.
+ */
+#define FONT_MANAGER_STYLE_SORT_KEY(width, weight, slant) \
+    (((guint64) CLAMP((width), 0, G_MAXUINT16) << 32) | \
+     ((guint64) CLAMP((weight), 0, G_MAXUINT16) << 16) | \
+     ((guint64) CLAMP((slant), 0, G_MAXUINT16)))
 
 /**
  * FontManagerWeight:
@@ -114,6 +114,8 @@ struct _FontManagerPreviewPage
     GtkWidget   *controls;
     GtkWidget   *fontscale;
     GtkWidget   *textview;
+    GtkWidget   *waterfall;
+    GtkWidget   *stack;
     GtkWidget   *menu_button;
 
     gint                line_spacing;
@@ -250,6 +252,8 @@ font_manager_preview_page_set_property (GObject      *gobject,
             self->line_spacing = g_value_get_int(value);
             gtk_text_view_set_pixels_above_lines(GTK_TEXT_VIEW(self->textview), self->line_spacing);
             gtk_text_view_set_pixels_below_lines(GTK_TEXT_VIEW(self->textview), self->line_spacing);
+            font_manager_waterfall_view_set_line_spacing(FONT_MANAGER_WATERFALL_VIEW(self->waterfall),
+                                                         self->line_spacing);
             break;
         case PROP_SHOW_LINE_SIZE:
             self->show_line_size = g_value_get_boolean(value);
@@ -435,47 +439,17 @@ update_revealer_state (FontManagerPreviewPage     *self,
     return;
 }
 
-static gint current_line = FONT_MANAGER_MIN_FONT_SIZE;
-
-static gboolean
-generate_waterfall_line (FontManagerPreviewPage *self)
-{
-    GtkTextIter iter;
-    GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(self->textview));
-    GtkTextTagTable *tag_table = gtk_text_buffer_get_tag_table(buffer);
-    gint i = current_line;
-    g_autofree gchar *size_point = NULL;
-    g_autofree gchar *line = g_strdup_printf("%i", i);
-    if (self->show_line_size)
-        size_point = g_strdup_printf(i < 10 ? " %spt.  " : "%spt.  ", line);
-    gtk_text_buffer_get_iter_at_line(buffer, &iter, i);
-    if (self->show_line_size)
-        gtk_text_buffer_insert_with_tags_by_name(buffer, &iter, size_point, -1, "SizePoint", NULL);
-    if (!gtk_text_tag_table_lookup(tag_table, line))
-        gtk_text_buffer_create_tag(buffer, line, "size-points", (gdouble) i, NULL);
-    if (self->show_line_size)
-        gtk_text_buffer_get_end_iter(buffer, &iter);
-    g_autofree gchar *pangram = g_strdup_printf("%s\n", self->pangram);
-    gtk_text_buffer_insert_with_tags_by_name(buffer, &iter, pangram, -1, line, "FontDescription", NULL);
-    if (self->waterfall_size_ratio > 1.0) {
-        gdouble next = current_line * self->waterfall_size_ratio;
-        current_line = self->waterfall_size_ratio > 1.1 ? floor(next) : ceil(next);
-    } else
-        current_line++;
-    return self->mode != FONT_MANAGER_PREVIEW_PAGE_MODE_WATERFALL ||
-           current_line > self->max_waterfall_size ?
-           G_SOURCE_REMOVE : G_SOURCE_CONTINUE;
-}
-
 static void
 generate_waterfall_preview (FontManagerPreviewPage *self)
 {
     g_return_if_fail(self != NULL);
-    GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(self->textview));
-    gtk_text_buffer_set_text(buffer, "", -1);
-    g_idle_remove_by_data(self);
-    current_line = self->min_waterfall_size;
-    g_idle_add_full(G_PRIORITY_HIGH_IDLE, (GSourceFunc) generate_waterfall_line, self, NULL);
+    FontManagerWaterfallView *waterfall = FONT_MANAGER_WATERFALL_VIEW(self->waterfall);
+    font_manager_waterfall_view_set_text(waterfall, self->pangram);
+    font_manager_waterfall_view_set_show_line_size(waterfall, self->show_line_size);
+    font_manager_waterfall_view_set_sizes(waterfall,
+                                          self->min_waterfall_size,
+                                          self->max_waterfall_size,
+                                          self->waterfall_size_ratio);
     return;
 }
 
@@ -487,8 +461,10 @@ apply_font_description (FontManagerPreviewPage *self)
         return;
     GtkTextIter start, end;
     GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(self->textview));
+    gint64 span = font_manager_profiler_begin();
     gtk_text_buffer_get_bounds(buffer, &start, &end);
     gtk_text_buffer_apply_tag_by_name(buffer, "FontDescription", &start, &end);
+    font_manager_profiler_end(span, "PreviewPage.apply_font");
     return;
 }
 
@@ -539,6 +515,7 @@ update_font_description (FontManagerPreviewPage *self)
                  "size-points", self->preview_size,
                  "fallback", FALSE,
                  NULL);
+    font_manager_waterfall_view_set_font_desc(FONT_MANAGER_WATERFALL_VIEW(self->waterfall), font_desc);
     return;
 }
 
@@ -685,6 +662,10 @@ font_manager_preview_page_init (FontManagerPreviewPage *self)
     GtkWidget *scroll = gtk_scrolled_window_new();
     self->textview = gtk_text_view_new_with_buffer(buffer);
     gtk_widget_add_css_class(GTK_WIDGET(self->textview), "FontManagerFontPreviewArea");
+    GtkWidget *waterfall_scroll = gtk_scrolled_window_new();
+    self->waterfall = font_manager_waterfall_view_new();
+    gtk_widget_add_css_class(GTK_WIDGET(self->waterfall), "FontManagerFontPreviewArea");
+    self->stack = gtk_stack_new();
     /* gtk_text_view_set_cursor_visible(GTK_TEXT_VIEW(self->textview), FALSE); */
     GtkWidget *controls = font_manager_preview_controls_new();
     self->controls = gtk_revealer_new();
@@ -693,14 +674,21 @@ font_manager_preview_page_init (FontManagerPreviewPage *self)
     gtk_revealer_set_child(GTK_REVEALER(self->controls), controls);
     gtk_revealer_set_child(GTK_REVEALER(self->fontscale), fontscale);
     gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(scroll), self->textview);
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(waterfall_scroll), self->waterfall);
+    gtk_stack_add_named(GTK_STACK(self->stack), scroll, "text");
+    gtk_stack_add_named(GTK_STACK(self->stack), waterfall_scroll, "waterfall");
     font_manager_widget_set_expand(scroll, TRUE);
     gtk_box_append(GTK_BOX(self), self->controls);
-    gtk_box_append(GTK_BOX(self), scroll);
+    gtk_box_append(GTK_BOX(self), self->stack);
     gtk_box_append(GTK_BOX(self), self->fontscale);
     font_manager_widget_set_margin(self->textview, FONT_MANAGER_DEFAULT_MARGIN * 2);
     gtk_widget_set_margin_top(self->textview, FONT_MANAGER_DEFAULT_MARGIN * 1.5);
     gtk_widget_set_margin_bottom(self->textview, FONT_MANAGER_DEFAULT_MARGIN * 1.5);
+    font_manager_widget_set_margin(self->waterfall, FONT_MANAGER_DEFAULT_MARGIN * 2);
+    gtk_widget_set_margin_top(self->waterfall, FONT_MANAGER_DEFAULT_MARGIN * 1.5);
+    gtk_widget_set_margin_bottom(self->waterfall, FONT_MANAGER_DEFAULT_MARGIN * 1.5);
     font_manager_widget_set_expand(scroll, TRUE);
+    font_manager_widget_set_expand(waterfall_scroll, TRUE);
     font_manager_preview_page_set_preview_size(self, FONT_MANAGER_DEFAULT_PREVIEW_SIZE);
     font_manager_preview_page_set_preview_mode(self, FONT_MANAGER_PREVIEW_PAGE_MODE_WATERFALL);
     GtkAdjustment *adjustment = font_manager_font_scale_get_adjustment(FONT_MANAGER_FONT_SCALE(fontscale));
@@ -723,10 +711,12 @@ font_manager_preview_page_init (FontManagerPreviewPage *self)
     GtkGesture *long_press = gtk_gesture_long_press_new();
     g_signal_connect_swapped(long_press, "pressed", G_CALLBACK(on_long_press_event), self->textview);
     gtk_widget_add_controller(GTK_WIDGET(self->textview), GTK_EVENT_CONTROLLER(long_press));
+    /* Waterfall is drawn rather than laid out as text, there's nothing to select or copy */
     font_manager_preview_page_set_waterfall_size(self, self->min_waterfall_size, DEFAULT_WATERFALL_MAX_SIZE, 1.0);
     self->menu_button = g_object_ref_sink(gtk_menu_button_new());
     font_manager_set_preview_page_mode_menu_and_actions(GTK_WIDGET(self), self->menu_button, G_CALLBACK(on_mode_action_activated));
     g_signal_connect_after(self->textview, "map", G_CALLBACK(force_css_update), NULL);
+    g_signal_connect_after(self->waterfall, "map", G_CALLBACK(force_css_update), NULL);
     return;
 }
 
@@ -852,8 +842,6 @@ static void
 set_preview_mode_internal (FontManagerPreviewPage     *self,
                            FontManagerPreviewPageMode  mode)
 {
-    while (g_idle_remove_by_data(self))
-        g_idle_remove_by_data(self);
     self->mode = mode;
     GtkTextIter start;
     GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(self->textview));
@@ -875,7 +863,6 @@ set_preview_mode_internal (FontManagerPreviewPage     *self,
             break;
         case FONT_MANAGER_PREVIEW_PAGE_MODE_WATERFALL:
             generate_waterfall_preview(self);
-            gtk_text_view_set_wrap_mode(GTK_TEXT_VIEW(self->textview), GTK_WRAP_NONE);
             break;
         case FONT_MANAGER_PREVIEW_PAGE_MODE_LOREM_IPSUM:
             gtk_text_buffer_set_text(buffer, FONT_MANAGER_LOREM_IPSUM, -1);
@@ -884,6 +871,9 @@ set_preview_mode_internal (FontManagerPreviewPage     *self,
             g_critical("Invalid preview mode : %i", (gint) mode);
             g_return_if_reached();
     }
+    gtk_stack_set_visible_child_name(GTK_STACK(self->stack),
+                                     mode == FONT_MANAGER_PREVIEW_PAGE_MODE_WATERFALL ?
+                                     "waterfall" : "text");
     apply_font_description(self);
     update_revealer_state(self, mode);
     g_object_notify_by_pspec(G_OBJECT(self), obj_properties[PROP_PREVIEW_MODE]);
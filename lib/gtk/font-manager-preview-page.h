@@ -33,6 +33,7 @@
 #include "font-manager-font-scale.h"
 #include "font-manager-preview-controls.h"
 #include "font-manager-gtk-utils.h"
+#include "font-manager-waterfall-view.h"
 
 #define FONT_MANAGER_TYPE_PREVIEW_PAGE (font_manager_preview_page_get_type())
 G_DECLARE_FINAL_TYPE(FontManagerPreviewPage, font_manager_preview_page, FONT_MANAGER, PREVIEW_PAGE, GtkBox);
@@ -398,7 +398,7 @@ font_manager_preview_pane_update_metadata (FontManagerPreviewPane *self)
     GError *error = NULL;
     g_autoptr(JsonObject) res = NULL;
     if (!self->db)
-        self->db = font_manager_database_new();
+        self->db = font_manager_database_get_reader();
     JsonObject *source = NULL;
     g_object_get(G_OBJECT(self->font), "source-object", &source, NULL);
     if (!source) {
@@ -0,0 +1,579 @@
+/* font-manager-preview-texture-cache.c
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#include "font-manager-fontconfig.h"
+#include "font-manager-preview-texture-cache.h"
+
+/**
+ * SECTION: font-manager-preview-texture-cache
+ * @short_description: Pre-rendered font preview textures
+ * @title: Preview Texture Cache
+ * @include: font-manager-preview-texture-cache.h
+ *
+ * Renders short font samples into textures on worker threads and keeps the
+ * most recently used ones around so that widgets displaying many previews,
+ * such as the Browse grid, don't need to shape and rasterize them again.
+ *
+ * Textures are keyed by font description, text, point size and pixel size.
+ * Foreground color, scale factor and resolution are taken from the widget
+ * passed to font_manager_preview_texture_cache_update_style(), the cache is
+ * cleared whenever those change. It is also cleared once the font configuration
+ * is reloaded, see font_manager_get_font_configuration_serial().
+ *
+ * Metric hinting is disabled so glyph positions scale linearly with size,
+ * a texture rendered at one size can stand in for another until the exact
+ * one is available. Only the latest size requested for a given description
+ * and text is rendered, requests for other sizes still queued are skipped.
+ *
+ * All functions must be called from the main thread.
+ */
+
+/* Samples queued beyond this are dropped, tiles fall back to rendering themselves */
+#define MAX_QUEUED_REQUESTS 512
+#define MAX_RENDER_THREADS 4
+/* Upper bound for textures sized to fit their text, in device pixels */
+#define MAX_TEXTURE_SIZE 8192
+
+struct _FontManagerPreviewTextureCache
+{
+    GObject parent;
+
+    gsize           max_bytes;
+    gsize           n_bytes;
+    gint            scale;
+    gdouble         resolution;
+    guint64         serial;
+    guint           generation; /* Font configuration serial cached textures were rendered with */
+    guint           invalidate_id;
+    GdkRGBA         color;
+    GQueue          entries;    /* CacheEntry, most recently used first */
+    GHashTable      *index;     /* key -> GList link in entries */
+    GHashTable      *pending;   /* key -> NULL, requests which have not completed yet */
+    GHashTable      *latest;    /* sample key -> RenderRequest, most recent request for a sample */
+    GThreadPool     *pool;
+};
+
+G_DEFINE_TYPE(FontManagerPreviewTextureCache, font_manager_preview_texture_cache, G_TYPE_OBJECT)
+
+enum
+{
+    INVALIDATED,
+    TEXTURE_READY,
+    NUM_SIGNALS
+};
+
+static guint signals[NUM_SIGNALS];
+
+typedef struct
+{
+    gchar       *key;
+    GdkTexture  *texture;
+    gsize       n_bytes;
+}
+CacheEntry;
+
+typedef struct
+{
+    FontManagerPreviewTextureCache *cache;
+    gchar       *key;
+    gchar       *description;
+    gchar       *text;
+    gdouble     size_points;
+    gint        width;
+    gint        height;
+    gint        scale;
+    gdouble     resolution;
+    guint64     serial;
+    GdkRGBA     color;
+    /* Set once a request for another size of the same sample is made, atomic */
+    gint        superseded;
+    /* Filled in by the worker */
+    guint       generation;
+    GBytes      *pixels;
+    gsize       stride;
+}
+RenderRequest;
+
+static void
+cache_entry_free (CacheEntry *entry)
+{
+    g_clear_object(&entry->texture);
+    g_free(entry->key);
+    g_free(entry);
+    return;
+}
+
+static void
+render_request_free (RenderRequest *request)
+{
+    g_clear_object(&request->cache);
+    g_clear_pointer(&request->pixels, g_bytes_unref);
+    g_free(request->key);
+    g_free(request->description);
+    g_free(request->text);
+    g_free(request);
+    return;
+}
+
+static gchar *
+get_key (const gchar *description, const gchar *text, gdouble size_points, gint width, gint height)
+{
+    return g_strdup_printf("%s\x1f%s\x1f%g\x1f%ix%i", description, text, size_points, width, height);
+}
+
+/* Identifies a sample regardless of size */
+static gchar *
+get_sample_key (const gchar *description, const gchar *text)
+{
+    return g_strdup_printf("%s\x1f%s", description, text);
+}
+
+static void
+evict (FontManagerPreviewTextureCache *self)
+{
+    while (self->n_bytes > self->max_bytes && self->entries.tail != NULL) {
+        CacheEntry *entry = g_queue_pop_tail(&self->entries);
+        g_hash_table_remove(self->index, entry->key);
+        self->n_bytes -= entry->n_bytes;
+        cache_entry_free(entry);
+    }
+    return;
+}
+
+typedef struct
+{
+    PangoFontMap    *font_map;
+    guint           generation;
+}
+ThreadFontMap;
+
+static void
+thread_font_map_free (ThreadFontMap *thread_font_map)
+{
+    g_clear_object(&thread_font_map->font_map);
+    g_free(thread_font_map);
+    return;
+}
+
+/* Fontconfig based font maps are not thread safe, each worker gets its own.
+ * Font maps hold on to the configuration they were created with, the one
+ * belonging to this thread is replaced once fonts have been reloaded. */
+static PangoFontMap *
+get_thread_font_map (guint generation)
+{
+    static GPrivate font_map_key = G_PRIVATE_INIT((GDestroyNotify) thread_font_map_free);
+    ThreadFontMap *thread_font_map = g_private_get(&font_map_key);
+    if (thread_font_map == NULL) {
+        thread_font_map = g_new0(ThreadFontMap, 1);
+        g_private_set(&font_map_key, thread_font_map);
+    }
+    if (thread_font_map->font_map == NULL || thread_font_map->generation != generation) {
+        g_clear_object(&thread_font_map->font_map);
+        thread_font_map->font_map = pango_cairo_font_map_new();
+        thread_font_map->generation = generation;
+    }
+    return thread_font_map->font_map;
+}
+
+static gboolean
+emit_invalidated (FontManagerPreviewTextureCache *self)
+{
+    self->invalidate_id = 0;
+    g_signal_emit(self, signals[INVALIDATED], 0);
+    return G_SOURCE_REMOVE;
+}
+
+/* Textures rendered before fonts were reloaded may show the wrong font or none at all */
+static void
+check_font_configuration (FontManagerPreviewTextureCache *self)
+{
+    guint generation = font_manager_get_font_configuration_serial();
+    if (generation == self->generation)
+        return;
+    self->generation = generation;
+    font_manager_preview_texture_cache_clear(self);
+    /* Requests already queued are dropped on delivery, allow them to be made again */
+    g_hash_table_remove_all(self->pending);
+    /* Deferred, this is usually reached while previews are being looked up */
+    if (self->invalidate_id == 0)
+        self->invalidate_id = g_idle_add((GSourceFunc) emit_invalidated, self);
+    return;
+}
+
+static gboolean
+deliver_texture (RenderRequest *request)
+{
+    FontManagerPreviewTextureCache *self = request->cache;
+    /* Removed from pending and latest when it was superseded */
+    if (g_atomic_int_get(&request->superseded))
+        return G_SOURCE_REMOVE;
+    g_autofree gchar *sample_key = get_sample_key(request->description, request->text);
+    if (g_hash_table_lookup(self->latest, sample_key) == request)
+        g_hash_table_remove(self->latest, sample_key);
+    /* Rendered with an outdated font configuration, pending no longer refers to this request */
+    if (request->generation != font_manager_get_font_configuration_serial())
+        return G_SOURCE_REMOVE;
+    g_hash_table_remove(self->pending, request->key);
+    /* Style changed while this request was being processed */
+    if (request->pixels == NULL ||
+        request->scale != self->scale ||
+        request->resolution != self->resolution ||
+        !gdk_rgba_equal(&request->color, &self->color))
+        return G_SOURCE_REMOVE;
+    gint width = request->width * request->scale;
+    gint height = request->height * request->scale;
+    CacheEntry *entry = g_new0(CacheEntry, 1);
+    entry->key = g_strdup(request->key);
+    entry->n_bytes = g_bytes_get_size(request->pixels);
+    entry->texture = gdk_memory_texture_new(width, height, GDK_MEMORY_DEFAULT,
+                                            request->pixels, request->stride);
+    g_queue_push_head(&self->entries, entry);
+    g_hash_table_replace(self->index, entry->key, self->entries.head);
+    self->n_bytes += entry->n_bytes;
+    evict(self);
+    g_signal_emit(self, signals[TEXTURE_READY], 0, request->description);
+    return G_SOURCE_REMOVE;
+}
+
+static PangoLayout *
+create_layout (RenderRequest *request)
+{
+    PangoContext *context = pango_font_map_create_context(get_thread_font_map(request->generation));
+    pango_cairo_context_set_resolution(context, request->resolution);
+    pango_context_set_round_glyph_positions(context, FALSE);
+    cairo_font_options_t *options = cairo_font_options_create();
+    cairo_font_options_set_hint_metrics(options, CAIRO_HINT_METRICS_OFF);
+    pango_cairo_context_set_font_options(context, options);
+    PangoLayout *layout = pango_layout_new(context);
+    PangoFontDescription *font_desc = pango_font_description_from_string(request->description);
+    pango_font_description_set_size(font_desc, (gint) (request->size_points * PANGO_SCALE));
+    pango_layout_set_font_description(layout, font_desc);
+    PangoAttrList *attrs = pango_attr_list_new();
+    pango_attr_list_insert(attrs, pango_attr_fallback_new(FALSE));
+    pango_layout_set_attributes(layout, attrs);
+    pango_layout_set_text(layout, request->text, -1);
+    if (request->width > 0) {
+        pango_layout_set_width(layout, request->width * PANGO_SCALE);
+        pango_layout_set_wrap(layout, PANGO_WRAP_WORD_CHAR);
+        pango_layout_set_alignment(layout, PANGO_ALIGN_CENTER);
+    }
+    pango_attr_list_unref(attrs);
+    pango_font_description_free(font_desc);
+    cairo_font_options_destroy(options);
+    g_object_unref(context);
+    return layout;
+}
+
+static void
+render_pixels (RenderRequest *request)
+{
+    gint64 span = font_manager_profiler_begin();
+    request->generation = font_manager_get_font_configuration_serial();
+    PangoLayout *layout = create_layout(request);
+    gint text_width, text_height;
+    pango_layout_get_pixel_size(layout, &text_width, &text_height);
+    /* Sized to fit the text, the key still refers to the requested size */
+    gint max_size = MAX_TEXTURE_SIZE / request->scale;
+    if (request->width <= 0)
+        request->width = CLAMP(text_width, 1, max_size);
+    if (request->height <= 0)
+        request->height = CLAMP(text_height, 1, max_size);
+    gint width = request->width * request->scale;
+    gint height = request->height * request->scale;
+    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    if (cairo_surface_status(surface) == CAIRO_STATUS_SUCCESS) {
+        cairo_t *cr = cairo_create(surface);
+        cairo_scale(cr, request->scale, request->scale);
+        pango_cairo_update_layout(cr, layout);
+        gdk_cairo_set_source_rgba(cr, &request->color);
+        cairo_move_to(cr, 0, MAX((request->height - text_height) / 2, 0));
+        pango_cairo_show_layout(cr, layout);
+        cairo_surface_flush(surface);
+        request->stride = cairo_image_surface_get_stride(surface);
+        request->pixels = g_bytes_new(cairo_image_surface_get_data(surface), request->stride * height);
+        cairo_destroy(cr);
+    }
+    cairo_surface_destroy(surface);
+    g_object_unref(layout);
+    font_manager_profiler_end(span, "PreviewTextureCache.render");
+    return;
+}
+
+static void
+render_preview (RenderRequest *request, G_GNUC_UNUSED gpointer user_data)
+{
+    /* Superseded requests are skipped, they're still released on the main thread */
+    if (!g_atomic_int_get(&request->superseded))
+        render_pixels(request);
+    g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
+                    (GSourceFunc) deliver_texture,
+                    request,
+                    (GDestroyNotify) render_request_free);
+    return;
+}
+
+/* Most recent requests first, those are the ones currently scrolling into view */
+static gint
+compare_requests (gconstpointer a, gconstpointer b, G_GNUC_UNUSED gpointer user_data)
+{
+    guint64 _a = ((const RenderRequest *) a)->serial, _b = ((const RenderRequest *) b)->serial;
+    return (_a < _b) - (_a > _b);
+}
+
+static void
+font_manager_preview_texture_cache_finalize (GObject *gobject)
+{
+    FontManagerPreviewTextureCache *self = FONT_MANAGER_PREVIEW_TEXTURE_CACHE(gobject);
+    g_clear_handle_id(&self->invalidate_id, g_source_remove);
+    /* Queued requests hold a reference, the pool is idle by now */
+    g_thread_pool_free(self->pool, TRUE, TRUE);
+    g_queue_clear_full(&self->entries, (GDestroyNotify) cache_entry_free);
+    g_clear_pointer(&self->index, g_hash_table_destroy);
+    g_clear_pointer(&self->pending, g_hash_table_destroy);
+    g_clear_pointer(&self->latest, g_hash_table_destroy);
+    G_OBJECT_CLASS(font_manager_preview_texture_cache_parent_class)->finalize(gobject);
+    return;
+}
+
+static void
+font_manager_preview_texture_cache_class_init (FontManagerPreviewTextureCacheClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    object_class->finalize = font_manager_preview_texture_cache_finalize;
+
+    /**
+     * FontManagerPreviewTextureCache::invalidated:
+     *
+     * Emitted when cached textures were dropped because the style changed
+     * or fonts were reloaded.
+     */
+    signals[INVALIDATED] = g_signal_new(g_intern_static_string("invalidated"),
+                                        G_TYPE_FROM_CLASS(klass),
+                                        G_SIGNAL_RUN_LAST,
+                                        0, NULL, NULL, NULL,
+                                        G_TYPE_NONE, 0);
+
+    /**
+     * FontManagerPreviewTextureCache::texture-ready:
+     * @description:    font description of the texture which was added
+     *
+     * Emitted when a requested texture has been rendered and is available.
+     */
+    signals[TEXTURE_READY] = g_signal_new(g_intern_static_string("texture-ready"),
+                                          G_TYPE_FROM_CLASS(klass),
+                                          G_SIGNAL_RUN_LAST,
+                                          0, NULL, NULL, NULL,
+                                          G_TYPE_NONE, 1, G_TYPE_STRING);
+    return;
+}
+
+static void
+font_manager_preview_texture_cache_init (FontManagerPreviewTextureCache *self)
+{
+    g_return_if_fail(self != NULL);
+    self->scale = 1;
+    self->resolution = 96.0;
+    self->generation = font_manager_get_font_configuration_serial();
+    self->color = (GdkRGBA) { 0.0, 0.0, 0.0, 1.0 };
+    g_queue_init(&self->entries);
+    self->index = g_hash_table_new(g_str_hash, g_str_equal);
+    self->pending = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    self->latest = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    gint n_threads = CLAMP((gint) g_get_num_processors() - 1, 1, MAX_RENDER_THREADS);
+    self->pool = g_thread_pool_new((GFunc) render_preview, NULL, n_threads, FALSE, NULL);
+    g_thread_pool_set_sort_function(self->pool, compare_requests, NULL);
+    return;
+}
+
+/**
+ * font_manager_preview_texture_cache_update_style:
+ * @self:       #FontManagerPreviewTextureCache
+ * @widget:     #GtkWidget previews will be displayed in
+ *
+ * Uses the foreground color, scale factor and resolution of @widget for new
+ * textures. If any of them changed all cached textures are dropped and
+ * #FontManagerPreviewTextureCache::invalidated is emitted.
+ */
+void
+font_manager_preview_texture_cache_update_style (FontManagerPreviewTextureCache *self,
+                                                 GtkWidget                      *widget)
+{
+    g_return_if_fail(FONT_MANAGER_IS_PREVIEW_TEXTURE_CACHE(self));
+    g_return_if_fail(GTK_IS_WIDGET(widget));
+    GdkRGBA color;
+    gtk_widget_get_color(widget, &color);
+    gint scale = MAX(gtk_widget_get_scale_factor(widget), 1);
+    gdouble resolution = pango_cairo_context_get_resolution(gtk_widget_get_pango_context(widget));
+    /* Negative if unset, Pango falls back to 96 in that case as well */
+    if (resolution <= 0)
+        resolution = 96.0;
+    if (scale == self->scale && resolution == self->resolution && gdk_rgba_equal(&color, &self->color))
+        return;
+    self->scale = scale;
+    self->resolution = resolution;
+    self->color = color;
+    font_manager_preview_texture_cache_clear(self);
+    g_signal_emit(self, signals[INVALIDATED], 0);
+    return;
+}
+
+/**
+ * font_manager_preview_texture_cache_get_resolution:
+ * @self:       #FontManagerPreviewTextureCache
+ *
+ * Useful to convert sizes in pixels to the point sizes textures are keyed by.
+ *
+ * Returns: resolution textures are rendered at, in dots per inch
+ */
+gdouble
+font_manager_preview_texture_cache_get_resolution (FontManagerPreviewTextureCache *self)
+{
+    g_return_val_if_fail(FONT_MANAGER_IS_PREVIEW_TEXTURE_CACHE(self), 96.0);
+    return self->resolution;
+}
+
+/**
+ * font_manager_preview_texture_cache_lookup:
+ * @self:           #FontManagerPreviewTextureCache
+ * @description:    string representation of a #PangoFontDescription
+ * @text:           preview text
+ * @size_points:    preview size in points
+ * @width:          width of the preview area in logical pixels or -1
+ * @height:         height of the preview area in logical pixels or -1
+ *
+ * Returns: (transfer full) (nullable): #GdkTexture or %NULL if no matching
+ * texture has been rendered yet.
+ */
+GdkTexture *
+font_manager_preview_texture_cache_lookup (FontManagerPreviewTextureCache *self,
+                                           const gchar                    *description,
+                                           const gchar                    *text,
+                                           gdouble                         size_points,
+                                           gint                            width,
+                                           gint                            height)
+{
+    g_return_val_if_fail(FONT_MANAGER_IS_PREVIEW_TEXTURE_CACHE(self), NULL);
+    g_return_val_if_fail(description != NULL && text != NULL, NULL);
+    check_font_configuration(self);
+    g_autofree gchar *key = get_key(description, text, size_points, width, height);
+    GList *link = g_hash_table_lookup(self->index, key);
+    if (link == NULL)
+        return NULL;
+    g_queue_unlink(&self->entries, link);
+    g_queue_push_head_link(&self->entries, link);
+    return g_object_ref(((CacheEntry *) link->data)->texture);
+}
+
+/**
+ * font_manager_preview_texture_cache_request:
+ * @self:           #FontManagerPreviewTextureCache
+ * @description:    string representation of a #PangoFontDescription
+ * @text:           preview text
+ * @size_points:    preview size in points
+ * @width:          width of the preview area in logical pixels or -1
+ * @height:         height of the preview area in logical pixels or -1
+ *
+ * Queues a texture to be rendered in the background unless it is already
+ * cached or pending. #FontManagerPreviewTextureCache::texture-ready is emitted
+ * once it is available. A pending request for the same @description and @text
+ * at another size or pixel size is superseded and will not be rendered.
+ *
+ * If @width is -1 the text is rendered on a single line and the texture is
+ * sized to fit it. If only @height is -1 it is sized to fit the wrapped text.
+ */
+void
+font_manager_preview_texture_cache_request (FontManagerPreviewTextureCache *self,
+                                            const gchar                    *description,
+                                            const gchar                    *text,
+                                            gdouble                         size_points,
+                                            gint                            width,
+                                            gint                            height)
+{
+    g_return_if_fail(FONT_MANAGER_IS_PREVIEW_TEXTURE_CACHE(self));
+    g_return_if_fail(description != NULL && text != NULL);
+    if (width == 0 || height == 0)
+        return;
+    check_font_configuration(self);
+    gchar *key = get_key(description, text, size_points, width, height);
+    if (g_hash_table_contains(self->index, key) || g_hash_table_contains(self->pending, key)) {
+        g_free(key);
+        return;
+    }
+    /* Superseded requests are still queued but skipped by the workers,
+     * only those which will actually be rendered count towards the limit */
+    gchar *sample_key = get_sample_key(description, text);
+    RenderRequest *previous = g_hash_table_lookup(self->latest, sample_key);
+    if (previous != NULL) {
+        g_atomic_int_set(&previous->superseded, TRUE);
+        g_hash_table_remove(self->pending, previous->key);
+        g_hash_table_remove(self->latest, sample_key);
+    } else if (g_hash_table_size(self->latest) >= MAX_QUEUED_REQUESTS) {
+        g_free(sample_key);
+        g_free(key);
+        return;
+    }
+    g_hash_table_add(self->pending, key);
+    RenderRequest *request = g_new0(RenderRequest, 1);
+    request->cache = g_object_ref(self);
+    request->key = g_strdup(key);
+    request->description = g_strdup(description);
+    request->text = g_strdup(text);
+    request->size_points = size_points;
+    request->width = width;
+    request->height = height;
+    request->scale = self->scale;
+    request->resolution = self->resolution;
+    request->color = self->color;
+    request->serial = self->serial++;
+    g_hash_table_insert(self->latest, sample_key, request);
+    g_thread_pool_push(self->pool, request, NULL);
+    return;
+}
+
+/**
+ * font_manager_preview_texture_cache_clear:
+ * @self:   #FontManagerPreviewTextureCache
+ *
+ * Drops all cached textures.
+ */
+void
+font_manager_preview_texture_cache_clear (FontManagerPreviewTextureCache *self)
+{
+    g_return_if_fail(FONT_MANAGER_IS_PREVIEW_TEXTURE_CACHE(self));
+    g_hash_table_remove_all(self->index);
+    g_queue_clear_full(&self->entries, (GDestroyNotify) cache_entry_free);
+    self->n_bytes = 0;
+    return;
+}
+
+/**
+ * font_manager_preview_texture_cache_new:
+ * @max_bytes:  maximum amount of pixel data to keep around
+ *
+ * Returns: (transfer full): A newly created #FontManagerPreviewTextureCache.
+ * Free the returned object using #g_object_unref().
+ */
+FontManagerPreviewTextureCache *
+font_manager_preview_texture_cache_new (gsize max_bytes)
+{
+    FontManagerPreviewTextureCache *self = g_object_new(FONT_MANAGER_TYPE_PREVIEW_TEXTURE_CACHE, NULL);
+    self->max_bytes = max_bytes;
+    return self;
+}
@@ -0,0 +1,49 @@
+/* font-manager-preview-texture-cache.h
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#pragma once
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gtk/gtk.h>
+#include <pango/pangocairo.h>
+
+#include "font-manager-utils.h"
+
+#define FONT_MANAGER_TYPE_PREVIEW_TEXTURE_CACHE (font_manager_preview_texture_cache_get_type())
+G_DECLARE_FINAL_TYPE(FontManagerPreviewTextureCache, font_manager_preview_texture_cache, FONT_MANAGER, PREVIEW_TEXTURE_CACHE, GObject)
+
+FontManagerPreviewTextureCache * font_manager_preview_texture_cache_new (gsize max_bytes);
+void font_manager_preview_texture_cache_update_style (FontManagerPreviewTextureCache *self,
+                                                      GtkWidget *widget);
+gdouble font_manager_preview_texture_cache_get_resolution (FontManagerPreviewTextureCache *self);
+GdkTexture * font_manager_preview_texture_cache_lookup (FontManagerPreviewTextureCache *self,
+                                                        const gchar *description,
+                                                        const gchar *text,
+                                                        gdouble size_points,
+                                                        gint width,
+                                                        gint height);
+void font_manager_preview_texture_cache_request (FontManagerPreviewTextureCache *self,
+                                                 const gchar *description,
+                                                 const gchar *text,
+                                                 gdouble size_points,
+                                                 gint width,
+                                                 gint height);
+void font_manager_preview_texture_cache_clear (FontManagerPreviewTextureCache *self);
@@ -0,0 +1,583 @@
+/* font-manager-waterfall-view.c
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#include "font-manager-waterfall-view.h"
+
+/**
+ * SECTION: font-manager-waterfall-view
+ * @short_description: Waterfall preview of a font
+ * @title: Waterfall View
+ * @include: font-manager-waterfall-view.h
+ *
+ * Widget which displays a line of text at increasing point sizes.
+ *
+ * Row positions are computed from the extents of the text at a reference size,
+ * only rows which are actually visible get shaped and rendered. Shaped rows are
+ * cached per font and size so switching back to a previously selected font is cheap.
+ *
+ * Rows are drawn directly, unlike a #GtkTextView the text cannot be selected or copied.
+ */
+
+/* Size used to measure text extents, row geometry is scaled from these */
+#define REFERENCE_SIZE 100.0
+/* Shaped layouts kept around, the cache is cleared once it grows past this */
+#define LAYOUT_CACHE_SIZE 256
+
+struct _FontManagerWaterfallView
+{
+    GtkWidget   parent;
+
+    gchar                   *text;
+    gchar                   *font_key;      /* font description as a string */
+    PangoFontDescription    *font_desc;
+    GArray                  *sizes;         /* gdouble, point size of each row */
+    GArray                  *offsets;       /* gint, y offset of each row plus total height */
+    GHashTable              *layouts;       /* "font_key size" -> PangoLayout */
+    PangoLayout             *size_layout;   /* line size labels */
+
+    gdouble     min_size;
+    gdouble     max_size;
+    gdouble     ratio;
+    gdouble     ref_width;      /* text extents at REFERENCE_SIZE in pixels */
+    gdouble     ref_height;
+    gint        label_width;
+    gint        label_height;
+    gint        content_width;
+    gint        line_spacing;
+    gboolean    show_line_size;
+
+    guint hscroll_policy : 1;
+    guint vscroll_policy : 1;
+    GtkAdjustment *hadjustment;
+    GtkAdjustment *vadjustment;
+};
+
+G_DEFINE_TYPE_WITH_CODE(FontManagerWaterfallView, font_manager_waterfall_view, GTK_TYPE_WIDGET,
+                        G_IMPLEMENT_INTERFACE(GTK_TYPE_SCROLLABLE, NULL))
+
+enum
+{
+    PROP_RESERVED,
+    PROP_HADJUSTMENT,
+    PROP_VADJUSTMENT,
+    PROP_HSCROLL_POLICY,
+    PROP_VSCROLL_POLICY,
+    N_PROPERTIES
+};
+
+static gint
+get_content_height (FontManagerWaterfallView *self)
+{
+    return g_array_index(self->offsets, gint, self->offsets->len - 1);
+}
+
+static void
+configure_adjustment (GtkAdjustment *adjustment, gint content_size, gint page_size)
+{
+    if (adjustment == NULL)
+        return;
+    gdouble upper = MAX(content_size, page_size);
+    gdouble value = CLAMP(gtk_adjustment_get_value(adjustment), 0, upper - page_size);
+    gtk_adjustment_configure(adjustment,
+                             value,
+                             0, /* lower */
+                             upper,
+                             page_size * 0.1, /* step increment */
+                             page_size * 0.9, /* page increment */
+                             page_size);
+    return;
+}
+
+static void
+update_adjustments (FontManagerWaterfallView *self)
+{
+    GtkWidget *widget = GTK_WIDGET(self);
+    configure_adjustment(self->hadjustment, self->content_width, gtk_widget_get_width(widget));
+    configure_adjustment(self->vadjustment, get_content_height(self), gtk_widget_get_height(widget));
+    return;
+}
+
+static PangoLayout *
+create_layout (FontManagerWaterfallView *self, gdouble size)
+{
+    gint64 span = font_manager_profiler_begin();
+    PangoLayout *layout = gtk_widget_create_pango_layout(GTK_WIDGET(self), self->text);
+    g_autoptr(PangoFontDescription) font_desc = pango_font_description_copy(self->font_desc);
+    pango_font_description_set_size(font_desc, (gint) (size * PANGO_SCALE));
+    pango_layout_set_font_description(layout, font_desc);
+    g_autoptr(PangoAttrList) attrs = pango_attr_list_new();
+    pango_attr_list_insert(attrs, pango_attr_fallback_new(FALSE));
+    pango_layout_set_attributes(layout, attrs);
+    font_manager_profiler_end(span, "WaterfallView.shape");
+    return layout;
+}
+
+static PangoLayout *
+get_layout (FontManagerWaterfallView *self, gdouble size)
+{
+    g_autofree gchar *key = g_strdup_printf("%s %g", self->font_key, size);
+    PangoLayout *layout = g_hash_table_lookup(self->layouts, key);
+    if (layout != NULL)
+        return layout;
+    if (g_hash_table_size(self->layouts) >= LAYOUT_CACHE_SIZE)
+        g_hash_table_remove_all(self->layouts);
+    layout = create_layout(self, size);
+    g_hash_table_insert(self->layouts, g_steal_pointer(&key), layout);
+    return layout;
+}
+
+static void
+clear_layouts (FontManagerWaterfallView *self)
+{
+    g_hash_table_remove_all(self->layouts);
+    g_clear_object(&self->size_layout);
+    return;
+}
+
+static void
+set_size_label (FontManagerWaterfallView *self, gint size)
+{
+    g_autofree gchar *label = g_strdup_printf(size < 10 ? " %ipt.  " : "%ipt.  ", size);
+    pango_layout_set_text(self->size_layout, label, -1);
+    return;
+}
+
+static void
+ensure_size_layout (FontManagerWaterfallView *self)
+{
+    if (self->size_layout != NULL)
+        return;
+    self->size_layout = gtk_widget_create_pango_layout(GTK_WIDGET(self), NULL);
+    g_autoptr(PangoFontDescription) font_desc = pango_font_description_from_string("Monospace 6.5");
+    pango_layout_set_font_description(self->size_layout, font_desc);
+    /* Widest label we'll display */
+    set_size_label(self, (gint) self->max_size);
+    pango_layout_get_pixel_size(self->size_layout, &self->label_width, &self->label_height);
+    return;
+}
+
+static void
+update_sizes (FontManagerWaterfallView *self)
+{
+    g_array_set_size(self->sizes, 0);
+    for (gdouble size = floor(self->min_size); size <= self->max_size;) {
+        g_array_append_val(self->sizes, size);
+        if (self->ratio > 1.0) {
+            gdouble next = size * self->ratio;
+            next = self->ratio > 1.1 ? floor(next) : ceil(next);
+            /* Small sizes and ratios could otherwise get stuck on the same size */
+            size = MAX(next, size + 1);
+        } else
+            size++;
+    }
+    return;
+}
+
+/* Row geometry is computed from the extents of the text at REFERENCE_SIZE,
+ * text extents scale linearly with point size so no other row needs to be shaped. */
+static void
+update_geometry (FontManagerWaterfallView *self)
+{
+    gint64 span = font_manager_profiler_begin();
+    self->ref_width = self->ref_height = 0;
+    if (self->font_desc != NULL && self->text != NULL) {
+        PangoRectangle logical;
+        g_autoptr(PangoLayout) layout = create_layout(self, REFERENCE_SIZE);
+        pango_layout_get_extents(layout, NULL, &logical);
+        self->ref_width = (gdouble) logical.width / PANGO_SCALE;
+        self->ref_height = (gdouble) logical.height / PANGO_SCALE;
+    }
+    ensure_size_layout(self);
+    gint label_width = self->show_line_size ? self->label_width : 0;
+    gint y = 0;
+    g_array_set_size(self->offsets, 0);
+    for (guint i = 0; i < self->sizes->len; i++) {
+        gdouble size = g_array_index(self->sizes, gdouble, i);
+        gint height = (gint) ceil(self->ref_height * size / REFERENCE_SIZE);
+        g_array_append_val(self->offsets, y);
+        y += MAX(height, self->label_height) + (self->line_spacing * 2);
+    }
+    g_array_append_val(self->offsets, y);
+    gdouble max_size = self->sizes->len > 0 ? g_array_index(self->sizes, gdouble, self->sizes->len - 1) : 0;
+    self->content_width = label_width + (gint) ceil(self->ref_width * max_size / REFERENCE_SIZE);
+    update_adjustments(self);
+    gtk_widget_queue_resize(GTK_WIDGET(self));
+    font_manager_profiler_end(span, "WaterfallView.geometry");
+    return;
+}
+
+/* Returns the row at y or the number of rows if y is past the end */
+static guint
+get_row_at_y (FontManagerWaterfallView *self, gint y)
+{
+    guint min = 0, max = self->sizes->len;
+    while (min < max) {
+        guint mid = (min + max) / 2;
+        if (g_array_index(self->offsets, gint, mid + 1) <= y)
+            min = mid + 1;
+        else
+            max = mid;
+    }
+    return min;
+}
+
+static void
+font_manager_waterfall_view_snapshot (GtkWidget *widget, GtkSnapshot *snapshot)
+{
+    FontManagerWaterfallView *self = FONT_MANAGER_WATERFALL_VIEW(widget);
+    if (self->font_desc == NULL || self->text == NULL)
+        return;
+    gint64 span = font_manager_profiler_begin();
+    gint width = gtk_widget_get_width(widget);
+    gint height = gtk_widget_get_height(widget);
+    gdouble x_offset = self->hadjustment ? gtk_adjustment_get_value(self->hadjustment) : 0;
+    gdouble y_offset = self->vadjustment ? gtk_adjustment_get_value(self->vadjustment) : 0;
+    gint label_width = self->show_line_size ? self->label_width : 0;
+    GdkRGBA color;
+    gtk_widget_get_color(widget, &color);
+    ensure_size_layout(self);
+    gtk_snapshot_push_clip(snapshot, &GRAPHENE_RECT_INIT(0, 0, width, height));
+    gtk_snapshot_translate(snapshot, &GRAPHENE_POINT_INIT(-x_offset, -y_offset));
+    for (guint row = get_row_at_y(self, (gint) y_offset); row < self->sizes->len; row++) {
+        gint y = g_array_index(self->offsets, gint, row);
+        if (y >= y_offset + height)
+            break;
+        gdouble size = g_array_index(self->sizes, gdouble, row);
+        PangoLayout *layout = get_layout(self, size);
+        gint baseline = pango_layout_get_baseline(layout) / PANGO_SCALE;
+        y += self->line_spacing;
+        if (self->show_line_size) {
+            set_size_label(self, (gint) size);
+            gint label_baseline = pango_layout_get_baseline(self->size_layout) / PANGO_SCALE;
+            gtk_snapshot_save(snapshot);
+            gtk_snapshot_translate(snapshot, &GRAPHENE_POINT_INIT(0, y + MAX(baseline - label_baseline, 0)));
+            gtk_snapshot_append_layout(snapshot, self->size_layout, &color);
+            gtk_snapshot_restore(snapshot);
+        }
+        gtk_snapshot_save(snapshot);
+        gtk_snapshot_translate(snapshot, &GRAPHENE_POINT_INIT(label_width, y));
+        gtk_snapshot_append_layout(snapshot, layout, &color);
+        gtk_snapshot_restore(snapshot);
+    }
+    gtk_snapshot_pop(snapshot);
+    font_manager_profiler_end(span, "WaterfallView.snapshot");
+    return;
+}
+
+static void
+font_manager_waterfall_view_measure (GtkWidget      *widget,
+                                     GtkOrientation  orientation,
+                                     int             for_size,
+                                     int            *minimum,
+                                     int            *natural,
+                                     int            *minimum_baseline,
+                                     int            *natural_baseline)
+{
+    FontManagerWaterfallView *self = FONT_MANAGER_WATERFALL_VIEW(widget);
+    *minimum = 0;
+    *natural = orientation == GTK_ORIENTATION_HORIZONTAL ?
+               self->content_width : get_content_height(self);
+    return;
+}
+
+static void
+font_manager_waterfall_view_size_allocate (GtkWidget *widget,
+                                           int        width,
+                                           int        height,
+                                           int        baseline)
+{
+    update_adjustments(FONT_MANAGER_WATERFALL_VIEW(widget));
+    return;
+}
+
+static void
+font_manager_waterfall_view_root (GtkWidget *widget)
+{
+    GTK_WIDGET_CLASS(font_manager_waterfall_view_parent_class)->root(widget);
+    /* Pango context may differ once we're part of a window */
+    FontManagerWaterfallView *self = FONT_MANAGER_WATERFALL_VIEW(widget);
+    clear_layouts(self);
+    update_geometry(self);
+    return;
+}
+
+static void
+set_adjustment (FontManagerWaterfallView  *self,
+                GtkAdjustment            **target,
+                GtkAdjustment             *adjustment)
+{
+    if (adjustment)
+        g_return_if_fail(GTK_IS_ADJUSTMENT(adjustment));
+    else
+        adjustment = gtk_adjustment_new(0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
+    if (*target == adjustment)
+        return;
+    if (*target) {
+        g_signal_handlers_disconnect_by_func(*target, gtk_widget_queue_draw, self);
+        g_clear_object(target);
+    }
+    *target = g_object_ref_sink(adjustment);
+    g_signal_connect_swapped(adjustment, "value-changed", G_CALLBACK(gtk_widget_queue_draw), self);
+    update_adjustments(self);
+    return;
+}
+
+static void
+font_manager_waterfall_view_dispose (GObject *gobject)
+{
+    g_return_if_fail(gobject != NULL);
+    FontManagerWaterfallView *self = FONT_MANAGER_WATERFALL_VIEW(gobject);
+    if (self->hadjustment)
+        g_signal_handlers_disconnect_by_func(self->hadjustment, gtk_widget_queue_draw, self);
+    if (self->vadjustment)
+        g_signal_handlers_disconnect_by_func(self->vadjustment, gtk_widget_queue_draw, self);
+    g_clear_object(&self->hadjustment);
+    g_clear_object(&self->vadjustment);
+    g_clear_object(&self->size_layout);
+    g_clear_pointer(&self->layouts, g_hash_table_destroy);
+    g_clear_pointer(&self->sizes, g_array_unref);
+    g_clear_pointer(&self->offsets, g_array_unref);
+    g_clear_pointer(&self->font_desc, pango_font_description_free);
+    g_clear_pointer(&self->font_key, g_free);
+    g_clear_pointer(&self->text, g_free);
+    font_manager_widget_dispose(GTK_WIDGET(self));
+    G_OBJECT_CLASS(font_manager_waterfall_view_parent_class)->dispose(gobject);
+    return;
+}
+
+static void
+font_manager_waterfall_view_get_property (GObject    *gobject,
+                                          guint       prop_id,
+                                          GValue     *value,
+                                          GParamSpec *pspec)
+{
+    g_return_if_fail(gobject != NULL);
+    FontManagerWaterfallView *self = FONT_MANAGER_WATERFALL_VIEW(gobject);
+    switch (prop_id) {
+        case PROP_HADJUSTMENT:
+            g_value_set_object(value, self->hadjustment);
+            break;
+        case PROP_VADJUSTMENT:
+            g_value_set_object(value, self->vadjustment);
+            break;
+        case PROP_HSCROLL_POLICY:
+            g_value_set_enum(value, self->hscroll_policy);
+            break;
+        case PROP_VSCROLL_POLICY:
+            g_value_set_enum(value, self->vscroll_policy);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, prop_id, pspec);
+            break;
+    }
+    return;
+}
+
+static void
+font_manager_waterfall_view_set_property (GObject      *gobject,
+                                          guint         prop_id,
+                                          const GValue *value,
+                                          GParamSpec   *pspec)
+{
+    g_return_if_fail(gobject != NULL);
+    FontManagerWaterfallView *self = FONT_MANAGER_WATERFALL_VIEW(gobject);
+    switch (prop_id) {
+        case PROP_HADJUSTMENT:
+            set_adjustment(self, &self->hadjustment, g_value_get_object(value));
+            break;
+        case PROP_VADJUSTMENT:
+            set_adjustment(self, &self->vadjustment, g_value_get_object(value));
+            break;
+        case PROP_HSCROLL_POLICY:
+            self->hscroll_policy = g_value_get_enum(value);
+            gtk_widget_queue_resize(GTK_WIDGET(self));
+            break;
+        case PROP_VSCROLL_POLICY:
+            self->vscroll_policy = g_value_get_enum(value);
+            gtk_widget_queue_resize(GTK_WIDGET(self));
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, prop_id, pspec);
+            break;
+    }
+    return;
+}
+
+static void
+font_manager_waterfall_view_class_init (FontManagerWaterfallViewClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    GtkWidgetClass *widget_class = GTK_WIDGET_CLASS(klass);
+
+    object_class->dispose = font_manager_waterfall_view_dispose;
+    object_class->get_property = font_manager_waterfall_view_get_property;
+    object_class->set_property = font_manager_waterfall_view_set_property;
+    widget_class->snapshot = font_manager_waterfall_view_snapshot;
+    widget_class->measure = font_manager_waterfall_view_measure;
+    widget_class->size_allocate = font_manager_waterfall_view_size_allocate;
+    widget_class->root = font_manager_waterfall_view_root;
+
+    /* GtkScrollable interface properties */
+    g_object_class_override_property(object_class, PROP_HADJUSTMENT, "hadjustment");
+    g_object_class_override_property(object_class, PROP_VADJUSTMENT, "vadjustment");
+    g_object_class_override_property(object_class, PROP_HSCROLL_POLICY, "hscroll-policy");
+    g_object_class_override_property(object_class, PROP_VSCROLL_POLICY, "vscroll-policy");
+    return;
+}
+
+static void
+font_manager_waterfall_view_init (FontManagerWaterfallView *self)
+{
+    g_return_if_fail(self != NULL);
+    self->min_size = FONT_MANAGER_MIN_FONT_SIZE;
+    self->max_size = FONT_MANAGER_MAX_FONT_SIZE / 2;
+    self->ratio = 1.0;
+    self->show_line_size = TRUE;
+    self->hscroll_policy = GTK_SCROLL_NATURAL;
+    self->vscroll_policy = GTK_SCROLL_NATURAL;
+    self->sizes = g_array_new(FALSE, FALSE, sizeof(gdouble));
+    self->offsets = g_array_new(FALSE, FALSE, sizeof(gint));
+    self->layouts = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_object_unref);
+    font_manager_widget_set_name(GTK_WIDGET(self), "FontManagerWaterfallView");
+    update_sizes(self);
+    update_geometry(self);
+    return;
+}
+
+/**
+ * font_manager_waterfall_view_set_font_desc:
+ * @self:                       #FontManagerWaterfallView
+ * @font_desc: (transfer none): #PangoFontDescription
+ *
+ * Sets the font used to display the waterfall, size is ignored.
+ */
+void
+font_manager_waterfall_view_set_font_desc (FontManagerWaterfallView   *self,
+                                           const PangoFontDescription *font_desc)
+{
+    g_return_if_fail(FONT_MANAGER_IS_WATERFALL_VIEW(self));
+    g_return_if_fail(font_desc != NULL);
+    if (self->font_desc && pango_font_description_equal(font_desc, self->font_desc))
+        return;
+    g_clear_pointer(&self->font_desc, pango_font_description_free);
+    g_clear_pointer(&self->font_key, g_free);
+    self->font_desc = pango_font_description_copy(font_desc);
+    pango_font_description_unset_fields(self->font_desc, PANGO_FONT_MASK_SIZE);
+    self->font_key = pango_font_description_to_string(self->font_desc);
+    update_geometry(self);
+    if (self->vadjustment)
+        gtk_adjustment_set_value(self->vadjustment, 0);
+    gtk_widget_queue_draw(GTK_WIDGET(self));
+    return;
+}
+
+/**
+ * font_manager_waterfall_view_set_text:
+ * @self:       #FontManagerWaterfallView
+ * @text:       Text to display on each line
+ */
+void
+font_manager_waterfall_view_set_text (FontManagerWaterfallView *self, const gchar *text)
+{
+    g_return_if_fail(FONT_MANAGER_IS_WATERFALL_VIEW(self));
+    if (g_strcmp0(text, self->text) == 0)
+        return;
+    g_clear_pointer(&self->text, g_free);
+    self->text = text ? g_utf8_make_valid(text, -1) : NULL;
+    /* Every cached layout holds the previous text */
+    g_hash_table_remove_all(self->layouts);
+    update_geometry(self);
+    gtk_widget_queue_draw(GTK_WIDGET(self));
+    return;
+}
+
+/**
+ * font_manager_waterfall_view_set_sizes:
+ * @self:           #FontManagerWaterfallView
+ * @min_size:       Point size of the first line
+ * @max_size:       Maximum point size
+ * @ratio:          Waterfall point size common ratio, 1.0 to increase by one point per line
+ */
+void
+font_manager_waterfall_view_set_sizes (FontManagerWaterfallView *self,
+                                       gdouble                   min_size,
+                                       gdouble                   max_size,
+                                       gdouble                   ratio)
+{
+    g_return_if_fail(FONT_MANAGER_IS_WATERFALL_VIEW(self));
+    if (self->min_size == min_size && self->max_size == max_size && self->ratio == ratio)
+        return;
+    self->min_size = min_size;
+    self->max_size = max_size;
+    self->ratio = ratio;
+    /* Label width depends on the maximum size */
+    g_clear_object(&self->size_layout);
+    update_sizes(self);
+    update_geometry(self);
+    gtk_widget_queue_draw(GTK_WIDGET(self));
+    return;
+}
+
+/**
+ * font_manager_waterfall_view_set_show_line_size:
+ * @self:               #FontManagerWaterfallView
+ * @show_line_size:     Whether to display the point size at the start of each line
+ */
+void
+font_manager_waterfall_view_set_show_line_size (FontManagerWaterfallView *self,
+                                                gboolean                  show_line_size)
+{
+    g_return_if_fail(FONT_MANAGER_IS_WATERFALL_VIEW(self));
+    if (self->show_line_size == show_line_size)
+        return;
+    self->show_line_size = show_line_size;
+    update_geometry(self);
+    gtk_widget_queue_draw(GTK_WIDGET(self));
+    return;
+}
+
+/**
+ * font_manager_waterfall_view_set_line_spacing:
+ * @self:               #FontManagerWaterfallView
+ * @line_spacing:       Pixels above and below each line
+ */
+void
+font_manager_waterfall_view_set_line_spacing (FontManagerWaterfallView *self, gint line_spacing)
+{
+    g_return_if_fail(FONT_MANAGER_IS_WATERFALL_VIEW(self));
+    if (self->line_spacing == line_spacing)
+        return;
+    self->line_spacing = line_spacing;
+    update_geometry(self);
+    gtk_widget_queue_draw(GTK_WIDGET(self));
+    return;
+}
+
+/**
+ * font_manager_waterfall_view_new:
+ *
+ * Returns: (transfer full): A newly created #FontManagerWaterfallView.
+ * Free the returned object using #g_object_unref().
+ */
+GtkWidget *
+font_manager_waterfall_view_new (void)
+{
+    return g_object_new(FONT_MANAGER_TYPE_WATERFALL_VIEW, NULL);
+}
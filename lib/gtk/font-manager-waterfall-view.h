@@ -0,0 +1,45 @@
+/* font-manager-waterfall-view.h
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#pragma once
+
+#include <math.h>
+#include <glib.h>
+#include <gtk/gtk.h>
+#include <graphene.h>
+#include <pango/pango.h>
+
+#include "font-manager-gtk-utils.h"
+#include "font-manager-utils.h"
+
+#define FONT_MANAGER_TYPE_WATERFALL_VIEW (font_manager_waterfall_view_get_type())
+G_DECLARE_FINAL_TYPE(FontManagerWaterfallView, font_manager_waterfall_view, FONT_MANAGER, WATERFALL_VIEW, GtkWidget)
+
+GtkWidget * font_manager_waterfall_view_new (void);
+void font_manager_waterfall_view_set_font_desc (FontManagerWaterfallView *self,
+                                                const PangoFontDescription *font_desc);
+void font_manager_waterfall_view_set_text (FontManagerWaterfallView *self, const gchar *text);
+void font_manager_waterfall_view_set_sizes (FontManagerWaterfallView *self,
+                                            gdouble min_size,
+                                            gdouble max_size,
+                                            gdouble ratio);
+void font_manager_waterfall_view_set_show_line_size (FontManagerWaterfallView *self,
+                                                     gboolean show_line_size);
+void font_manager_waterfall_view_set_line_spacing (FontManagerWaterfallView *self, gint line_spacing);
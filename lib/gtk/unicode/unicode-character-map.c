@@ -42,6 +42,12 @@
 #define VALID_FONT_SIZE(X) (X < 6.0 ? 6.0 : X > 96.0 ? 96.0 : X)
 #define FIRST_CELL_IN_SAME_ROW(x) ((x) - ((x) % self->columns))
 #define N_REGIONAL_INDICATORS G_N_ELEMENTS(FontManagerRegionalIndicatorSymbols)
+/* Rendered glyphs kept around, the cache is cleared once it grows past this */
+#define GLYPH_CACHE_SIZE 8192
+/* Cache key for a cell, regional indicator pairs are placed past the end of Unicode */
+#define GLYPH_CACHE_KEY(c1,c2) GUINT_TO_POINTER((c2) == 0 ? (c1) : \
+    FONT_MANAGER_UNICHAR_MAX + 1 + ((c1) - FONT_MANAGER_RIS_START_POINT) * 26 + \
+    ((c2) - FONT_MANAGER_RIS_START_POINT))
 
 enum
 {
@@ -96,10 +102,34 @@ struct _FontManagerUnicodeCharacterMap
     /* Character set information */
     gboolean has_regional_indicator_symbols;
     gboolean is_regional_indicator_filter;
-    GList *charset;
-    GList *filter;
+    /* Sorted array of gunichar */
+    GArray *charset;
+    /* Array of gunichar in the order given to set_filter, filter_index maps them back */
+    GArray *filter;
+    GHashTable *filter_index;
+    /* Incremented whenever charset or filter change, cell indices are only valid for one serial */
+    guint charset_serial;
+    /* GlyphCacheEntry keyed by GLYPH_CACHE_KEY, only valid for current font, size and color */
+    GHashTable *glyph_cache;
+    GdkRGBA glyph_color;
 };
 
+typedef struct
+{
+    GskRenderNode *node;    /* NULL if the font has no glyph for this cell */
+    gint width;
+    gint height;
+}
+GlyphCacheEntry;
+
+static void
+glyph_cache_entry_free (GlyphCacheEntry *entry)
+{
+    g_clear_pointer(&entry->node, gsk_render_node_unref);
+    g_free(entry);
+    return;
+}
+
 G_DEFINE_TYPE_WITH_CODE (FontManagerUnicodeCharacterMap, font_manager_unicode_character_map,
                          GTK_TYPE_DRAWING_AREA,
                          G_IMPLEMENT_INTERFACE(GTK_TYPE_SCROLLABLE, NULL))
@@ -128,6 +158,9 @@ clear_pango_layout (FontManagerUnicodeCharacterMap *self)
     g_return_if_fail(self != NULL);
     g_clear_object(&self->pango_layout);
     g_clear_object(&self->zoom_layout);
+    /* Cached glyphs were rendered using the old layout */
+    if (self->glyph_cache)
+        g_hash_table_remove_all(self->glyph_cache);
     return;
 }
 
@@ -158,6 +191,29 @@ ensure_pango_layout (FontManagerUnicodeCharacterMap *self)
     return;
 }
 
+static gint
+get_charset_length (FontManagerUnicodeCharacterMap *self)
+{
+    return self->charset != NULL ? (gint) self->charset->len : 0;
+}
+
+static gint
+get_charset_index (FontManagerUnicodeCharacterMap *self, gunichar codepoint)
+{
+    gint low = 0, high = get_charset_length(self) - 1;
+    while (low <= high) {
+        gint mid = low + ((high - low) / 2);
+        gunichar value = g_array_index(self->charset, gunichar, mid);
+        if (value == codepoint)
+            return mid;
+        else if (value < codepoint)
+            low = mid + 1;
+        else
+            high = mid - 1;
+    }
+    return -1;
+}
+
 static gint
 get_index (FontManagerUnicodeCharacterMap *self, GSList *codepoints)
 {
@@ -174,10 +230,13 @@ get_index (FontManagerUnicodeCharacterMap *self, GSList *codepoints)
                     return i;
         }
         return -1;
-    } else if (self->filter)
-        return g_list_index(self->filter, GINT_TO_POINTER(code1));
-    else
-        return self->charset != NULL ? (gint) g_list_index(self->charset, GINT_TO_POINTER(code1)) : -1;
+    } else if (self->filter) {
+        gpointer index = NULL;
+        if (g_hash_table_lookup_extended(self->filter_index, GUINT_TO_POINTER(code1), NULL, &index))
+            return GPOINTER_TO_INT(index);
+        return -1;
+    } else
+        return get_charset_index(self, code1);
 }
 
 static gint
@@ -187,32 +246,33 @@ get_last_index (FontManagerUnicodeCharacterMap *self)
     if (self->filter && self->is_regional_indicator_filter)
         return N_REGIONAL_INDICATORS - 1;
     else if (self->filter)
-        return g_list_length(self->filter) - 1;
+        return (gint) self->filter->len - 1;
     if (!self->charset)
         return 0;
     if (!self->has_regional_indicator_symbols)
-        return (gint) g_list_length(self->charset) - 1;
-    return (((gint) g_list_length(self->charset)) + N_REGIONAL_INDICATORS) - 1;
+        return get_charset_length(self) - 1;
+    return (get_charset_length(self) + N_REGIONAL_INDICATORS) - 1;
 }
 
 static GSList *
 get_codepoints (FontManagerUnicodeCharacterMap *self, gint index)
 {
     g_return_val_if_fail(self != NULL, NULL);
-    gint base_codepoints = (gint) g_list_length(self->charset);
+    gint base_codepoints = get_charset_length(self);
     GSList *results = NULL;
+    if (index < 0)
+        return NULL;
     if (index < base_codepoints) {
         if (self->filter && self->is_regional_indicator_filter) {
             if (index < N_REGIONAL_INDICATORS) {
                 results = g_slist_append(results, GINT_TO_POINTER(FontManagerRegionalIndicatorSymbols[index].code1));
                 results = g_slist_append(results, GINT_TO_POINTER(FontManagerRegionalIndicatorSymbols[index].code2));
             }
-        } else if (self->filter)
-            results = g_slist_append(results, g_list_nth_data(self->filter, index));
-        else
-            results = g_slist_append(results, self->charset != NULL ?
-                                              g_list_nth_data(self->charset, index) :
-                                              GINT_TO_POINTER(-1));
+        } else if (self->filter) {
+            if (index < (gint) self->filter->len)
+                results = g_slist_append(results, GUINT_TO_POINTER(g_array_index(self->filter, gunichar, index)));
+        } else
+            results = g_slist_append(results, GUINT_TO_POINTER(g_array_index(self->charset, gunichar, index)));
     } else if (base_codepoints > 0) {
         gint _index = index - base_codepoints;
         if (_index < N_REGIONAL_INDICATORS) {
@@ -498,6 +558,51 @@ draw_character_with_metrics (GtkDrawingArea *widget,
     return;
 }
 
+static gpointer
+get_glyph_cache_key (FontManagerUnicodeCharacterMap *self, gint cell)
+{
+    GSList *codepoints = get_codepoints(self, cell);
+    guint n_codepoints = g_slist_length(codepoints);
+    gpointer key = NULL;
+    if (n_codepoints == 1) {
+        gunichar code1 = (gunichar) GPOINTER_TO_INT(codepoints->data);
+        key = GLYPH_CACHE_KEY(code1, 0);
+    } else if (n_codepoints == 2) {
+        gunichar code1 = (gunichar) GPOINTER_TO_INT(codepoints->data);
+        gunichar code2 = (gunichar) GPOINTER_TO_INT(codepoints->next->data);
+        key = GLYPH_CACHE_KEY(code1, code2);
+    }
+    g_slist_free(codepoints);
+    return key;
+}
+
+/* Renders the glyph for cell in the normal state, result is cached until the
+ * layout or foreground color changes. Returns NULL for cells without a glyph. */
+static GlyphCacheEntry *
+lookup_glyph (FontManagerUnicodeCharacterMap *self, GtkStyleContext *ctx, gint cell)
+{
+    gpointer key = get_glyph_cache_key(self, cell);
+    if (key == NULL)
+        return NULL;
+    GlyphCacheEntry *entry = g_hash_table_lookup(self->glyph_cache, key);
+    if (entry != NULL)
+        return entry;
+    if (g_hash_table_size(self->glyph_cache) >= GLYPH_CACHE_SIZE)
+        g_hash_table_remove_all(self->glyph_cache);
+    entry = g_new0(GlyphCacheEntry, 1);
+    g_autofree gchar *text = get_text_for_cell(self, cell);
+    pango_layout_set_text(self->pango_layout, text, -1);
+    /* Keep the square empty if the font has no glyph for this cell. */
+    if (pango_layout_get_unknown_glyphs_count(self->pango_layout) == 0) {
+        GtkSnapshot *snapshot = gtk_snapshot_new();
+        pango_layout_get_pixel_size(self->pango_layout, &entry->width, &entry->height);
+        gtk_snapshot_render_layout(snapshot, ctx, 0, 0, self->pango_layout);
+        entry->node = gtk_snapshot_free_to_node(snapshot);
+    }
+    g_hash_table_insert(self->glyph_cache, key, entry);
+    return entry;
+}
+
 static void
 draw_character (GtkWidget *widget,
                 GtkSnapshot *snapshot,
@@ -506,19 +611,33 @@ draw_character (GtkWidget *widget,
                 gint cell)
 {
     FontManagerUnicodeCharacterMap *self = FONT_MANAGER_UNICODE_CHARACTER_MAP(widget);
+    gtk_style_context_save(ctx);
+    gtk_style_context_add_class(ctx, "CharacterMapGlyph");
+    if (cell != self->active_cell) {
+        gtk_style_context_set_state(ctx, GTK_STATE_FLAG_NORMAL);
+        GlyphCacheEntry *entry = lookup_glyph(self, ctx, cell);
+        if (entry != NULL && entry->node != NULL) {
+            gtk_snapshot_save(snapshot);
+            gtk_snapshot_translate(snapshot,
+                                   &GRAPHENE_POINT_INIT(rect->origin.x + (rect->size.width - entry->width) / 2,
+                                                        rect->origin.y + (rect->size.height - entry->height) / 2));
+            gtk_snapshot_append_node(snapshot, entry->node);
+            gtk_snapshot_restore(snapshot);
+        }
+        gtk_style_context_restore(ctx);
+        return;
+    }
+    /* Active cell is drawn in a different state, render it directly */
     g_autofree gchar *text = get_text_for_cell(self, cell);
     pango_layout_set_text(self->pango_layout, text, -1);
-    /* Keep the square empty if the font has no glyph for this cell. */
-    if (pango_layout_get_unknown_glyphs_count(self->pango_layout) > 0)
+    if (pango_layout_get_unknown_glyphs_count(self->pango_layout) > 0) {
+        gtk_style_context_restore(ctx);
         return;
-    gtk_style_context_save(ctx);
-    GtkStateFlags _state = GTK_STATE_FLAG_NORMAL;
-    if (gtk_widget_has_focus(widget) && cell == self->active_cell)
+    }
+    GtkStateFlags _state = GTK_STATE_FLAG_INSENSITIVE | GTK_STATE_FLAG_SELECTED;
+    if (gtk_widget_has_focus(widget))
         _state = GTK_STATE_FLAG_SELECTED | GTK_STATE_FLAG_FOCUSED;
-    else if ((gint) cell == self->active_cell)
-        _state = GTK_STATE_FLAG_INSENSITIVE | GTK_STATE_FLAG_SELECTED;
     gtk_style_context_set_state(ctx, _state);
-    gtk_style_context_add_class(ctx, "CharacterMapGlyph");
     gint char_width, char_height;
     pango_layout_get_pixel_size(self->pango_layout, &char_width, &char_height);
     gtk_snapshot_render_layout(snapshot, ctx,
@@ -529,6 +648,23 @@ draw_character (GtkWidget *widget,
     return;
 }
 
+static void
+check_glyph_color (FontManagerUnicodeCharacterMap *self, GtkStyleContext *ctx)
+{
+    GdkRGBA color;
+    gtk_style_context_save(ctx);
+    gtk_style_context_set_state(ctx, GTK_STATE_FLAG_NORMAL);
+    gtk_style_context_add_class(ctx, "CharacterMapGlyph");
+    gtk_style_context_get_color(ctx, &color);
+    gtk_style_context_restore(ctx);
+    /* Theme changed, cached glyphs were rendered using the old color */
+    if (!gdk_rgba_equal(&color, &self->glyph_color)) {
+        g_hash_table_remove_all(self->glyph_cache);
+        self->glyph_color = color;
+    }
+    return;
+}
+
 static void
 draw_square_bg (GtkWidget *widget,
                 GtkSnapshot *snapshot,
@@ -588,19 +724,19 @@ font_manager_unicode_character_map_snapshot (GtkWidget *widget, GtkSnapshot *sna
     GtkStyleContext *ctx = gtk_widget_get_style_context(widget);
     FontManagerUnicodeCharacterMap *self = FONT_MANAGER_UNICODE_CHARACTER_MAP(widget);
     ensure_pango_layout(self);
+    check_glyph_color(self, ctx);
     gtk_widget_get_allocation(widget, &allocation);
     for (int row = self->rows - 1; row >= 0; --row) {
         for (int col = self->columns - 1; col >= 0; --col)  {
-            graphene_rect_t *cell_rect = graphene_rect_alloc();
-            cell_rect = graphene_rect_init(cell_rect,
-                                           get_x_offset(self, col),
-                                           get_y_offset(self, row),
-                                           column_width(self, col),
-                                           row_height(self, row));
+            graphene_rect_t cell_rect;
+            graphene_rect_init(&cell_rect,
+                               get_x_offset(self, col),
+                               get_y_offset(self, row),
+                               column_width(self, col),
+                               row_height(self, row));
             gint cell = get_cell_at_rowcol(self, row, col);
-            draw_square_bg(widget, snapshot, ctx, cell_rect, cell);
-            draw_character(widget, snapshot, ctx, cell_rect, cell);
-            graphene_rect_free(cell_rect);
+            draw_square_bg(widget, snapshot, ctx, &cell_rect, cell);
+            draw_character(widget, snapshot, ctx, &cell_rect, cell);
         }
     }
     graphene_rect_t *allocated_rect = graphene_rect_alloc();
@@ -661,12 +797,12 @@ set_vadjustment (FontManagerUnicodeCharacterMap *self, GtkAdjustment *vadjustmen
 }
 
 gboolean
-is_regional_indicator_filter (GList *filter)
+is_regional_indicator_filter (GArray *filter)
 {
-    if (!filter || g_list_length(filter) != 26)
+    if (!filter || filter->len != 26)
         return FALSE;
-    return (GPOINTER_TO_INT(g_list_nth_data(filter, 0)) == FONT_MANAGER_RIS_START_POINT
-            && GPOINTER_TO_INT(g_list_nth_data(filter, 25)) == FONT_MANAGER_RIS_END_POINT);
+    return (g_array_index(filter, gunichar, 0) == FONT_MANAGER_RIS_START_POINT
+            && g_array_index(filter, gunichar, 25) == FONT_MANAGER_RIS_END_POINT);
 }
 
 static void
@@ -683,8 +819,9 @@ check_for_regional_indicator_symbols (FontManagerUnicodeCharacterMap *self, hb_s
 static void
 populate_charset (FontManagerUnicodeCharacterMap *self, const PangoFontDescription *font_desc)
 {
-    g_clear_pointer(&self->charset, g_list_free);
-    g_clear_pointer(&self->filter, g_list_free);
+    g_clear_pointer(&self->charset, g_array_unref);
+    g_clear_pointer(&self->filter, g_array_unref);
+    g_clear_pointer(&self->filter_index, g_hash_table_destroy);
     ensure_pango_layout(self);
     PangoContext *context = pango_layout_get_context(self->pango_layout);
     PangoFontMap *font_map = pango_context_get_font_map(context);
@@ -693,13 +830,15 @@ populate_charset (FontManagerUnicodeCharacterMap *self, const PangoFontDescripti
     hb_face_t *face = hb_font_get_face(hb_font);
     hb_set_t *charset = hb_set_create();
     hb_face_collect_unicodes(face, charset);
+    self->charset = g_array_sized_new(FALSE, FALSE, sizeof(gunichar), hb_set_get_population(charset));
     hb_codepoint_t codepoint = HB_SET_VALUE_INVALID;
+    /* hb_set_next iterates in ascending order, get_charset_index relies on that */
     while (hb_set_next(charset, &codepoint))
         if (font_manager_unicode_unichar_isgraph(codepoint))
-            self->charset = g_list_prepend(self->charset, GINT_TO_POINTER(codepoint));
-    self->charset = g_list_reverse(self->charset);
+            g_array_append_val(self->charset, codepoint);
     check_for_regional_indicator_symbols(self, charset);
     hb_set_destroy(charset);
+    self->charset_serial++;
     return;
 }
 
@@ -963,6 +1102,10 @@ font_manager_unicode_character_map_dispose (GObject *gobject)
     FontManagerUnicodeCharacterMap *self = FONT_MANAGER_UNICODE_CHARACTER_MAP(gobject);
     g_clear_pointer(&self->font_desc, pango_font_description_free);
     clear_pango_layout(self);
+    g_clear_pointer(&self->glyph_cache, g_hash_table_destroy);
+    g_clear_pointer(&self->charset, g_array_unref);
+    g_clear_pointer(&self->filter, g_array_unref);
+    g_clear_pointer(&self->filter_index, g_hash_table_destroy);
     font_manager_widget_dispose(GTK_WIDGET(self));
     G_OBJECT_CLASS(font_manager_unicode_character_map_parent_class)->dispose(gobject);
     return;
@@ -1168,6 +1311,8 @@ font_manager_unicode_character_map_init (FontManagerUnicodeCharacterMap *self)
     self->hscroll_policy = GTK_SCROLL_NATURAL;
     self->vscroll_policy = GTK_SCROLL_NATURAL;
     self->preview_size = FONT_MANAGER_LARGE_PREVIEW_SIZE;
+    self->glyph_cache = g_hash_table_new_full(NULL, NULL, NULL,
+                                              (GDestroyNotify) glyph_cache_entry_free);
     GtkWidget *widget = GTK_WIDGET(self);
     gtk_widget_set_focusable(widget, TRUE);
     gtk_widget_add_css_class(widget, FONT_MANAGER_STYLE_CLASS_VIEW);
@@ -1263,6 +1408,22 @@ font_manager_unicode_character_map_get_last_index (FontManagerUnicodeCharacterMa
     return get_last_index(self);
 }
 
+/**
+ * font_manager_unicode_character_map_get_charset_serial:
+ * @self:           a #FontManagerUnicodeCharacterMap
+ *
+ * The serial changes whenever the font or filter change,
+ * cell indices obtained under a different serial are no longer valid.
+ *
+ * Returns: current charset serial
+ */
+guint
+font_manager_unicode_character_map_get_charset_serial (FontManagerUnicodeCharacterMap *self)
+{
+    g_return_val_if_fail(FONT_MANAGER_IS_UNICODE_CHARACTER_MAP(self), 0);
+    return self->charset_serial;
+}
+
 /**
  * font_manager_unicode_character_map_get_codepoints:
  * @self:           a #FontManagerUnicodeCharacterMap
@@ -1321,10 +1482,25 @@ void
 font_manager_unicode_character_map_set_filter (FontManagerUnicodeCharacterMap *self, GList *filter)
 {
     g_return_if_fail(self != NULL);
-    g_clear_pointer(&self->filter, g_list_free);
-    self->filter = filter;
-    self->is_regional_indicator_filter = is_regional_indicator_filter(filter);
+    g_clear_pointer(&self->filter, g_array_unref);
+    g_clear_pointer(&self->filter_index, g_hash_table_destroy);
+    if (filter != NULL) {
+        self->filter = g_array_sized_new(FALSE, FALSE, sizeof(gunichar), g_list_length(filter));
+        self->filter_index = g_hash_table_new(NULL, NULL);
+        for (GList *iter = filter; iter != NULL; iter = iter->next) {
+            gunichar wc = (gunichar) GPOINTER_TO_INT(iter->data);
+            /* Keep the first occurrence, matching previous lookup behavior */
+            if (!g_hash_table_contains(self->filter_index, GUINT_TO_POINTER(wc)))
+                g_hash_table_insert(self->filter_index,
+                                    GUINT_TO_POINTER(wc),
+                                    GINT_TO_POINTER(self->filter->len));
+            g_array_append_val(self->filter, wc);
+        }
+        g_list_free(filter);
+    }
+    self->is_regional_indicator_filter = is_regional_indicator_filter(self->filter);
     self->last_cell = get_last_index(self);
+    self->charset_serial++;
     gtk_widget_queue_resize(GTK_WIDGET(self));
     gtk_widget_queue_draw(GTK_WIDGET(self));
     font_manager_unicode_character_map_set_active_cell(self, 0);
@@ -40,6 +40,7 @@ gint font_manager_unicode_character_map_get_active_cell (FontManagerUnicodeChara
 PangoFontDescription * font_manager_unicode_character_map_get_font_desc (FontManagerUnicodeCharacterMap *self);
 double font_manager_unicode_character_map_get_preview_size (FontManagerUnicodeCharacterMap *self);
 gint font_manager_unicode_character_map_get_last_index (FontManagerUnicodeCharacterMap *self);
+guint font_manager_unicode_character_map_get_charset_serial (FontManagerUnicodeCharacterMap *self);
 gint font_manager_unicode_character_map_get_index (FontManagerUnicodeCharacterMap *self, GSList *codepoints);
 GSList * font_manager_unicode_character_map_get_codepoints (FontManagerUnicodeCharacterMap *self, gint index);
 void font_manager_unicode_character_map_set_active_cell (FontManagerUnicodeCharacterMap *self, gint cell);
@@ -528,6 +528,190 @@ font_manager_unicode_get_nameslist_colons (gunichar uc)
   return colons;
 }
 
+/* Search index
+ *
+ * Names, nameslist entries and Unihan definitions for each codepoint are
+ * folded into a single lowercase NFD string, the "haystack". A trigram index maps every three
+ * byte sequence to the haystacks containing it so that a query only has to
+ * verify the entries listed under its rarest trigram instead of scanning
+ * every table. Built once, on first use.
+ */
+
+#define TRIGRAM(p) (((guint32) (guchar) (p)[0]) | \
+                    ((guint32) (guchar) (p)[1] << 8) | \
+                    ((guint32) (guchar) (p)[2] << 16))
+
+typedef struct
+{
+    GArray *codepoints;     /* gunichar, sorted */
+    GArray *offsets;        /* guint32, offset of each haystack in text */
+    GString *text;          /* haystacks, NUL separated */
+    GHashTable *trigrams;   /* trigram -> GArray of guint32 entry indices */
+}
+SearchIndex;
+
+static void
+append_folded (GString *haystack, const gchar *str)
+{
+    if (str == NULL || *str == '\0')
+        return;
+    g_autofree gchar *nfd = g_utf8_normalize(str, -1, G_NORMALIZE_NFD);
+    if (nfd == NULL)
+        return;
+    g_autofree gchar *folded = g_utf8_strdown(nfd, -1);
+    /* Separator keeps matches from spanning two entries */
+    if (haystack->len > 0)
+        g_string_append_c(haystack, '\n');
+    g_string_append(haystack, folded);
+    return;
+}
+
+static void
+append_folded_array (GString *haystack, const gchar **arr)
+{
+    if (arr == NULL)
+        return;
+    for (gint i = 0; arr[i] != NULL; i++)
+        append_folded(haystack, arr[i]);
+    g_free(arr);
+    return;
+}
+
+static GString *
+get_haystack (GHashTable *haystacks, gunichar uc)
+{
+    GString *haystack = g_hash_table_lookup(haystacks, GUINT_TO_POINTER(uc));
+    if (haystack == NULL) {
+        haystack = g_string_new(NULL);
+        g_hash_table_insert(haystacks, GUINT_TO_POINTER(uc), haystack);
+    }
+    return haystack;
+}
+
+static gint
+compare_unichar (gconstpointer a, gconstpointer b)
+{
+    gunichar _a = *((const gunichar *) a), _b = *((const gunichar *) b);
+    return (_a > _b) - (_a < _b);
+}
+
+static void
+free_string (gpointer data)
+{
+    g_string_free((GString *) data, TRUE);
+    return;
+}
+
+static gpointer
+build_search_index (G_GNUC_UNUSED gpointer data)
+{
+    SearchIndex *index = g_new0(SearchIndex, 1);
+    g_autoptr(GHashTable) haystacks = g_hash_table_new_full(NULL, NULL, NULL, free_string);
+    for (guint i = 0; i < G_N_ELEMENTS(unicode_names); i++)
+        append_folded(get_haystack(haystacks, unicode_names[i].index),
+                      font_manager_unicode_name_get_name(&unicode_names[i]));
+    for (guint i = 0; i < G_N_ELEMENTS(names_list); i++) {
+        gunichar uc = names_list[i].index;
+        GString *haystack = get_haystack(haystacks, uc);
+        append_folded_array(haystack, font_manager_unicode_get_nameslist_equals(uc));
+        append_folded_array(haystack, font_manager_unicode_get_nameslist_stars(uc));
+        append_folded_array(haystack, font_manager_unicode_get_nameslist_colons(uc));
+        append_folded_array(haystack, font_manager_unicode_get_nameslist_pounds(uc));
+    }
+#if INCLUDE_UNIHAN_DATA
+    for (guint i = 0; i < G_N_ELEMENTS(unihan); i++) {
+        const gchar *definition = unihan_get_kDefinition(&unihan[i]);
+        if (definition != NULL)
+            append_folded(get_haystack(haystacks, unihan[i].index), definition);
+    }
+#endif
+    guint n_entries = g_hash_table_size(haystacks);
+    index->codepoints = g_array_sized_new(FALSE, FALSE, sizeof(gunichar), n_entries);
+    index->offsets = g_array_sized_new(FALSE, FALSE, sizeof(guint32), n_entries);
+    index->text = g_string_sized_new(n_entries * 32);
+    index->trigrams = g_hash_table_new_full(NULL, NULL, NULL, (GDestroyNotify) g_array_unref);
+    GHashTableIter iter;
+    gpointer key;
+    g_hash_table_iter_init(&iter, haystacks);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        gunichar uc = GPOINTER_TO_UINT(key);
+        g_array_append_val(index->codepoints, uc);
+    }
+    g_array_sort(index->codepoints, compare_unichar);
+    for (guint32 i = 0; i < index->codepoints->len; i++) {
+        gunichar uc = g_array_index(index->codepoints, gunichar, i);
+        GString *haystack = g_hash_table_lookup(haystacks, GUINT_TO_POINTER(uc));
+        guint32 offset = index->text->len;
+        g_array_append_val(index->offsets, offset);
+        g_string_append_len(index->text, haystack->str, haystack->len + 1);
+        for (gsize j = 0; j + 3 <= haystack->len; j++) {
+            gpointer trigram = GUINT_TO_POINTER(TRIGRAM(haystack->str + j));
+            GArray *postings = g_hash_table_lookup(index->trigrams, trigram);
+            if (postings == NULL) {
+                postings = g_array_new(FALSE, FALSE, sizeof(guint32));
+                g_hash_table_insert(index->trigrams, trigram, postings);
+            }
+            /* Entries are visited in order, so duplicates are always last */
+            if (postings->len == 0 || g_array_index(postings, guint32, postings->len - 1) != i)
+                g_array_append_val(postings, i);
+        }
+    }
+    return index;
+}
+
+static SearchIndex *
+get_search_index (void)
+{
+    static GOnce once = G_ONCE_INIT;
+    g_once(&once, build_search_index, NULL);
+    return once.retval;
+}
+
+/**
+ * font_manager_unicode_search_names: (skip)
+ * @search_string: NFD normalized string to search for
+ *
+ * Looks up all codepoints whose name, nameslist entries or Unihan
+ * definition contain @search_string, ignoring case.
+ *
+ * The search index is built the first time this function is called.
+ *
+ * Returns: (transfer full): newly allocated sorted #GArray of #gunichar.
+ * Free the returned array using #g_array_unref().
+ */
+GArray *
+font_manager_unicode_search_names (const gchar *search_string)
+{
+    g_return_val_if_fail(search_string != NULL, NULL);
+    SearchIndex *index = get_search_index();
+    GArray *results = g_array_new(FALSE, FALSE, sizeof(gunichar));
+    g_autofree gchar *needle = g_utf8_strdown(search_string, -1);
+    gsize needle_len = strlen(needle);
+    if (needle_len == 0)
+        return results;
+    if (needle_len < 3) {
+        for (guint i = 0; i < index->codepoints->len; i++)
+            if (strstr(index->text->str + g_array_index(index->offsets, guint32, i), needle))
+                g_array_append_val(results, g_array_index(index->codepoints, gunichar, i));
+        return results;
+    }
+    /* Only entries containing every trigram of needle can match, verify the shortest list */
+    GArray *candidates = NULL;
+    for (gsize i = 0; i + 3 <= needle_len; i++) {
+        GArray *postings = g_hash_table_lookup(index->trigrams, GUINT_TO_POINTER(TRIGRAM(needle + i)));
+        if (postings == NULL)
+            return results;
+        if (candidates == NULL || postings->len < candidates->len)
+            candidates = postings;
+    }
+    for (guint i = 0; i < candidates->len; i++) {
+        guint32 entry = g_array_index(candidates, guint32, i);
+        if (strstr(index->text->str + g_array_index(index->offsets, guint32, entry), needle))
+            g_array_append_val(results, g_array_index(index->codepoints, gunichar, entry));
+    }
+    return results;
+}
+
 /* Wrapper, in case we want to support a newer unicode version than glib */
 gboolean
 font_manager_unicode_unichar_validate (gunichar ch)
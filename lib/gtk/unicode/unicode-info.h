@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <string.h>
 #include <glib.h>
 #include <glib/gi18n-lib.h>
 
@@ -113,5 +114,6 @@ const gchar ** font_manager_unicode_get_nameslist_stars (gunichar  uc);
 const gchar ** font_manager_unicode_get_nameslist_equals (gunichar  uc);
 const gchar ** font_manager_unicode_get_nameslist_pounds (gunichar  uc);
 const gchar ** font_manager_unicode_get_nameslist_colons (gunichar  uc);
+GArray * font_manager_unicode_search_names (const gchar *search_string);
 const gchar * font_manager_unicode_version_to_string (FontManagerUnicodeStandard version);
 FontManagerUnicodeStandard font_manager_unicode_get_version (gunichar uc);
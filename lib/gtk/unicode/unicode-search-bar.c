@@ -48,15 +48,17 @@ struct _UnicodeSearchState
 {
     UnicodeSearchDirection direction;
     FontManagerUnicodeCharacterMap *character_map;
+    /* charset serial of character_map at the time this state was created */
+    guint charset_serial;
     gint start_index;
-    gint curr_index;
     gint match;       /* index of the found character */
     gint search_string_value;
     gint search_index_nfc;
     gint search_index_nfd;
     gint search_string_nfc_len;
     gint search_string_nfd_len;
-    gboolean searching;
+    /* sorted cell indices of every match in character_map, NULL until first search */
+    GArray *matches;
     /* true if there are known to be no matches,
      * or there is known to be exactly one match and it has been found */
     gboolean search_complete;
@@ -89,84 +91,21 @@ enum
 
 static GParamSpec *obj_properties[N_PROPERTIES] = {0};
 
-static const gchar *
-utf8_strcasestr (const gchar *haystack, const gchar *needle)
-{
-    const gchar *p, *q, *r;
-    gint needle_len = strlen(needle);
-    gint haystack_len = strlen(haystack);
-
-    for (p = haystack;  p + needle_len <= haystack + haystack_len;  p = g_utf8_next_char(p)) {
-
-        gboolean match = TRUE;
-
-        for (q = needle, r = p;  *q && *r;  q = g_utf8_next_char(q), r = g_utf8_next_char(r)) {
-            gunichar lc0 = g_unichar_tolower (g_utf8_get_char(r));
-            gunichar lc1 = g_unichar_tolower (g_utf8_get_char(q));
-            if (lc0 != lc1) {
-                match = FALSE;
-                break;
-            }
-        }
-
-        if (match)
-            return p;
-
-    }
-
-    return NULL;
-}
-
-static gboolean
-found_in_array (const gchar **haystack_arr, const gchar *search_string_nfd)
-{
-    gboolean matched = FALSE;
-    if (haystack_arr) {
-        for (gint i = 0; haystack_arr[i] != NULL; i++) {
-            g_autofree gchar *haystack_nfd = g_utf8_normalize(haystack_arr[i], -1, G_NORMALIZE_NFD);
-            matched = utf8_strcasestr(haystack_nfd, search_string_nfd) != NULL;
-            if (matched)
-                break;
-        }
-        g_free(haystack_arr);
-    }
-    return matched;
-}
-
 static gboolean
-matches (gunichar wc, const gchar *search_string_nfd)
+contains_codepoint (GArray *codepoints, gunichar wc)
 {
-    const gchar *haystack;
-    gboolean matched = FALSE;
-
-    haystack = font_manager_unicode_get_codepoint_data_name(wc);
-    if (haystack) {
-        /* character names are ascii, so are nfd */
-        gchar *haystack_nfd = (gchar *) haystack;
-        matched = utf8_strcasestr(haystack_nfd, search_string_nfd) != NULL;
-    }
-
-    if (!matched) {
-        haystack = font_manager_unicode_get_unicode_kDefinition(wc);
-        if (haystack) {
-            g_autofree gchar *haystack_nfd = g_utf8_normalize(haystack, -1, G_NORMALIZE_NFD);
-            matched = utf8_strcasestr(haystack_nfd, search_string_nfd) != NULL;
-        }
+    gint min = 0, max = (gint) codepoints->len - 1;
+    while (max >= min) {
+        gint mid = (min + max) / 2;
+        gunichar value = g_array_index(codepoints, gunichar, mid);
+        if (wc > value)
+            min = mid + 1;
+        else if (wc < value)
+            max = mid - 1;
+        else
+            return TRUE;
     }
-
-    if (!matched)
-        matched = found_in_array(font_manager_unicode_get_nameslist_equals(wc), search_string_nfd);
-
-    if (!matched)
-        matched = found_in_array(font_manager_unicode_get_nameslist_stars(wc), search_string_nfd);
-
-    if (!matched)
-        matched = found_in_array(font_manager_unicode_get_nameslist_colons(wc), search_string_nfd);
-
-    if (!matched)
-        matched = found_in_array(font_manager_unicode_get_nameslist_pounds(wc), search_string_nfd);
-
-    return matched;
+    return FALSE;
 }
 
 static gint
@@ -241,14 +180,14 @@ quick_checks_before (UnicodeSearchState *search_state)
 
     /* if NFD of the search string is a single character, jump to that */
     if (search_state->search_string_nfd_len == 1 && search_state->search_index_nfd != -1) {
-        search_state->match = search_state->curr_index = search_state->search_index_nfd;
+        search_state->match = search_state->search_index_nfd;
         search_state->search_complete = TRUE;
         return TRUE;
     }
 
     /* if NFC of the search string is a single character, jump to that */
     if (search_state->search_string_nfc_len == 1 && search_state->search_index_nfc != -1) {
-        search_state->match = search_state->curr_index = search_state->search_index_nfc;
+        search_state->match = search_state->search_index_nfc;
         search_state->search_complete = TRUE;
         return TRUE;
     }
@@ -275,66 +214,80 @@ quick_checks_after (UnicodeSearchState *search_state)
     return FALSE;
 }
 
-static gboolean
-idle_search (FontManagerUnicodeSearchBar *self)
+/* Collects every matching cell in a single pass over the character map,
+ * names and definitions are looked up in the prebuilt index in unicode-info.c */
+static void
+collect_matches (UnicodeSearchState *search_state)
 {
-    g_return_val_if_fail(self != NULL, FALSE);
-    gunichar wc;
-    GTimer *timer;
-
-    if (quick_checks_before (self->search_state))
-        return FALSE;
-
-    timer = g_timer_new ();
-
-    gint n_chars = font_manager_unicode_character_map_get_last_index(self->search_state->character_map);
-
-    do {
-        self->search_state->curr_index = (self->search_state->curr_index + self->search_state->direction + n_chars) % n_chars;
-
+    FontManagerUnicodeCharacterMap *character_map = search_state->character_map;
+    g_autoptr(GArray) names = font_manager_unicode_search_names(search_state->search_string_nfd);
+    gint last_index = font_manager_unicode_character_map_get_last_index(character_map);
+    search_state->matches = g_array_new(FALSE, FALSE, sizeof(gint));
+    for (gint i = 0; i <= last_index; i++) {
         /* check for explicit codepoint */
-        if (self->search_state->search_string_value != -1 && self->search_state->curr_index == self->search_state->search_string_value) {
-            self->search_state->match = self->search_state->curr_index;
-            self->search_state->search_complete = TRUE;
-            g_timer_destroy (timer);
-            return FALSE;
+        if (i == search_state->search_string_value) {
+            g_array_append_val(search_state->matches, i);
+            continue;
         }
-
-        GSList *codepoints = font_manager_unicode_character_map_get_codepoints(self->search_state->character_map, self->search_state->curr_index);
-
+        GSList *codepoints = font_manager_unicode_character_map_get_codepoints(character_map, i);
         for (GSList *iter = codepoints; iter != NULL; iter = iter->next) {
-
-            wc = (gunichar) GPOINTER_TO_INT(iter->data);
-
-            if (!font_manager_unicode_unichar_validate (wc))
+            gunichar wc = (gunichar) GPOINTER_TO_INT(iter->data);
+            if (!font_manager_unicode_unichar_validate(wc))
                 continue;
-
-            /* check for other matches */
-            if (matches(wc, self->search_state->search_string_nfd)) {
-                self->search_state->match = self->search_state->curr_index;
-                g_timer_destroy (timer);
-                return FALSE;
+            if (contains_codepoint(names, wc)) {
+                g_array_append_val(search_state->matches, i);
+                break;
             }
-
         }
-
         g_slist_free(codepoints);
+    }
+    return;
+}
 
-        if (g_timer_elapsed (timer, NULL) > 0.050) {
-            g_timer_destroy (timer);
-            return TRUE;
-        }
+/* Returns the closest match after (or before) start_index, wrapping around */
+static gint
+find_next_match (UnicodeSearchState *search_state)
+{
+    GArray *matches = search_state->matches;
+    if (matches->len == 0)
+        return -1;
+    /* Find the first match greater than start_index */
+    gint min = 0, max = (gint) matches->len;
+    while (min < max) {
+        gint mid = (min + max) / 2;
+        if (g_array_index(matches, gint, mid) <= search_state->start_index)
+            min = mid + 1;
+        else
+            max = mid;
+    }
+    if (search_state->direction == UNICODE_SEARCH_DIRECTION_FORWARD)
+        return g_array_index(matches, gint, min < (gint) matches->len ? min : 0);
+    /* Step back over start_index itself if it's a match */
+    gint prev = min - 1;
+    if (prev >= 0 && g_array_index(matches, gint, prev) == search_state->start_index)
+        prev--;
+    return g_array_index(matches, gint, prev >= 0 ? prev : (gint) matches->len - 1);
+}
 
-    } while (self->search_state->curr_index != self->search_state->start_index);
+static void
+unicode_search_run (UnicodeSearchState *search_state)
+{
+    if (quick_checks_before(search_state))
+        return;
 
-    g_timer_destroy (timer);
+    if (search_state->matches == NULL)
+        collect_matches(search_state);
 
-    if (quick_checks_after (self->search_state))
-        return FALSE;
+    search_state->match = find_next_match(search_state);
 
-    self->search_state->search_complete = TRUE;
+    if (search_state->matches->len == 0) {
+        quick_checks_after(search_state);
+        search_state->search_complete = TRUE;
+    } else if (search_state->matches->len == 1) {
+        search_state->search_complete = TRUE;
+    }
 
-    return FALSE;
+    return;
 }
 
 /**
@@ -345,6 +298,8 @@ static void
 unicode_search_state_free (UnicodeSearchState *search_state)
 {
     g_object_unref(search_state->character_map);
+    if (search_state->matches)
+        g_array_unref(search_state->matches);
     g_free(search_state->search_string);
     g_free(search_state->search_string_nfd);
     g_free(search_state->search_string_nfc);
@@ -372,12 +327,13 @@ unicode_search_state_new (FontManagerUnicodeCharacterMap *character_map,
 {
     UnicodeSearchState *search_state = g_slice_new(UnicodeSearchState);
     search_state->character_map = g_object_ref(character_map);
+    search_state->charset_serial = font_manager_unicode_character_map_get_charset_serial(character_map);
     search_state->direction = direction;
     search_state->prepped = FALSE;
     search_state->match = -1;
     search_state->search_complete = FALSE;
     search_state->start_index = start_index;
-    search_state->curr_index = start_index;
+    search_state->matches = NULL;
     search_state->search_string = g_strstrip(g_strdup(search_string));
 
     /* NFD */
@@ -406,7 +362,6 @@ unicode_search_state_new (FontManagerUnicodeCharacterMap *character_map,
 
     /* INDEX */
     search_state->search_string_value = check_for_explicit_codepoint(search_state->character_map, search_state->search_string_nfd);
-    search_state->searching = FALSE;
     return search_state;
 }
 
@@ -425,7 +380,6 @@ search_completed (FontManagerUnicodeSearchBar *self)
     g_return_if_fail(self != NULL && self->character_map != NULL);
     UnicodeSearchState *search_state = self->search_state;
     gint index = search_state->match >= 0 ? search_state->match : -1;
-    search_state->searching = FALSE;
     font_manager_unicode_character_map_set_active_cell(self->character_map, index);
     set_action_visibility(self, !search_state->search_complete);
     return;
@@ -438,11 +392,10 @@ unicode_search_start (FontManagerUnicodeSearchBar *self, UnicodeSearchDirection
 
     gint start_index;
 
-    if (self->search_state && self->search_state->searching) /* Already searching */
-        return;
-
     if (self->search_state == NULL
         || self->character_map != self->search_state->character_map
+        /* Cell indices refer to a different font or filter */
+        || font_manager_unicode_character_map_get_charset_serial(self->character_map) != self->search_state->charset_serial
         || strcmp (self->search_state->search_string, gtk_editable_get_text(GTK_EDITABLE(self->entry))) != 0 ) {
 
         g_clear_pointer(&self->search_state, unicode_search_state_free);
@@ -453,12 +406,11 @@ unicode_search_start (FontManagerUnicodeSearchBar *self, UnicodeSearchDirection
                                                       start_index, direction );
     } else {
         self->search_state->start_index = font_manager_unicode_character_map_get_active_cell(self->character_map);
-        self->search_state->curr_index = self->search_state->start_index;
         self->search_state->direction = direction;
     }
 
-    self->search_state->searching = TRUE;
-    g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, (GSourceFunc) idle_search, self, (GDestroyNotify) search_completed);
+    unicode_search_run(self->search_state);
+    search_completed(self);
     return;
 }
 
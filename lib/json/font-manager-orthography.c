@@ -19,6 +19,7 @@
 */
 
 #include "font-manager-orthography.h"
+#include "font-manager-orthographies.h"
 
 /**
  * SECTION: font-manager-orthography
@@ -42,7 +43,9 @@
  * }
  * ]|
  *
- * filter is a #JsonArray of available codepoints
+ * filter is a #JsonArray of available codepoints. It is not stored in the
+ * database and may be missing, in which case #font_manager_orthography_get_filter()
+ * rebuilds it from the orthography data.
  */
 
 struct _FontManagerOrthography
@@ -96,6 +99,8 @@ font_manager_orthography_get_filter (FontManagerOrthography *self)
             charlist = g_list_prepend(charlist, GINT_TO_POINTER(uc));
         }
         charlist = g_list_reverse(charlist);
+    } else if (json_object_has_member(source, "name")) {
+        charlist = font_manager_get_orthography_filter(json_object_get_string_member(source, "name"));
     }
     return charlist;
 }
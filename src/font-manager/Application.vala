@@ -33,7 +33,7 @@ namespace FontManager {
         [DBus (visible = false)]
         public GLib.Settings? settings { get; private set; default = null; }
         [DBus (visible = false)]
-        public Json.Array? available_fonts { get; set; default = null; }
+        public FontTable? available_fonts { get; set; default = null; }
         [DBus (visible = false)]
         public MainWindow? main_window { get; private set; default = null; }
         [DBus (visible = false)]
@@ -52,11 +52,13 @@ namespace FontManager {
             { "list", 'l', 0, OptionArg.NONE, null, "List available font families.", null },
             { "list-full", 0, 0, OptionArg.NONE, null, "Full listing including face information. (JSON)", null },
             { "update", 'u', 0, OptionArg.NONE, null, "Update application database", null },
+            { "profile", 0, 0, OptionArg.FILENAME, null, "Write a performance trace to FILE on exit. Same as setting FONT_MANAGER_PROFILE.", "FILE" },
             { "", 0, 0, OptionArg.FILENAME_ARRAY, null, null, null },
             { null }
         };
 
         uint dbus_id = 0;
+        bool refresh_in_progress = false;
         SearchProvider? gs_search_provider = null;
 
         ~ Application () {
@@ -88,6 +90,7 @@ namespace FontManager {
                 gtk.gtk_application_prefer_dark_theme = prefer_dark_theme;
 #endif
                 gtk.gtk_enable_animations = settings.get_boolean("enable-animations");
+                settings.bind("database-sync-threads", db, "max-workers", SettingsBindFlags.GET);
             }
             notify["update-in-progress"].connect(progress_visible);
             db.update_started.connect(() => { update_in_progress = true; });
@@ -95,6 +98,16 @@ namespace FontManager {
             return;
         }
 
+        public override void shutdown () {
+            try {
+                profiler_flush();
+            } catch (Error e) {
+                warning("Failed to write performance trace : %s", e.message);
+            }
+            base.shutdown();
+            return;
+        }
+
         public override void open (File [] files, string hint) {
             int index = hint != "" ? int.parse(hint) : 0;
             try {
@@ -126,10 +139,7 @@ namespace FontManager {
                         main_window.install_selections(filelist);
                     } else {
                         var installer = new Library.Installer();
-                        installer.progress.connect((m, p, t) => {
-                            var data = new ProgressData(m, p, t);
-                            data.print();
-                        });
+                        installer.progress.connect((data) => { data.print(); });
                         GLib.stdout.printf("%s\n", _("Installing Font Files…"));
                         installer.process_sync(filelist);
                         stdout.printf("\n");
@@ -139,7 +149,7 @@ namespace FontManager {
                     reload();
                 } else {
                     update_font_configuration();
-                    available_fonts = get_sorted_font_list(null);
+                    available_fonts = get_sorted_font_table(null);
                     db.update_started.connect(() => { hold(); });
                     db.update_complete.connect(() => { GLib.stdout.printf("\n"); release(); });
                     db.set_progress_callback(ProgressData.print);
@@ -208,6 +218,9 @@ namespace FontManager {
 
             int exit_status = -1;
 
+            Variant? profile = options.lookup_value("profile", VariantType.BYTESTRING);
+            profiler_enable(profile != null ? profile.get_bytestring() : null);
+
             if (options.contains("version")) {
                 stdout.printf("%s %s\n", Config.PACKAGE_NAME, Config.PACKAGE_VERSION);
                 return 0;
@@ -318,15 +331,60 @@ namespace FontManager {
         [DBus (visible = false)]
         public void reload ()
         requires (main_window != null) {
-            if (update_in_progress)
+            if (update_in_progress || refresh_in_progress)
                 return;
             var ctx = main_window.get_pango_context();
-            available_fonts = get_sorted_font_list(ctx);
+            available_fonts = get_sorted_font_table(ctx);
             main_window.present();
             db.update(available_fonts);
             return;
         }
 
+        // Brings the list restored from a snapshot up to date
+        void refresh_snapshot (FontTable snapshot) {
+            Reject? reject = prepare_font_configuration(main_window.get_pango_context());
+            get_sorted_font_table_async.begin(reject, (obj, res) => {
+                FontTable table = get_sorted_font_table_async.end(res);
+                refresh_in_progress = false;
+                // Avoid refiltering every model if nothing changed,
+                // otherwise models only replace the families which did.
+                if (!table.equal(snapshot))
+                    available_fonts = table;
+                db.update(available_fonts);
+            });
+            return;
+        }
+
+        // Displays the fonts available during the last run, if nothing has
+        // changed since, then brings the list up to date in the background.
+        void restore () {
+            int64 span = profiler_begin();
+            FontTable? snapshot = load_font_table_snapshot();
+            if (snapshot == null) {
+                reload();
+                return;
+            }
+            available_fonts = snapshot;
+            main_window.present();
+            profiler_end(span, "Application.restore");
+            refresh_in_progress = true;
+            // Reloading the font configuration waits until the snapshot has been
+            // drawn. Until then families which are only available through user
+            // font sources render with a fallback, the database sync which
+            // follows the refresh updates the previews.
+            Gdk.FrameClock? frame_clock = main_window.get_frame_clock();
+            if (frame_clock == null) {
+                Idle.add(() => { refresh_snapshot(snapshot); return GLib.Source.REMOVE; });
+                return;
+            }
+            ulong handler = 0;
+            handler = frame_clock.after_paint.connect(() => {
+                frame_clock.disconnect(handler);
+                Idle.add(() => { refresh_snapshot(snapshot); return GLib.Source.REMOVE; });
+            });
+            return;
+        }
+
         protected override void activate () {
             if (main_window == null) {
                 main_window = new MainWindow(settings);
@@ -337,7 +395,6 @@ namespace FontManager {
                 bind_property("disabled-families", main_window, "disabled-families", flags);
             }
             db.update_complete.connect(() => {
-                update_item_preview_text(available_fonts);
                 if (main_window.mode == Mode.BROWSE)
                     main_window.browse_pane.queue_update();
                 Idle.add(() => {
@@ -350,7 +407,10 @@ namespace FontManager {
             db.set_progress_callback((data) => {
                 return get_default_application().main_window.progress_update(data);
             });
-            reload();
+            if (available_fonts == null)
+                restore();
+            else
+                reload();
             return;
         }
 
@@ -386,6 +446,7 @@ namespace FontManager {
             return;
         }
 
+#if !BENCHMARK
         public static int main (string [] args) {
             setup_i18n();
             set_debug_level(args);
@@ -400,6 +461,7 @@ namespace FontManager {
                                       ApplicationFlags.HANDLES_COMMAND_LINE);
             return new Application(BUS_ID, FLAGS).run(args);
         }
+#endif
 
     }
 
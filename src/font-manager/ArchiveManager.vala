@@ -64,6 +64,14 @@ namespace FontManager {
 
     namespace ArchiveManager {
 
+        /**
+         * Called as archive contents are written to disk.
+         *
+         * @entry   path of the entry being extracted
+         * @bytes   number of bytes written since the last call
+         */
+        public delegate void ExtractProgressFunc (string entry, uint64 bytes);
+
         Archive.Entry add_entry (Archive.Write archive, File file, FileInfo file_info, string path) {
             Archive.Entry entry = new Archive.Entry();
             entry.set_pathname(path);
@@ -190,10 +198,11 @@ namespace FontManager {
          * @self: #FontManagerArchiveManager
          * @file #GFile to extract
          * @dest_dir #GFile directory to use for extraction
+         * @progress #ExtractProgressFunc or %NULL
          *
          * Returns: %TRUE if archive was successfully created
          */
-        public bool extract (File file, File dest_dir) {
+        public bool extract (File file, File dest_dir, ExtractProgressFunc? progress = null) {
 
             return_val_if_fail(file.query_exists(), false);
             return_val_if_fail(dest_dir.query_exists(), false);
@@ -231,9 +240,12 @@ namespace FontManager {
 
                 Posix.off_t offset;
                 uint8 [] buffer = null;
-                while (archive.read_data_block(out buffer, out offset) == Archive.Result.OK)
+                while (archive.read_data_block(out buffer, out offset) == Archive.Result.OK) {
                     if (extractor.write_data_block(buffer, offset) < Archive.Result.OK)
                         break;
+                    if (progress != null)
+                        progress(entry.pathname(), (uint64) buffer.length);
+                }
 
             }
 
@@ -113,9 +113,11 @@ namespace FontManager {
         public Pango.AttrList? attrs { get; protected set; default = new Pango.AttrList(); }
         public Gtk.Inscription? preview { get; protected set; default = null; }
         public string? preview_text { get; set; default = null; }
+        public PreviewTextureCache? texture_cache { get; set; default = null; }
 
         Gtk.Label item_count;
         Gtk.Overlay overlay;
+        Gtk.Picture picture;
 
         ~ FontPreviewTile () {
             if (attrs != null)
@@ -142,6 +144,12 @@ namespace FontManager {
             preview.set_attributes(attrs);
             overlay.set_child(preview);
             set_child(overlay);
+            picture = new Gtk.Picture() {
+                can_shrink = true,
+                content_fit = Gtk.ContentFit.SCALE_DOWN,
+                visible = false
+            };
+            overlay.add_overlay(picture);
             item_count = new Gtk.Label(null) {
                 halign = Gtk.Align.END,
                 valign = Gtk.Align.END,
@@ -153,12 +161,33 @@ namespace FontManager {
             item_count.add_css_class("dim-label");
             overlay.add_overlay(item_count);
             notify["item"].connect((pspec) => { on_item_set(); });
+            notify["texture-cache"].connect((pspec) => {
+                if (texture_cache == null)
+                    return;
+                texture_cache.texture_ready.connect(on_texture_ready);
+                texture_cache.invalidated.connect(on_item_set);
+            });
             notify["size"].connect((pspec) => {
                 attrs.change(Pango.AttrSize.new(size.to_preview_size() * Pango.SCALE));
             });
         }
 
+        public static int get_texture_size (PreviewTileSize size) {
+            // Frame border
+            return (int) size - 2;
+        }
+
+        public static string get_display_text (Family family, string? preview_text) {
+            if (preview_text != null && preview_text.strip() != "")
+                return preview_text;
+            string? sample = family.preview_text;
+            return have_valid_preview_text(sample) ? sample : family.family;
+        }
+
         public void reset () {
+            picture.set_paintable(null);
+            picture.set_visible(false);
+            preview.set_visible(true);
             preview.set_text(null);
             set_tooltip_text(null);
             set_size_request(size, size);
@@ -171,17 +200,46 @@ namespace FontManager {
                 return;
             Family f = (Family) item;
             set_tooltip_text(f.family);
-            string? sample = f.preview_text;
-            string display_text = have_valid_preview_text(sample) ? sample : f.family;
-            if (preview_text != null && preview_text.strip() != "")
-                display_text = preview_text;
+            var count = (int) f.n_variations;
+            item_count.set_label(count.to_string());
+            item_count.set_visible(count > 1);
+            string display_text = get_display_text(f, preview_text);
+            // Pre-rendered sample avoids shaping and loading the font on the main thread
+            if (show_cached_texture(f, display_text))
+                return;
             preview.set_text(display_text);
             Pango.FontDescription font_desc;
             font_desc = Pango.FontDescription.from_string(f.description);
             attrs.change(new Pango.AttrFontDesc(font_desc));
-            var count = (int) f.n_variations;
-            item_count.set_label(count.to_string());
-            item_count.set_visible(count > 1);
+            if (texture_cache != null) {
+                int texture_size = get_texture_size(size);
+                texture_cache.request(f.description, display_text, size.to_preview_size(),
+                                      texture_size, texture_size);
+            }
+            return;
+        }
+
+        bool show_cached_texture (Family family, string display_text) {
+            if (texture_cache == null)
+                return false;
+            int texture_size = get_texture_size(size);
+            Gdk.Texture? texture = texture_cache.lookup(family.description, display_text,
+                                                        size.to_preview_size(),
+                                                        texture_size, texture_size);
+            if (texture == null)
+                return false;
+            picture.set_paintable(texture);
+            picture.set_visible(true);
+            preview.set_visible(false);
+            return true;
+        }
+
+        void on_texture_ready (string description) {
+            if (item == null || picture.visible)
+                return;
+            Family f = (Family) item;
+            if (f.description == description)
+                show_cached_texture(f, get_display_text(f, preview_text));
             return;
         }
 
@@ -192,19 +250,40 @@ namespace FontManager {
         public PreviewTileSize size { get; set; default = PreviewTileSize.LARGE; }
         public string? preview_text { get; set; default = null; }
 
+        // Pixel data kept around for previously displayed tiles
+        const size_t TEXTURE_CACHE_SIZE = 96 * 1024 * 1024;
+        // Rows rendered ahead of time above and below the visible area
+        const int PREFETCH_ROWS = 3;
+        // Tile margins
+        const int TILE_SPACING = 12;
+
         unowned Gtk.ScrolledWindow container;
+        PreviewTextureCache texture_cache;
 
         public FontGridView (Gtk.ScrolledWindow parent) {
             container = parent;
             model = new FontModel();
+            texture_cache = new PreviewTextureCache(TEXTURE_CACHE_SIZE);
             parent.map.connect(() => {
                 if (list == null)
                     create_gridview();
+                texture_cache.update_style(list);
                 queue_update();
             });
+            parent.vadjustment.value_changed.connect(prefetch_tiles);
+            Gtk.Settings? gtk_settings = Gtk.Settings.get_default();
+            if (gtk_settings != null) {
+                gtk_settings.notify["gtk-application-prefer-dark-theme"].connect(queue_style_update);
+                gtk_settings.notify["gtk-theme-name"].connect(queue_style_update);
+                gtk_settings.notify["gtk-xft-dpi"].connect(queue_style_update);
+            }
+#if HAVE_ADWAITA
+            if (Adw.is_initialized())
+                Adw.StyleManager.get_default().notify["dark"].connect(queue_style_update);
+#endif
             notify["size"].connect(() => { queue_update(); });
             notify["preview-text"].connect_after(() => { queue_update(); });
-            bind_property("available-fonts", model, "entries", BindingFlags.DEFAULT, null, null);
+            bind_property("available-fonts", model, "table", BindingFlags.DEFAULT, null, null);
         }
 
         public void set_search_entry (Gtk.SearchEntry entry) {
@@ -220,6 +299,7 @@ namespace FontManager {
                 max_columns = 36
             };
             selection = new Gtk.SingleSelection(model) { autoselect = false };
+            list.notify["scale-factor"].connect(() => { texture_cache.update_style(list); });
             container.set_child(list);
             container.set_visible(true);
             if (model.n_items > 0)
@@ -232,7 +312,7 @@ namespace FontManager {
 
         protected override void setup_list_row (Gtk.SignalListItemFactory factory, Object item) {
             Gtk.ListItem list_item = (Gtk.ListItem) item;
-            var child = new FontPreviewTile();
+            var child = new FontPreviewTile() { texture_cache = texture_cache };
             bind_property("size", child, "size", BindingFlags.DEFAULT | BindingFlags.SYNC_CREATE);
             bind_property("preview-text", child, "preview-text", BindingFlags.DEFAULT | BindingFlags.SYNC_CREATE);
             list_item.set_child(child);
@@ -259,6 +339,55 @@ namespace FontManager {
             return;
         }
 
+        // Wait for the new colors to be applied before rendering with them
+        void queue_style_update () {
+            Idle.add(() => {
+                if (list != null)
+                    texture_cache.update_style(list);
+                return GLib.Source.REMOVE;
+            });
+            return;
+        }
+
+        void request_textures (uint start, uint end) {
+            int texture_size = FontPreviewTile.get_texture_size(size);
+            int size_points = size.to_preview_size();
+            for (uint i = start; i < end; i++) {
+                var family = (Family) model.get_item(i);
+                string display_text = FontPreviewTile.get_display_text(family, preview_text);
+                texture_cache.request(family.description, display_text, size_points,
+                                      texture_size, texture_size);
+            }
+            return;
+        }
+
+        // Tile dimensions are fixed so the visible range can be estimated
+        // from the scroll position without asking the grid for its rows.
+        void prefetch_tiles () {
+            if (list == null || model == null)
+                return;
+            uint n_items = model.get_n_items();
+            int tile_size = (int) size + TILE_SPACING;
+            int width = container.get_width();
+            if (n_items == 0 || width <= 0)
+                return;
+            texture_cache.update_style(list);
+            var grid = (Gtk.GridView) list;
+            uint columns = ((uint) (width / tile_size)).clamp(grid.min_columns, grid.max_columns);
+            Gtk.Adjustment adjustment = container.vadjustment;
+            int first_row = (int) (adjustment.value / tile_size);
+            int last_row = first_row + (int) (adjustment.page_size / tile_size) + 1;
+            uint visible_start = uint.min((uint) first_row * columns, n_items);
+            uint visible_end = uint.min((uint) last_row * columns, n_items);
+            uint prefetch_start = (uint) int.max(first_row - PREFETCH_ROWS, 0) * columns;
+            uint prefetch_end = uint.min((uint) (last_row + PREFETCH_ROWS) * columns, n_items);
+            // Most recent requests are rendered first, queue visible tiles last
+            request_textures(visible_end, prefetch_end);
+            request_textures(prefetch_start, visible_start);
+            request_textures(visible_start, visible_end);
+            return;
+        }
+
     }
 
     public enum BrowsePreviewMode {
@@ -497,7 +626,7 @@ namespace FontManager {
     public class BrowsePane : Gtk.Box {
 
         public double pane_position { get; set; default = 55.0f; }
-        public Json.Array? available_fonts { get; set; default = null; }
+        public FontTable? available_fonts { get; set; default = null; }
         public Reject? disabled_families { get; set; default = null; }
         public PreviewTileSize size { get; set; default = PreviewTileSize.LARGE; }
         public BrowseMode mode { get; set; default = BrowseMode.GRID; }
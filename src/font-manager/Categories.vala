@@ -277,19 +277,133 @@ namespace FontManager {
         return filters;
     }
 
+    // Columns 2 - 5 follow the order of attributes, 6 - 8 the order of metadata
+    // Filepath and owner are used to sort faces into the base categories
+    const string SELECT_CATEGORY_DATA = "SELECT Fonts.family, Fonts.description, Fonts.width, Fonts.weight, Fonts.slant, Fonts.spacing, Metadata.[license-type], Metadata.vendor, Metadata.filetype, Panose.P0, Fonts.filepath, Metadata.owner FROM Fonts LEFT JOIN Metadata USING (filepath, findex) LEFT JOIN Panose USING (filepath, findex);";
+    const int ATTRIBUTE_COLUMN = 2;
+    const int METADATA_COLUMN = 6;
+    const int PANOSE_COLUMN = 9;
+    const int FILEPATH_COLUMN = 10;
+    const int OWNER_COLUMN = 11;
+
+    // Collects the children of a category, keyed by the column value they group
+    class CategoryBuilder {
+
+        public Category category;
+        public FilterData data;
+        public bool numeric;
+
+        // Values which should not be grouped map to null
+        HashTable <string, Category?> children;
+
+        public CategoryBuilder (Category category, FilterData data, bool numeric) {
+            this.category = category;
+            this.data = data;
+            this.numeric = numeric;
+            children = new HashTable <string, Category?> (str_hash, str_equal);
+        }
+
+        public void add (Sqlite.Statement row, int column) {
+            if (row.column_type(column) == Sqlite.NULL)
+                return;
+            string key = row.column_text(column);
+            unowned string? orig_key;
+            unowned Category? existing;
+            if (children.lookup_extended(key, out orig_key, out existing)) {
+                if (existing != null)
+                    add_face(existing, row);
+                return;
+            }
+            Category? child = numeric ? construct_attribute_category(data, row.column_int(column))
+                            : construct_info_category(data, key);
+            children.insert(key, child);
+            if (child != null)
+                add_face(child, row);
+            return;
+        }
+
+        // Children are sorted by value, like the queries they replace
+        public Category finish () {
+            List <unowned string> keys = children.get_keys();
+            if (numeric)
+                keys.sort((a, b) => { return int.parse(a) - int.parse(b); });
+            else
+                keys.sort(strcmp);
+            foreach (unowned string key in keys) {
+                Category? child = children.lookup(key);
+                if (child == null)
+                    continue;
+                child.depth = 1;
+                child.update_required = false;
+                category.children.add(child);
+            }
+            return category;
+        }
+
+    }
+
+    void add_face (Category category, Sqlite.Statement row) {
+        category.families.add(row.column_text(0));
+        category.variations.add(row.column_text(1));
+        return;
+    }
+
+    // Same as the queries used by the base categories
+    void add_to_base_categories (GenericArray <Category> filters, Sqlite.Statement row, string user_font_dir) {
+        add_face(filters[0], row);
+        string? filepath = row.column_text(FILEPATH_COLUMN);
+        if (filepath == null)
+            return;
+        bool system_owned = row.column_type(OWNER_COLUMN) != Sqlite.NULL && row.column_int(OWNER_COLUMN) != 0;
+        if (system_owned && filepath.has_prefix("/usr"))
+            add_face(filters[1], row);
+        if (filepath.has_prefix(user_font_dir))
+            add_face(filters[2], row);
+        return;
+    }
+
+    // Builds every category in a single pass over the database, so that their
+    // contents and counts are ready before any selection.
     void get_default_categories (Task task, Object source, void* data, Cancellable? cancellable = null) {
+        int64 span = profiler_begin();
         Database db = DatabaseProxy.get_default_db();
         var filters = get_base_categories();
-        filters.add(construct_panose_filter());
+        string user_font_dir = get_user_font_directory();
+        Category panose = construct_panose_filter();
+        var builders = new GenericArray <CategoryBuilder> ();
         foreach (var entry in attributes)
-            filters.add(construct_attribute_filter(db, entry));
+            builders.add(new CategoryBuilder(construct_category(entry), entry, true));
         foreach (var entry in metadata)
-            filters.add(construct_info_filter(db, entry));
+            builders.add(new CategoryBuilder(construct_category(entry), entry, false));
+        try {
+            db.execute_query(SELECT_CATEGORY_DATA);
+            foreach (unowned Sqlite.Statement row in db) {
+                add_to_base_categories(filters, row, user_font_dir);
+                for (int i = 0; i < attributes.length; i++)
+                    builders[i].add(row, ATTRIBUTE_COLUMN + i);
+                for (int i = 0; i < metadata.length; i++)
+                    builders[attributes.length + i].add(row, METADATA_COLUMN + i);
+                if (row.column_type(PANOSE_COLUMN) == Sqlite.NULL)
+                    continue;
+                int kind = row.column_int(PANOSE_COLUMN);
+                if (kind >= 0 && kind < panose.children.length)
+                    add_face(panose.children[kind], row);
+            }
+            db.end_query();
+        } catch (DatabaseError e) {
+            warning(e.message);
+        }
+        filters.foreach((filter) => { filter.update_required = false; });
+        panose.children.foreach((child) => { child.update_required = false; });
+        filters.add(panose);
+        foreach (var builder in builders)
+            filters.add(builder.finish());
         filters.add(new Unsorted());
         filters.add(new Disabled());
         filters.add(new LanguageFilter());
         var return_val = GLib.Value(typeof(GenericArray));
         return_val.set_boxed(filters);
+        profiler_end(span, "Categories.update");
         task.return_value(return_val);
         return;
     }
@@ -303,60 +417,39 @@ namespace FontManager {
         return panose;
     }
 
-    Category construct_attribute_filter (Database db, FilterData data) {
+    Category construct_category (FilterData data) {
         var name = dgettext(null, data.name);
         var comment = dgettext(null, data.comment);
-        var filter = new Category(name, comment, "folder-symbolic", null, data.index);
-        try {
-            var keyword = data.column;
-            db.execute_query(@"SELECT DISTINCT $keyword FROM Fonts ORDER BY $keyword;");
-            foreach (unowned Sqlite.Statement row in db) {
-                int val = row.column_int(0);
-                string? type = null;
-                if (keyword == "slant")
-                    type = ((Slant) val).to_string();
-                else if (keyword == "spacing")
-                    type = ((Spacing) val).to_string();
-                else if (keyword == "weight")
-                    type = ((Weight) val).to_string();
-                else if (keyword == "width")
-                    type = ((Width) val).to_string();
-                if (type == null)
-                    if (keyword == "slant" || (keyword == "width" && ((Width) val).defined()))
-                        type = _("Normal");
-                    // Ignore random widths and weights
-                    else if (keyword == "width" || (keyword == "weight" && !((Weight) val).defined()))
-                        continue;
-                    else
-                        type = _("Regular");
-                filter.children.add(new Category(type, type, "emblem-documents-symbolic", @"$SELECT_FROM_FONTS WHERE $keyword='$val';", data.index));
-            }
-            db.end_query();
-        } catch (DatabaseError e) {
-            warning(e.message);
-        }
-        filter.children.foreach((child) => { child.depth = 1; });
-        return filter;
+        return new Category(name, comment, "folder-symbolic", null, data.index);
     }
 
-    Category construct_info_filter (Database db, FilterData data) {
+    // Returns null for values which should not be grouped
+    Category? construct_attribute_category (FilterData data, int val) {
+        var keyword = data.column;
+        string? type = null;
+        if (keyword == "slant")
+            type = ((Slant) val).to_string();
+        else if (keyword == "spacing")
+            type = ((Spacing) val).to_string();
+        else if (keyword == "weight")
+            type = ((Weight) val).to_string();
+        else if (keyword == "width")
+            type = ((Width) val).to_string();
+        if (type == null)
+            if (keyword == "slant" || (keyword == "width" && ((Width) val).defined()))
+                type = _("Normal");
+            // Ignore random widths and weights
+            else if (keyword == "width" || (keyword == "weight" && !((Weight) val).defined()))
+                return null;
+            else
+                type = _("Regular");
+        return new Category(type, type, "emblem-documents-symbolic", @"$SELECT_FROM_FONTS WHERE $keyword='$val';", data.index);
+    }
+
+    Category construct_info_category (FilterData data, string _type) {
         string keyword = data.column.replace("\"", "\\\"").replace("'", "''");
-        var name = dgettext(null, data.name);
-        var comment = dgettext(null, data.comment);
-        var filter = new Category(name, comment, "folder-symbolic", null, data.index);
-        try {
-            db.execute_query(@"SELECT DISTINCT [$keyword] FROM Metadata ORDER BY [$keyword];");
-            foreach (unowned Sqlite.Statement row in db) {
-                string _type = row.column_text(0);
-                string type = dgettext(null, _type);
-                filter.children.add(new Category(type, type, "emblem-documents", @"$SELECT_FROM_METADATA_WHERE [$keyword]='$_type';", data.index));
-            }
-            db.end_query();
-        } catch (DatabaseError e) {
-            warning(e.message);
-        }
-        filter.children.foreach((child) => { child.depth = 1; });
-        return filter;
+        string type = dgettext(null, _type);
+        return new Category(type, type, "emblem-documents", @"$SELECT_FROM_METADATA_WHERE [$keyword]='$_type';", data.index);
     }
 
 }
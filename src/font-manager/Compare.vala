@@ -26,8 +26,6 @@ namespace FontManager {
         public double preview_size { get; set; default = LARGE_PREVIEW_SIZE; }
         public Gdk.RGBA foreground_color { get; set; }
         public Gdk.RGBA background_color { get; set; }
-        public Pango.FontDescription? font_desc { get; set; default = null; }
-        public Pango.AttrList? attrs { get; set; default = null; }
 
         public string? preview_text {
             get {
@@ -56,16 +54,6 @@ namespace FontManager {
             Object(item: item, preview_text: preview_text);
             initial_preview = default_preview;
             local_pangram = get_localized_pangram();
-            font_desc = Pango.FontDescription.from_string(description);
-            attrs = new Pango.AttrList();
-            attrs.insert(Pango.attr_fallback_new(false));
-            attrs.insert(new Pango.AttrFontDesc(font_desc));
-            font_desc.set_absolute_size(preview_size * Pango.SCALE);
-            notify["preview-size"].connect(() => {
-                font_desc.set_absolute_size(preview_size * Pango.SCALE);
-                attrs.change(new Pango.AttrFontDesc(font_desc));
-                notify_property("attrs");
-            });
         }
 
     }
@@ -105,19 +93,140 @@ namespace FontManager {
 
     }
 
+    // Displays samples rendered in the background by a PreviewTextureCache.
+    // While the texture for the current size is pending, the last one
+    // displayed is scaled to fit instead of shaping the text again.
+    public class ComparePreviewArea : Gtk.Widget {
+
+        public PreviewTextureCache? texture_cache { get; set; default = null; }
+        public string? description { get; set; default = null; }
+        public string? preview_text { get; set; default = null; }
+        public double preview_size { get; set; default = LARGE_PREVIEW_SIZE; }
+
+        Gdk.Texture? texture = null;
+        double texture_size = LARGE_PREVIEW_SIZE;
+
+        construct {
+            notify["description"].connect(on_sample_changed);
+            notify["preview-text"].connect(on_sample_changed);
+            notify["preview-size"].connect(() => { update(); });
+            notify["texture-cache"].connect(() => {
+                if (texture_cache == null)
+                    return;
+                texture_cache.texture_ready.connect(on_texture_ready);
+                texture_cache.invalidated.connect(on_sample_changed);
+            });
+        }
+
+        // preview_size is an absolute size in pixels, textures are rendered
+        // at the resolution of the list rather than a fixed 96 DPI
+        double get_size_points () {
+            return preview_size * 72.0 / texture_cache.get_resolution();
+        }
+
+        // Logical pixels per texture pixel at the current preview size
+        double get_texture_scale () {
+            return (preview_size / texture_size) / get_scale_factor();
+        }
+
+        void update () {
+            if (texture_cache == null || description == null || preview_text == null)
+                return;
+            double size_points = get_size_points();
+            Gdk.Texture? exact = texture_cache.lookup(description, preview_text, size_points, -1, -1);
+            if (exact != null) {
+                texture = exact;
+                texture_size = preview_size;
+            } else {
+                texture_cache.request(description, preview_text, size_points, -1, -1);
+            }
+            queue_resize();
+            return;
+        }
+
+        void on_sample_changed () {
+            texture = null;
+            update();
+            return;
+        }
+
+        void on_texture_ready (string description) {
+            if (description == this.description)
+                update();
+            return;
+        }
+
+        public override Gtk.SizeRequestMode get_request_mode () {
+            return Gtk.SizeRequestMode.CONSTANT_SIZE;
+        }
+
+        public override void measure (Gtk.Orientation orientation,
+                                      int for_size,
+                                      out int minimum,
+                                      out int natural,
+                                      out int minimum_baseline,
+                                      out int natural_baseline) {
+            minimum_baseline = natural_baseline = -1;
+            if (texture == null) {
+                // Roughly a line of text until the sample is available
+                bool vertical = (orientation == Gtk.Orientation.VERTICAL);
+                minimum = natural = vertical ? (int) Math.ceil(preview_size * 1.25) : 0;
+                return;
+            }
+            int extent = (orientation == Gtk.Orientation.HORIZONTAL) ? texture.width : texture.height;
+            minimum = natural = (int) Math.ceil(extent * get_texture_scale());
+            return;
+        }
+
+        public override void snapshot (Gtk.Snapshot snapshot) {
+            if (texture == null)
+                return;
+            double scale = get_texture_scale();
+            float width = (float) (texture.width * scale);
+            float height = (float) (texture.height * scale);
+            Graphene.Rect bounds = Graphene.Rect();
+            bounds.init((get_width() - width) / 2, (get_height() - height) / 2, width, height);
+            snapshot.append_scaled_texture(texture, Gsk.ScalingFilter.TRILINEAR, bounds);
+            return;
+        }
+
+    }
+
     [GtkTemplate (ui = "/com/github/FontManager/FontManager/ui/font-manager-compare-row.ui")]
     public class CompareRow : Gtk.Grid {
 
+        public Object? item { get; set; default = null; }
+        public PreviewTextureCache? texture_cache { get; set; default = null; }
+
         [GtkChild] unowned Gtk.Label description;
-        [GtkChild] unowned Gtk.Label preview;
+        [GtkChild] unowned ComparePreviewArea preview;
 
-        public static CompareRow from_item (Object item) {
-            var row = new CompareRow();
-            BindingFlags flags = BindingFlags.DEFAULT | BindingFlags.SYNC_CREATE;
-            item.bind_property("description", row.description, "label", flags);
-            item.bind_property("preview-text", row.preview, "label", flags);
-            item.bind_property("attrs", row.preview, "attributes", flags);
-            return row;
+        GenericArray <Binding> bindings;
+
+        construct {
+            bindings = new GenericArray <Binding> ();
+            bind_property("texture-cache", preview, "texture-cache", BindingFlags.SYNC_CREATE);
+            notify["item"].connect((pspec) => { on_item_set(); });
+        }
+
+        void on_item_set () {
+            foreach (var binding in bindings)
+                binding.unbind();
+            bindings.remove_range(0, bindings.length);
+            // Avoid requesting a sample for a partially updated row
+            preview.freeze_notify();
+            if (item == null) {
+                preview.description = null;
+                preview.preview_text = null;
+            } else {
+                BindingFlags flags = BindingFlags.DEFAULT | BindingFlags.SYNC_CREATE;
+                bindings.add(item.bind_property("description", description, "label", flags));
+                bindings.add(item.bind_property("description", preview, "description", flags));
+                bindings.add(item.bind_property("preview-text", preview, "preview-text", flags));
+                bindings.add(item.bind_property("preview-size", preview, "preview-size", flags));
+            }
+            preview.thaw_notify();
+            return;
         }
 
     }
@@ -148,15 +257,30 @@ namespace FontManager {
         [GtkChild] unowned Gtk.Button add_button;
         [GtkChild] unowned Gtk.Button remove_button;
         [GtkChild] unowned Gtk.MenuButton pinned_button;
-        [GtkChild] unowned Gtk.ListBox list;
+        [GtkChild] unowned Gtk.ListView list;
+
+        // Pixel data kept around for previously displayed samples
+        const size_t TEXTURE_CACHE_SIZE = 64 * 1024 * 1024;
 
         bool use_adwaita = false;
         string? _preview_text = null;
         string? default_preview_text = null;
+        Gtk.SingleSelection selection;
+        PreviewTextureCache texture_cache;
 
         public ComparePane () {
             widget_set_name(this, "FontManagerCompare");
-            notify["model"].connect(() => { list.bind_model(model, CompareRow.from_item); });
+            texture_cache = new PreviewTextureCache(TEXTURE_CACHE_SIZE);
+            var factory = new Gtk.SignalListItemFactory();
+            factory.setup.connect(setup_list_row);
+            factory.bind.connect(bind_list_row);
+            factory.unbind.connect(unbind_list_row);
+            list.set_factory(factory);
+            notify["model"].connect(() => {
+                selection = new Gtk.SingleSelection(model) { autoselect = false, can_unselect = true };
+                selection.notify["selected"].connect(on_selection_changed);
+                list.set_model(selection);
+            });
             model = new CompareModel();
             pinned = new PinnedComparisons();
             pinned.compare = this;
@@ -173,6 +297,34 @@ namespace FontManager {
                 set_control_sensitivity(pinned_button, have_items);
             });
             list.map.connect_after(force_css_update);
+            list.notify["scale-factor"].connect(() => { texture_cache.update_style(list); });
+            // Wait for the new colors to be applied before rendering with them
+            preview_colors.style_updated.connect(() => {
+                Idle.add(() => {
+                    texture_cache.update_style(list);
+                    return GLib.Source.REMOVE;
+                });
+            });
+        }
+
+        void setup_list_row (Gtk.SignalListItemFactory factory, Object item) {
+            Gtk.ListItem list_item = (Gtk.ListItem) item;
+            list_item.set_child(new CompareRow() { texture_cache = texture_cache });
+            return;
+        }
+
+        void bind_list_row (Gtk.SignalListItemFactory factory, Object item) {
+            Gtk.ListItem list_item = (Gtk.ListItem) item;
+            var row = (CompareRow) list_item.get_child();
+            row.item = list_item.get_item();
+            return;
+        }
+
+        void unbind_list_row (Gtk.SignalListItemFactory factory, Object item) {
+            Gtk.ListItem list_item = (Gtk.ListItem) item;
+            var row = (CompareRow) list_item.get_child();
+            row.item = null;
+            return;
         }
 
         // TODO : Figure out why this is needed.
@@ -182,6 +334,7 @@ namespace FontManager {
         void force_css_update () {
             list.grab_focus();
             list.queue_draw();
+            texture_cache.update_style(list);
             return;
         }
 
@@ -257,9 +410,8 @@ namespace FontManager {
             return;
         }
 
-        [GtkCallback]
-        void on_list_row_selected (Gtk.ListBox box, Gtk.ListBoxRow? row) {
-            set_control_sensitivity(remove_button, row != null);
+        void on_selection_changed () {
+            set_control_sensitivity(remove_button, selection.selected != Gtk.INVALID_LIST_POSITION);
             return;
         }
 
@@ -277,12 +429,12 @@ namespace FontManager {
 
         [GtkCallback]
         void on_remove_button_clicked () {
-            if (list.get_selected_row() == null)
+            uint position = selection.selected;
+            if (position == Gtk.INVALID_LIST_POSITION)
                 return;
-            uint position = list.get_selected_row().get_index();
             model.remove_item(position);
             while (position > 0 && position >= model.get_n_items()) { position--; }
-            list.select_row(list.get_row_at_index((int) position));
+            selection.set_selected(position);
             return;
         }
 
@@ -25,16 +25,54 @@ namespace FontManager {
         public signal void update_started ();
         public signal void update_complete ();
 
+        public uint max_workers { get; set; default = 0; }
+
         GLib.Cancellable? cancellable = null;
         ProgressCallback? progress = null;
 
-        static Database? db = null;
+        // Only connection used to sync the database, see update()
+        static Database? writer = null;
+
+        // Fields searched by FontModel which are only available from the database
+        static Json.Object? search_metadata = null;
+        // Incremented after every sync, anything read from the database before
+        // then may be out of date.
+        public static uint sync_serial = 0;
 
+        // Read-only connection for the calling thread. Never blocks on a sync.
         public static Database get_default_db () {
-            if (db == null)
-                db = new Database();
-            db.ref();
-            return db;
+            return Database.get_reader();
+        }
+
+        // Uses the coverage stored in the database when possible, which avoids
+        // a round trip through fontconfig for every character search.
+        public static Json.Object get_fonts_for_chars (string chars) {
+            try {
+                Json.Object? result = get_default_db().get_available_fonts_for_chars(chars);
+                if (result != null)
+                    return result;
+            } catch (Error e) {
+                warning(e.message);
+            }
+            return get_available_fonts_for_chars(chars);
+        }
+
+        // Returns the PostScript name, designer and vendor of the face at index
+        // in filepath, separated by newlines, or null if unavailable.
+        public static unowned string? get_search_metadata (string filepath, int64 index) {
+            if (search_metadata == null) {
+                try {
+                    search_metadata = get_default_db().get_search_metadata();
+                } catch (Error e) {
+                    warning(e.message);
+                }
+                if (search_metadata == null)
+                    search_metadata = new Json.Object();
+            }
+            string key = "%s:%i".printf(filepath, (int) index);
+            if (!search_metadata.has_member(key))
+                return null;
+            return search_metadata.get_string_member(key);
         }
 
         public void set_cancellable (Cancellable? cancellable) {
@@ -47,16 +85,21 @@ namespace FontManager {
             return;
         }
 
-        public void update (Json.Array available_fonts) {
+        public void update (FontTable available_fonts) {
             update_started();
+            if (writer == null)
+                writer = new Database();
+            writer.max_workers = max_workers;
             update_database.begin(
-                get_default_db(),
+                writer,
                 available_fonts,
                 progress,
                 cancellable,
                 (obj, res) => {
                     try {
                         update_database.end(res);
+                        search_metadata = null;
+                        sync_serial++;
                         update_complete();
                     } catch (Error e) {
                         critical(e.message);
@@ -360,19 +360,8 @@ namespace FontManager {
         public RemoveDialog (Gtk.Window? parent) {
             set_transient_for(parent);
             set_default_dialog_size(parent, this, 60, 70);
-            var fonts = get_available_fonts(null);
-            var sorted_fonts = sort_json_font_listing(fonts);
-            sorted_fonts.foreach_element((a, i, n) => {
-                Json.Object family = n.get_object();
-                family.set_boolean_member("active", false);
-                Json.Array variations = family.get_array_member("variations");
-                variations.foreach_element((a, i, n) => {
-                    n.get_object().set_boolean_member("active", false);
-                });
-            });
-            update_item_preview_text(sorted_fonts);
             remove_list.set_search_entry(entry);
-            remove_list.available_fonts = sorted_fonts;
+            remove_list.available_fonts = get_available_font_table(null);
             delete_button.set_sensitive(false);
             remove_list.changed.connect(() => {
                 bool sensitive = remove_list.selected_files.size > 0;
@@ -426,8 +415,9 @@ namespace FontManager {
                 }
             }
             try {
-                Database db = DatabaseProxy.get_default_db();
-                string [] tables = { "Fonts", "Metadata", "Orthography", "Panose" };
+                // Shared connections are read-only, writes need their own
+                Database db = new Database();
+                string [] tables = { "Fonts", "Metadata", "Orthography", "Panose", "Coverage", "Codepoints", "FileState" };
                 foreach (string table in tables) {
                     foreach (var path in removed) {
                         path = path.replace("'", "''");
@@ -436,7 +426,7 @@ namespace FontManager {
                         db.end_query();
                     }
                 }
-                db.vacuum();
+                db.run_maintenance();
             } catch (Error e) {
                 warning(e.message);
             }
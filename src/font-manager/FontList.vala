@@ -94,7 +94,7 @@ namespace FontManager {
         public signal void activated (uint position);
         public signal void selection_changed (Object? item);
 
-        public Json.Array? available_fonts { get; set; default = null; }
+        public FontTable? available_fonts { get; set; default = null; }
         public Reject? disabled_families { get; set; default = null; }
         public FontListFilter? filter { get; set; default = null; }
 
@@ -118,6 +118,8 @@ namespace FontManager {
         public GenericArray <Object>? selected_children { get; protected set; default = null; }
 
         uint search_timeout = 0;
+        uint pending_selection = 0;
+        bool selection_pending = false;
         string? previously_selected_family = null;
 
         construct {
@@ -143,8 +145,9 @@ namespace FontManager {
             });
             notify["model"].connect(() => {
                 BindingFlags flags = BindingFlags.DEFAULT | BindingFlags.SYNC_CREATE;
-                bind_property("available-fonts", model, "entries", flags, null, null);
+                bind_property("available-fonts", model, "table", flags, null, null);
                 bind_property("filter", model, "filter", flags, null, null);
+                model.items_updated.connect(restore_selection);
             });
             notify["search-entry"].connect(() => {
                 search_entry.activate.connect(next_match);
@@ -176,17 +179,26 @@ namespace FontManager {
         requires (model != null) {
             if (search_entry != null)
                 model.search_term = search_entry.text.strip();
+            // Filtering may complete asynchronously, selection is restored once
+            // the model signals that its items have been updated.
+            pending_selection = position;
+            selection_pending = true;
             model.update_items();
+            return;
+        }
+
+        void restore_selection () {
+            if (!selection_pending)
+                return;
+            selection_pending = false;
+            uint position = pending_selection;
             if (previously_selected_family == null || position != 0)
                 select_item(position);
             else {
-                uint n_items = model.n_items;
-                for (uint i = 0; i < n_items; i++) {
-                    Family family = (Family) model.get_item(i);
-                    if (family.family == previously_selected_family) {
-                        select_item(i);
-                        return;
-                    }
+                uint previous = model.find_family(previously_selected_family);
+                if (previous != uint.MAX) {
+                    select_item(previous);
+                    return;
                 }
             }
             select_item(0);
@@ -764,6 +776,8 @@ namespace FontManager {
             controls.visible = false;
             treemodel.set_autoexpand(true);
             selected_files = new StringSet();
+            // Nothing is selected for removal initially
+            model.active_by_default = false;
             selection = new Gtk.NoSelection(treemodel);
             filter = new UserFonts();
             filter.update.begin();
@@ -22,6 +22,150 @@ internal int64 GET_INDEX (Json.Object o) { return o.get_int_member("_index"); }
 
 namespace FontManager {
 
+    // Entry counts at or below this are filtered synchronously, child models
+    // in particular need to be populated by the time they're returned.
+    const uint SYNC_FILTER_THRESHOLD = 256;
+    // Maximum time spent filtering per main loop iteration, in microseconds
+    const int64 FILTER_TIME_SLICE = 8000;
+
+    // Casefolded strings used when matching search terms, computed once per face.
+    // Covers the same fields as Database.search so that results are consistent.
+    // filepath is only matched by searches starting with "/", nearly every path
+    // contains terms like "share" or "font".
+    class SearchKeys {
+
+        public string family;
+        public string description;
+        public string style;
+        public string filepath;
+        // PostScript name, designer and vendor, if the face is in the database
+        public string? metadata = null;
+
+        public SearchKeys (string family, string description, string style, string filepath, int findex) {
+            this.family = family.casefold();
+            this.description = description.casefold();
+            this.style = style.casefold();
+            this.filepath = filepath.casefold();
+            unowned string? fields = DatabaseProxy.get_search_metadata(filepath, findex);
+            if (fields != null)
+                metadata = fields.casefold();
+        }
+
+        public bool contains (string needle) {
+            return family.contains(needle) ||
+                   description.contains(needle) ||
+                   style.contains(needle) ||
+                   (metadata != null && metadata.contains(needle));
+        }
+
+    }
+
+    // Maps trigrams to the sorted ids of the documents containing them.
+    // Trigrams are hashed, so query results may contain false positives
+    // and every candidate still needs to be checked against the search term.
+    class TrigramIndex {
+
+        uint n_documents = 0;
+        HashTable <uint, GenericArray <uint>> postings;
+
+        public TrigramIndex () {
+            postings = new HashTable <uint, GenericArray <uint>> (direct_hash, direct_equal);
+        }
+
+        static uint hash_trigram (unichar a, unichar b, unichar c) {
+            return ((uint) a * 0x9E3779B1U) ^ ((uint) b * 0x85EBCA77U) ^ (uint) c;
+        }
+
+        public static GenericArray <uint> intersect (GenericArray <uint> a, GenericArray <uint> b) {
+            var result = new GenericArray <uint> ();
+            uint i = 0, j = 0;
+            while (i < a.length && j < b.length) {
+                if (a[i] < b[j])
+                    i++;
+                else if (a[i] > b[j])
+                    j++;
+                else {
+                    result.add(a[i]);
+                    i++;
+                    j++;
+                }
+            }
+            return result;
+        }
+
+        // Documents are assigned ids sequentially, starting at 0
+        public void add (string text) {
+            uint id = n_documents++;
+            unichar a = 0, b = 0, c = 0;
+            int i = 0, n = 0;
+            while (text.get_next_char(ref i, out c)) {
+                if (n++ >= 2) {
+                    uint key = hash_trigram(a, b, c);
+                    unowned GenericArray <uint>? ids = postings.lookup(key);
+                    if (ids == null) {
+                        var new_ids = new GenericArray <uint> ();
+                        new_ids.add(id);
+                        postings.insert(key, (owned) new_ids);
+                    } else if (ids[ids.length - 1] != id) {
+                        ids.add(id);
+                    }
+                }
+                a = b;
+                b = c;
+            }
+            return;
+        }
+
+        // Returns null if needle is too short to narrow down results
+        public GenericArray <uint>? query (string needle) {
+            GenericArray <uint>? result = null;
+            unichar a = 0, b = 0, c = 0;
+            int i = 0, n = 0;
+            while (needle.get_next_char(ref i, out c)) {
+                if (n++ >= 2) {
+                    unowned GenericArray <uint>? ids = postings.lookup(hash_trigram(a, b, c));
+                    if (ids == null)
+                        return new GenericArray <uint> ();
+                    result = intersect(result ?? ids, ids);
+                    if (result.length == 0)
+                        return result;
+                }
+                a = b;
+                b = c;
+            }
+            return result;
+        }
+
+    }
+
+    // State for a single filtering pass, discarded if the pass is superseded.
+    // Faces are referred to by their position in BaseFontModel.faces.
+    class FilterPass {
+
+        public bool ready = false;
+        public string? search = null;
+        public string []? needles = null;
+        public FontListFilter? filter = null;
+        // Faces which may match the search term, null if every face needs to be checked
+        public Gtk.Bitset? candidates = null;
+        // Cached results for filter, null if unavailable or no filtering is required
+        public Gtk.Bitset? filter_matches = null;
+        // Results for filter collected during this pass, to be cached once complete
+        public Gtk.Bitset? new_filter_matches = null;
+        // Faces which have yet to be checked
+        public Gtk.Bitset? remaining = null;
+        // Number of matching faces for each entry
+        public int [] n_matches = {};
+
+        public FilterPass (string? search_term) {
+            if (search_term == null || search_term.strip() == "")
+                return;
+            search = search_term.strip().casefold();
+            needles = search.split_set(" \t\n", -1);
+        }
+
+    }
+
     public class BaseFontModel : Object, ListModel {
 
         public signal void items_updated ();
@@ -29,16 +173,59 @@ namespace FontManager {
         public Type item_type { get; protected set; default = typeof(Object); }
         public uint n_items { get { return get_n_items(); } }
         public Json.Array? entries { get; set; default = null; }
-        public GenericArray <unowned Json.Object>? items { get; protected set; default = null; }
+        // Used instead of entries if set. Items are only converted to
+        // Json.Objects once they're requested, see get_item.
+        public FontTable? table { get; set; default = null; }
+        // Value of the active member of items created from table
+        public bool active_by_default { get; set; default = true; }
         public string? search_term { get; set; default = null; }
         public FontListFilter? filter { get; set; default = null; }
 
         string? char_search = null;
         Json.Object? char_support = null;
 
+        uint filter_source = 0;
+        Font filter_font;
+        SearchKeys? [] search_keys = {};
+        TrigramIndex? trigram_index = null;
+        // Search keys and preview text include fields from the database,
+        // these are compared to DatabaseProxy.sync_serial to detect changes.
+        uint search_serial = 0;
+        uint preview_serial = 0;
+
+        // Visible items, if entries is the source
+        GenericArray <unowned Json.Object> items;
+        // Table the visible families belong to. Differs from table until
+        // the first pass over a new table is complete.
+        FontTable? visible_table = null;
+        // Ids of the visible families in visible_table
+        uint [] visible_families = {};
+        // Number of visible variations for each family in visible_table
+        int [] n_variations = {};
+        // Family objects created from visible_table so far, keyed by family id
+        HashTable <uint, Json.Object> family_objects;
+
+        // Every face in entries gets a dense id, its position in this array.
+        // Faces in table already have dense ids.
+        GenericArray <unowned Json.Object>? faces = null;
+        // Position in entries of the item each face belongs to
+        uint [] face_entry = {};
+        // Faces belonging to each family, see get_family_matches
+        HashTable <string, Gtk.Bitset>? family_faces = null;
+
+        // Results for filters whose matches only change when they emit changed.
+        // Filters are not referenced, entries are dropped once they're finalized.
+        HashTable <unowned FontListFilter, Gtk.Bitset> filter_cache;
+        GenericSet <unowned FontListFilter> watched_filters;
+
         construct {
             items = new GenericArray <unowned Json.Object> ();
-            notify["entries"].connect(() => { update_items(); });
+            filter_font = new Font();
+            family_objects = new HashTable <uint, Json.Object> (direct_hash, direct_equal);
+            filter_cache = new HashTable <unowned FontListFilter, Gtk.Bitset> (direct_hash, direct_equal);
+            watched_filters = new GenericSet <unowned FontListFilter> (direct_hash, direct_equal);
+            notify["entries"].connect(on_source_changed);
+            notify["table"].connect(on_source_changed);
             notify["filter"].connect_after(() => {
                 if (filter == null)
                     return;
@@ -49,49 +236,213 @@ namespace FontManager {
             });
         }
 
+        public override void dispose () {
+            cancel_update();
+            foreach (unowned FontListFilter target in watched_filters.get_values()) {
+                target.weak_unref(on_filter_finalized);
+                target.changed.disconnect(on_filter_changed);
+            }
+            watched_filters.remove_all();
+            filter_cache.remove_all();
+            base.dispose();
+            return;
+        }
+
+        void on_source_changed () {
+            faces = null;
+            face_entry = {};
+            family_faces = null;
+            search_keys = {};
+            trigram_index = null;
+            filter_cache.remove_all();
+            update_items();
+            return;
+        }
+
         public Type get_item_type () {
             return item_type;
         }
 
         public uint get_n_items () {
-            return items != null ? items.length : 0;
+            return visible_table != null ? visible_families.length : items.length;
         }
 
         public Object? get_item (uint position) {
-            if (items == null || get_n_items() < 1 || position >= get_n_items())
+            if (position >= get_n_items())
                 return null;
-            return_val_if_fail(items[position] != null, null);
+            Json.Object? item = visible_table != null ? get_family_object(visible_families[position])
+                                                      : items[position];
+            return_val_if_fail(item != null, null);
             Object retval = Object.new(item_type);
-            retval.set("source-object", items[position], null);
+            retval.set("source-object", item, null);
             return retval;
         }
 
-        string get_filepath_from_object (Json.Object item) {
-            if (item.has_member("filepath"))
-                return item.get_string_member("filepath");
-            if (item.has_member("variations")) {
-                Family family = new Family() { source_object = item };
-                Json.Object? default_variant = family.get_default_variant();
-                if (default_variant != null)
-                    return default_variant.get_string_member("filepath");
+        /**
+         * Returns the position of family or uint.MAX if it's not visible.
+         * Avoids creating an object for every item checked.
+         */
+        public uint find_family (string family) {
+            uint n = get_n_items();
+            for (uint i = 0; i < n; i++) {
+                unowned string name = visible_table != null ? visible_table.get_family_name(visible_families[i])
+                                                            : items[i].get_string_member("family");
+                if (name == family)
+                    return i;
             }
-            return "";
+            return uint.MAX;
         }
 
-        bool array_matches (string [] needles, string style, string description) {
-            foreach (var term in needles)
-                if (style.contains(term) || description.contains(term))
-                    continue;
-                else
-                    return false;
-            return true;
+        void update_family_object (uint family, Json.Object item) {
+            if (family < n_variations.length)
+                item.set_int_member("n-variations", n_variations[family]);
+            return;
         }
 
-        bool matches_search_term (Json.Object item) {
+        Json.Object get_family_object (uint family) {
+            // Preview text may have changed along with the database
+            if (preview_serial != DatabaseProxy.sync_serial) {
+                preview_serial = DatabaseProxy.sync_serial;
+                family_objects.foreach((id, item) => { update_item_preview_text(item); });
+            }
+            Json.Object? item = family_objects.lookup(family);
+            if (item == null) {
+                item = visible_table.get_family_object(family);
+                if (!active_by_default) {
+                    item.set_boolean_member("active", false);
+                    item.get_array_member("variations").foreach_element((a, i, n) => {
+                        n.get_object().set_boolean_member("active", false);
+                    });
+                }
+                update_item_preview_text(item);
+                family_objects.insert(family, item);
+            }
+            update_family_object(family, item);
+            return item;
+        }
+
+        uint get_n_faces () {
+            return table != null ? table.get_n_faces() : faces.length;
+        }
+
+        uint get_face_entry (uint id) {
+            return table != null ? table.get_family(id) : face_entry[id];
+        }
+
+        unowned string get_face_family (uint id) {
+            if (table != null)
+                return table.get_family_name(table.get_family(id));
+            return faces[id].get_string_member("family");
+        }
+
+        unowned string get_face_style (uint id) {
+            if (table != null)
+                return table.get_style(id);
+            return faces[id].get_string_member("style");
+        }
+
+        unowned SearchKeys get_search_keys (uint id) {
+            if (search_keys.length != get_n_faces())
+                search_keys = new SearchKeys? [get_n_faces()];
+            if (search_keys[id] == null) {
+                if (table != null) {
+                    search_keys[id] = new SearchKeys(get_face_family(id),
+                                                     table.get_description(id),
+                                                     table.get_style(id),
+                                                     table.get_filepath(id),
+                                                     table.get_findex(id));
+                } else {
+                    unowned Json.Object face = faces[id];
+                    search_keys[id] = new SearchKeys(face.get_string_member("family"),
+                                                     face.get_string_member("description"),
+                                                     face.get_string_member("style"),
+                                                     face.get_string_member("filepath"),
+                                                     (int) face.get_int_member("findex"));
+                }
+            }
+            return search_keys[id];
+        }
+
+        void ensure_faces () {
+            if (table != null || faces != null)
+                return;
+            faces = new GenericArray <unowned Json.Object> ();
+            uint n_entries = entries != null ? entries.get_length() : 0;
+            for (uint i = 0; i < n_entries; i++) {
+                Json.Object item = entries.get_object_element(i);
+                // Iterating through children is necessary to determine if
+                // the family should be visible at all and also to get an
+                // accurate count of currently visible variations.
+                if (item.has_member("variations")) {
+                    Json.Array variants = item.get_array_member("variations");
+                    uint n_variants = variants.get_length();
+                    for (uint v = 0; v < n_variants; v++) {
+                        faces.add(variants.get_object_element(v));
+                        face_entry += i;
+                    }
+                } else {
+                    faces.add(item);
+                    face_entry += i;
+                }
+            }
+            return;
+        }
+
+        uint get_n_entries () {
+            if (table != null)
+                return table.get_n_families();
+            return entries != null ? entries.get_length() : 0;
+        }
+
+        TrigramIndex get_trigram_index () {
+            if (trigram_index != null)
+                return trigram_index;
+            trigram_index = new TrigramIndex();
+            uint n_faces = get_n_faces();
+            for (uint i = 0; i < n_faces; i++) {
+                unowned SearchKeys keys = get_search_keys(i);
+                string text = string.join("\n", keys.family, keys.description, keys.style,
+                                          keys.metadata ?? "");
+                trigram_index.add(text);
+            }
+            return trigram_index;
+        }
+
+        // Filtering large lists is where caching pays off. Child models are
+        // small and short lived, so they skip the caches entirely.
+        bool use_caches () {
+            return get_n_entries() > SYNC_FILTER_THRESHOLD;
+        }
+
+        // Narrows down the faces which need to be checked using the trigram index.
+        Gtk.Bitset? get_candidates (FilterPass pass) {
+            if (pass.search == null || !use_caches())
+                return null;
+            string search = pass.search;
+            // Filepaths aren't indexed, character searches go through the database
+            if (search.has_prefix(Path.SEARCHPATH_SEPARATOR_S) || search.has_prefix(Path.DIR_SEPARATOR_S))
+                return null;
+            TrigramIndex index = get_trigram_index();
+            GenericArray <uint>? ids = null;
+            // Every term must be found within one of the fields
+            foreach (string needle in pass.needles) {
+                GenericArray <uint>? hits = index.query(needle);
+                if (hits != null)
+                    ids = ids != null ? TrigramIndex.intersect(ids, hits) : hits;
+            }
+            if (ids == null)
+                return null;
+            var candidates = new Gtk.Bitset.empty();
+            for (uint i = 0; i < ids.length; i++)
+                candidates.add(ids[i]);
+            return candidates;
+        }
+
+        bool matches_search_term (uint id, FilterPass pass) {
             bool item_matches = true;
-            if (search_term == null || search_term.strip() == "")
+            if (pass.search == null)
                 return item_matches;
-            var search = search_term.strip().casefold();
+            string search = pass.search;
             if (search.has_prefix(Path.DIR_SEPARATOR_S)) {
                 long str_len = search.length;
                 if (str_len < 2)
@@ -99,81 +450,289 @@ namespace FontManager {
                 string needle = search[1:str_len];
                 if (needle == "")
                     return false;
-                string filepath = get_filepath_from_object(item).casefold();
-                item_matches = filepath.contains(needle);
+                item_matches = get_search_keys(id).filepath.contains(needle);
             } else if (search.has_prefix(Path.SEARCHPATH_SEPARATOR_S)) {
                 string needle = search.replace(Path.SEARCHPATH_SEPARATOR_S, "");
                 if (needle == "")
                     return false;
-                string family = item.get_string_member("family");
+                unowned string family = get_face_family(id);
                 if (char_search != needle || char_support == null) {
                     char_search = needle;
-                    char_support = get_available_fonts_for_chars(char_search);
+                    char_support = DatabaseProxy.get_fonts_for_chars(char_search);
                 }
                 item_matches = char_support.has_member(family);
-                if (item_matches && item.has_member("style")) {
+                if (item_matches) {
                     Json.Object family_obj = char_support.get_object_member(family);
-                    item_matches = family_obj.has_member(item.get_string_member("style"));
+                    item_matches = family_obj.has_member(get_face_style(id));
                 }
             } else {
-                string family = item.get_string_member("family").casefold();
-                string description = item.get_string_member("description").casefold();
-                // Best case scenario, searching for a particular family
-                item_matches = family.contains(search);
-                // or the search term directly matches the font description
-                if (!item_matches)
-                    item_matches = description.contains(search);
-                // possible we have multiple search terms
-                if (!item_matches && item.has_member("style")) {
-                    string [] needles = search.split_set(" ", -1);
-                    string style = item.get_string_member("style").casefold();
-                    item_matches = array_matches(needles, style, description);
-                }
+                // Same as Database.search, every term must be found within one of
+                // the family, style, description, PostScript name, designer or vendor
+                // of a face.
+                unowned SearchKeys keys = get_search_keys(id);
+                foreach (string needle in pass.needles)
+                    if (!keys.contains(needle))
+                        return false;
             }
             return item_matches;
         }
 
-        bool matches_filter (Json.Object item) {
-            if (filter == null || filter is Category && filter.index == CategoryIndex.ALL)
+        bool filter_required () {
+            return !(filter == null || filter is Category && filter.index == CategoryIndex.ALL);
+        }
+
+        bool matches_filter (uint id) {
+            if (!filter_required())
                 return true;
-            Type type = item.has_member("filepath") ? typeof(Font) : typeof(Family);
-            Object? object = Object.new(type, JSON_PROXY_SOURCE, item, null);
-            return filter.matches(object);
+            // Faces in table are checked against their columns directly
+            if (table != null)
+                return filter.matches_face(get_face_family(id), table.get_description(id));
+            // Reuse the proxy rather than allocating one per face checked.
+            filter_font.source_object = faces[id];
+            return filter.matches(filter_font);
         }
 
-        // TODO : Figure out how to do this async, without horrible side effects...
-        //        Like breaking scrolling in browse mode and pane positioning in other modes.
-        public void update_items () {
-            uint n_items = get_n_items();
-            items = null;
-            items = new GenericArray <unowned Json.Object> ();
-            if (n_items > 0)
-                items_changed(0, n_items, 0);
-            if (entries != null) {
-                entries.foreach_element((array, index, node) => {
-                    Json.Object item = node.get_object();
-                    // Iterating through children is necessary to determine if
-                    // the family should be visible at all and also to get an
-                    // accurate count of currently visible variations.
-                    if (item.has_member("variations")) {
-                        Json.Array variants = item.get_array_member("variations");
-                        int n_matches = 0;
-                        variants.foreach_element((a, i, n) => {
-                            Json.Object v = n.get_object();
-                            if (matches_search_term(v) && matches_filter(v))
-                                n_matches++;
-                        });
-                        item.set_int_member("n-variations", n_matches);
-                        if (n_matches > 0)
-                            items.add(item);
-                    } else if (matches_search_term(item) && matches_filter(item)) {
-                        items.add(item);
+        void on_filter_changed (Cacheable target) {
+            filter_cache.remove((FontListFilter) target);
+            return;
+        }
+
+        void on_filter_finalized (Object target) {
+            filter_cache.remove((FontListFilter) target);
+            watched_filters.remove((FontListFilter) target);
+            return;
+        }
+
+        void cache_filter_matches (FontListFilter target, Gtk.Bitset matches) {
+            if (!watched_filters.contains(target)) {
+                watched_filters.add(target);
+                target.weak_ref(on_filter_finalized);
+                target.changed.connect(on_filter_changed);
+            }
+            filter_cache.insert(target, matches);
+            return;
+        }
+
+        // Collects the faces of every family in families, or every other face
+        // if exclude is true. Cheap enough that results need not be cached.
+        Gtk.Bitset get_family_matches (StringSet families, bool exclude) {
+            uint n_faces = get_n_faces();
+            if (family_faces == null) {
+                family_faces = new HashTable <string, Gtk.Bitset> (str_hash, str_equal);
+                for (uint i = 0; i < n_faces; i++) {
+                    unowned string family = get_face_family(i);
+                    unowned Gtk.Bitset? ids = family_faces.lookup(family);
+                    if (ids == null) {
+                        var new_ids = new Gtk.Bitset.empty();
+                        new_ids.add(i);
+                        family_faces.insert(family, (owned) new_ids);
+                    } else {
+                        ids.add(i);
                     }
+                }
+            }
+            var matches = new Gtk.Bitset.empty();
+            foreach (string family in families) {
+                unowned Gtk.Bitset? ids = family_faces.lookup(family);
+                if (ids != null)
+                    matches.union(ids);
+            }
+            if (!exclude)
+                return matches;
+            var others = new Gtk.Bitset.range(0, n_faces);
+            others.subtract(matches);
+            return others;
+        }
+
+        void prepare_pass (FilterPass pass) {
+            ensure_faces();
+            if (search_serial != DatabaseProxy.sync_serial) {
+                search_serial = DatabaseProxy.sync_serial;
+                trigram_index = null;
+                search_keys = {};
+            }
+            pass.ready = true;
+            pass.n_matches = new int [get_n_entries()];
+            pass.candidates = get_candidates(pass);
+            var all_faces = new Gtk.Bitset.range(0, get_n_faces());
+            pass.remaining = pass.candidates != null ? pass.candidates.copy() : all_faces;
+            if (!filter_required())
+                return;
+            pass.filter = filter;
+            pass.filter_matches = filter_cache.lookup(filter);
+            if (pass.filter_matches == null && use_caches()) {
+                StringSet? families = filter.get_matching_families();
+                if (families != null)
+                    pass.filter_matches = get_family_matches(families, filter.excludes_families);
+            }
+            if (pass.filter_matches != null) {
+                // Combining the search with the filter is a simple intersection
+                pass.remaining.intersect(pass.filter_matches);
+            } else if (filter.cache_matches && use_caches()) {
+                // Every face has to be checked to fill the cache for this filter
+                pass.new_filter_matches = new Gtk.Bitset.empty();
+                pass.remaining = all_faces;
+            }
+            return;
+        }
+
+        // Returns true once every face has been processed.
+        // Gives up after time_slice microseconds if time_slice is greater than 0.
+        bool run_filter_pass (FilterPass pass, int64 time_slice) {
+            int64 span = profiler_begin();
+            if (!pass.ready)
+                prepare_pass(pass);
+            int64 deadline = time_slice > 0 ? get_monotonic_time() + time_slice : 0;
+            while (!pass.remaining.is_empty()) {
+                if (deadline > 0 && get_monotonic_time() >= deadline) {
+                    profiler_end(span, "FontModel.filter");
+                    return false;
+                }
+                uint id = pass.remaining.get_minimum();
+                pass.remaining.remove(id);
+                if (pass.new_filter_matches != null) {
+                    if (!matches_filter(id))
+                        continue;
+                    pass.new_filter_matches.add(id);
+                    if (pass.candidates != null && !pass.candidates.contains(id))
+                        continue;
+                } else if (pass.filter_matches == null && !matches_filter(id)) {
+                    continue;
+                }
+                if (matches_search_term(id, pass))
+                    pass.n_matches[get_face_entry(id)]++;
+            }
+            if (pass.new_filter_matches != null)
+                cache_filter_matches(pass.filter, pass.new_filter_matches);
+            profiler_end(span, "FontModel.filter");
+            return true;
+        }
+
+        // Keeps the objects of families which are unchanged in table so that
+        // rows created from them remain valid, everything else is dropped.
+        void carry_over_family_objects () {
+            var carried = new HashTable <uint, Json.Object> (direct_hash, direct_equal);
+            if (visible_table != null) {
+                family_objects.foreach((id, item) => {
+                    int new_id = table.find_family(visible_table.get_family_name(id));
+                    if (new_id < 0 || !visible_table.family_equal(id, table, new_id))
+                        return;
+                    item.set_int_member("_index", new_id);
+                    carried.insert(new_id, item);
                 });
-                items.sort((a, b) => { return (int) (GET_INDEX(a) - GET_INDEX(b)); });
             }
-            items_changed(0, 0, get_n_items());
+            family_objects = carried;
+            return;
+        }
+
+        bool same_row (FontTable old_table, uint old_id, int [] old_variations, uint new_id) {
+            if (old_variations[old_id] != n_variations[new_id])
+                return false;
+            if (old_table == visible_table)
+                return old_id == new_id;
+            return old_table.family_equal(old_id, visible_table, new_id);
+        }
+
+        // Only the range between the first and last changed rows is replaced,
+        // so that a new table which differs by a few families is cheap to apply.
+        void emit_family_changes (FontTable old_table, uint [] old_families, int [] old_variations) {
+            uint n_old = old_families.length, n_new = visible_families.length;
+            uint start = 0, end = 0;
+            while (start < n_old && start < n_new &&
+                   same_row(old_table, old_families[start], old_variations, visible_families[start]))
+                start++;
+            while (end < n_old - start && end < n_new - start &&
+                   same_row(old_table, old_families[n_old - 1 - end], old_variations,
+                            visible_families[n_new - 1 - end]))
+                end++;
+            uint n_removed = n_old - start - end, n_added = n_new - start - end;
+            if (n_removed > 0 || n_added > 0)
+                items_changed(start, n_removed, n_added);
+            return;
+        }
+
+        void publish_results (FilterPass pass) {
+            int64 span = profiler_begin();
+            uint n_removed = get_n_items();
+            // Variation counts are only updated once the pass is complete so that
+            // visible items never reflect the state of an unfinished pass.
+            if (table != null) {
+                uint [] results = {};
+                for (uint i = 0; i < pass.n_matches.length; i++)
+                    if (pass.n_matches[i] > 0)
+                        results += i;
+                FontTable? old_table = visible_table;
+                uint [] old_families = visible_families;
+                int [] old_variations = n_variations;
+                if (visible_table != table)
+                    carry_over_family_objects();
+                visible_table = table;
+                n_variations = pass.n_matches;
+                family_objects.foreach((id, item) => { update_family_object(id, item); });
+                visible_families = results;
+                if (old_table != null) {
+                    emit_family_changes(old_table, old_families, old_variations);
+                    items_updated();
+                    profiler_end(span, "FontModel.publish");
+                    return;
+                }
+                items.remove_range(0, items.length);
+            } else {
+                visible_table = null;
+                visible_families = {};
+                n_variations = {};
+                family_objects.remove_all();
+                var results = new GenericArray <unowned Json.Object> ();
+                for (uint i = 0; i < pass.n_matches.length; i++) {
+                    Json.Object item = entries.get_object_element(i);
+                    if (item.has_member("variations"))
+                        item.set_int_member("n-variations", pass.n_matches[i]);
+                    if (pass.n_matches[i] > 0)
+                        results.add(item);
+                }
+                results.sort((a, b) => { return (int) (GET_INDEX(a) - GET_INDEX(b)); });
+                items = results;
+            }
+            if (n_removed > 0 || get_n_items() > 0)
+                items_changed(0, n_removed, get_n_items());
             items_updated();
+            profiler_end(span, "FontModel.publish");
+            return;
+        }
+
+        void cancel_update () {
+            if (filter_source != 0) {
+                GLib.Source.remove(filter_source);
+                filter_source = 0;
+            }
+            return;
+        }
+
+        /**
+         * Filters entries, or table, using the current search term and filter.
+         *
+         * Small lists are processed immediately. Larger lists are processed in
+         * short slices from an idle callback, so the interface stays responsive,
+         * and the current items remain visible until the new results are ready.
+         * Calling this again before a pass completes discards the pending pass.
+         *
+         * items_updated is emitted once the new items are in place.
+         */
+        public void update_items () {
+            cancel_update();
+            var pass = new FilterPass(search_term);
+            if (get_n_entries() <= SYNC_FILTER_THRESHOLD) {
+                run_filter_pass(pass, 0);
+                publish_results(pass);
+                return;
+            }
+            filter_source = Idle.add_full(GLib.Priority.DEFAULT_IDLE, () => {
+                if (!run_filter_pass(pass, FILTER_TIME_SLICE))
+                    return GLib.Source.CONTINUE;
+                filter_source = 0;
+                publish_results(pass);
+                return GLib.Source.REMOVE;
+            });
             return;
         }
 
@@ -33,13 +33,16 @@ namespace FontManager {
 
         public class Installer : Object {
 
-            public signal void progress (string message, uint processed, uint total);
+            // Emitted at a limited rate, see ProgressData.ready()
+            public signal void progress (ProgressData data);
 
             File? tmp_file = null;
+            ProgressData? status = null;
 
             public void process_sync (StringSet filelist) {
                 var sorter = new Sorter();
                 sorter.sort(filelist);
+                begin_progress(sorter);
                 process_files(sorter.fonts);
 #if HAVE_LIBARCHIVE
                 process_archives(sorter.archives);
@@ -59,6 +62,7 @@ namespace FontManager {
                 StringSet filelist = self.get_data("filelist");
                 var sorter = new Sorter();
                 sorter.sort(filelist);
+                self.begin_progress(sorter);
                 self.process_files(sorter.fonts);
 #if HAVE_LIBARCHIVE
                 self.process_archives(sorter.archives);
@@ -78,24 +82,42 @@ namespace FontManager {
                 return;
             }
 
+            void begin_progress (Sorter sorter) {
+                uint total = sorter.fonts.size;
+#if HAVE_LIBARCHIVE
+                total += sorter.archives.size;
+#endif
+                status = new ProgressData(null, 0, total);
+                return;
+            }
+
+            void report_progress (string? message, uint n_processed, uint64 n_bytes) {
+                status.update(message, status.processed + n_processed, status.bytes + n_bytes);
+                if (status.ready())
+                    progress(status.copy());
+                return;
+            }
+
             void process_files (StringSet filelist) {
-                uint total = filelist.size;
-                uint processed = 0;
                 File install_dir = File.new_for_path(get_user_font_directory());
                 foreach (var path in filelist) {
-                    if (path.contains("XtraStuf.mac") || path.contains("__MACOSX"))
+                    if (path.contains("XtraStuf.mac") || path.contains("__MACOSX")) {
+                        report_progress(null, 1, 0);
                         continue;
+                    }
                     File file = File.new_for_path(path);
                     try {
                         install_file(file, install_dir);
                     } catch (Error e) {
                         critical("%s : %s", e.message, path);
                     }
-                    processed++;
                     try {
-                        FileInfo info = file.query_info(FileAttribute.STANDARD_DISPLAY_NAME, FileQueryInfoFlags.NONE);
-                        progress(info.get_display_name(), processed, total);
+                        var attrs = "%s,%s".printf(FileAttribute.STANDARD_DISPLAY_NAME,
+                                                   FileAttribute.STANDARD_SIZE);
+                        FileInfo info = file.query_info(attrs, FileQueryInfoFlags.NONE);
+                        report_progress(info.get_display_name(), 1, (uint64) info.get_size());
                     } catch (Error e) {
+                        report_progress(null, 1, 0);
                         warning(e.message);
                     }
 
@@ -131,7 +153,12 @@ namespace FontManager {
                         continue;
                     }
 
-                    if (!ArchiveManager.extract(file, tmp)) {
+                    bool extracted = ArchiveManager.extract(file, tmp, (entry, bytes) => {
+                        report_progress(entry, 0, bytes);
+                    });
+                    report_progress(null, 1, 0);
+
+                    if (!extracted) {
                         critical("Failed to extract archive : %s", path);
                         continue;
                     }
@@ -140,6 +167,8 @@ namespace FontManager {
                     var list = new StringSet();
                     list.add(tmp.get_path());
                     sorter.sort(list);
+                    // Archive contents aren't known until extracted
+                    status.total += sorter.fonts.size + sorter.archives.size;
                     process_files(sorter.fonts);
                     process_archives(sorter.archives);
 
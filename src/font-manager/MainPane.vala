@@ -22,7 +22,7 @@ namespace FontManager {
 
     public class MainPane : DualPaned {
 
-        public Json.Array? available_fonts { get; set; default = null; }
+        public FontTable? available_fonts { get; set; default = null; }
         public Reject? disabled_families { get; set; default = null; }
 
         public Mode mode { get; set; default = 0; }
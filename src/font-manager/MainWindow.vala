@@ -108,7 +108,7 @@ namespace FontManager {
             }
         }
 
-        public Json.Array? available_fonts { get; set; default = null; }
+        public FontTable? available_fonts { get; set; default = null; }
         public Reject? disabled_families { get; set; default = null; }
 
         Gtk.Stack main_stack;
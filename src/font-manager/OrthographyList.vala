@@ -18,18 +18,6 @@
  * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
 */
 
-internal string GET_ORTH_FOR (string f, int i) {
-return """SELECT json_extract(Orthography.support, '$')
-FROM Orthography WHERE json_valid(Orthography.support)
-AND Orthography.filepath = '%s' AND Orthography.findex = '%i'; """.printf(f, i);
-}
-
-internal string GET_BASE_ORTH_FOR (string f) {
-return """SELECT json_extract(Orthography.support, '$')
-FROM Orthography WHERE json_valid(Orthography.support)
-AND Orthography.filepath = '%s'; """.printf(f);
-}
-
 internal unowned string GET_NAME (Json.Object o) { return o.get_string_member("name"); }
 internal double GET_COVERAGE (Json.Object o) { return o.get_double_member("coverage"); }
 
@@ -179,22 +167,6 @@ namespace FontManager {
             return;
         }
 
-        Json.Object? parse_json_result (string? json) {
-            if (json != null) {
-                try {
-                    Json.Parser parser = new Json.Parser();
-                    parser.load_from_data(json);
-                    Json.Node root = parser.get_root();
-                    if (root.get_node_type() == Json.NodeType.OBJECT)
-                        return root.get_object();
-                } catch (Error e) {
-                    warning(e.message);
-                    return null;
-                }
-            }
-            return null;
-        }
-
         void update_model () {
             model.orthography = null;
             place_holder.message = _("No items selected");
@@ -214,19 +186,10 @@ namespace FontManager {
             }
             try {
                 Database db = DatabaseProxy.get_default_db();
-                string path = font.filepath.replace("'", "''");
-                string query = GET_ORTH_FOR(path, (int) font.findex);
-                db.execute_query(query);
-                if (db.get_cursor().step() == Sqlite.ROW) {
-                    model.orthography = parse_json_result(db.get_cursor().column_text(0));
-                } else {
-                    db.end_query();
-                    query = GET_BASE_ORTH_FOR(path);
-                    db.execute_query(query);
-                    if (db.get_cursor().step() == Sqlite.ROW)
-                        model.orthography = parse_json_result(db.get_cursor().column_text(0));
-                }
-                db.end_query();
+                Json.Object? orthography = db.get_orthography(font.filepath, (int) font.findex);
+                if (orthography == null)
+                    orthography = db.get_orthography(font.filepath, -1);
+                model.orthography = orthography;
                 // No error and no results means this font file is likely broken or empty
                 place_holder.message = _("No valid orthographies for selection");
                 place_holder.icon_name = "action-unavailable-symbolic";
@@ -44,7 +44,7 @@ namespace FontManager {
 
         string [] character_search (string charset) {
             string [] result_set = {};
-            Json.Object fontset = get_available_fonts_for_chars(charset);
+            Json.Object fontset = DatabaseProxy.get_fonts_for_chars(charset);
             fontset.foreach_member((obj, name, node) => {
                 Json.Object fonts = node.get_object();
                 fonts.foreach_member((obj, name, node) => {
@@ -63,16 +63,16 @@ namespace FontManager {
             var search_term = get_search_term(terms);
             try {
                 Database db = DatabaseProxy.get_default_db();
-                search_term = search_term.replace("'", "''");
-                string QUERY = "SELECT filepath, findex, family, style from Fonts " +
-                               @"WHERE family LIKE '%$search_term%' ORDER BY weight;";
-                db.execute_query(QUERY);
-                foreach (unowned Sqlite.Statement row in db)
-                    result_set += "%s::%i::%s::%s".printf(row.column_text(ID.FILEPATH),
-                                                          row.column_int(ID.INDEX),
-                                                          row.column_text(ID.FAMILY),
-                                                          row.column_text(ID.STYLE));
-                db.end_query();
+                Json.Array? results = db.search(search_term);
+                if (results == null)
+                    return result_set;
+                results.foreach_element((array, index, node) => {
+                    Json.Object font = node.get_object();
+                    result_set += "%s::%i::%s::%s".printf(font.get_string_member("filepath"),
+                                                          (int) font.get_int_member("findex"),
+                                                          font.get_string_member("family"),
+                                                          font.get_string_member("style"));
+                });
             } catch (Error e) {
                 warning(e.message);
             }
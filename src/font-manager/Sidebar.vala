@@ -84,7 +84,7 @@ namespace FontManager {
         public signal void changed();
 
         public FontListFilter? filter { get; set; default = null; }
-        public Json.Array? available_fonts { get; set; default = null; }
+        public FontTable? available_fonts { get; set; default = null; }
         public Reject? disabled_families { get; set; default = null; }
         public SortType sort_type { get; set; default = SortType.NONE; }
 
@@ -208,7 +208,7 @@ namespace FontManager {
         public Object? selected_item { get; set; default = null; }
         public GLib.Settings? settings { get; protected set; default = null; }
         public FontListFilter? filter { get; set; default = null; }
-        public Json.Array? available_fonts { get; set; default = null; }
+        public FontTable? available_fonts { get; set; default = null; }
         public Reject? disabled_families { get; set; default = null; }
         public Orthography? selected_orthography { get; set; default = null; }
 
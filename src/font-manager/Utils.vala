@@ -139,20 +139,26 @@ namespace FontManager {
         return result;
     }
 
-    public void update_item_preview_text (Json.Array available_fonts) {
-        HashTable <string, string> samples = get_non_local_samples();
-        available_fonts.foreach_element((array, index, node) => {
-            Json.Object item = node.get_object();
-            string description = item.get_string_member("description");
-            if (samples.contains(description))
-                item.set_string_member("preview-text", samples.lookup(description));
-            Json.Array variants = item.get_array_member("variations");
-            variants.foreach_element((a, i, n) => {
-                Json.Object v = n.get_object();
-                description = v.get_string_member("description");
-                if (samples.contains(description))
-                    v.set_string_member("preview-text", samples.lookup(description));
-            });
+    // Only looked up again once the database has been updated
+    HashTable <string, string>? non_local_samples = null;
+    uint non_local_samples_serial = 0;
+
+    // Sets the preview text of a family object and its variations,
+    // for fonts which can't render text in the current locale.
+    public void update_item_preview_text (Json.Object item) {
+        if (non_local_samples == null || non_local_samples_serial != DatabaseProxy.sync_serial) {
+            non_local_samples = get_non_local_samples();
+            non_local_samples_serial = DatabaseProxy.sync_serial;
+        }
+        string description = item.get_string_member("description");
+        if (non_local_samples.contains(description))
+            item.set_string_member("preview-text", non_local_samples.lookup(description));
+        Json.Array variants = item.get_array_member("variations");
+        variants.foreach_element((a, i, n) => {
+            Json.Object v = n.get_object();
+            description = v.get_string_member("description");
+            if (non_local_samples.contains(description))
+                v.set_string_member("preview-text", non_local_samples.lookup(description));
         });
         return;
     }
@@ -249,7 +255,9 @@ namespace FontManager {
         return res;
     }
 
-    Json.Array get_sorted_font_list (Pango.Context? ctx) {
+    // Returns a Reject which needs to be saved once fonts have been listed, if any
+    Reject? prepare_font_configuration (Pango.Context? ctx) {
+        int64 span = profiler_begin();
         Reject? reject = have_missing_rejects();
         if (reject != null) {
             // If there is a discrepancy between families listed as disabled
@@ -269,11 +277,99 @@ namespace FontManager {
         } else {
             critical("Failed to load user font resources, will be unable to render properly");
         }
-        var fonts = get_available_fonts(null);
-        var sorted_fonts = sort_json_font_listing(fonts);
+        profiler_end(span, "Fontconfig.prepare");
+        return reject;
+    }
+
+    void finish_font_table (FontTable table, Reject? reject) {
         if (reject != null)
             reject.save();
-        return sorted_fonts;
+        try {
+            table.save(get_font_table_snapshot_path(), get_font_table_stamp());
+        } catch (Error e) {
+            warning("Failed to save font table : %s", e.message);
+        }
+        return;
+    }
+
+    FontTable get_sorted_font_table (Pango.Context? ctx) {
+        Reject? reject = prepare_font_configuration(ctx);
+        FontTable table = get_available_font_table(null);
+        finish_font_table(table, reject);
+        return table;
+    }
+
+    // Same as get_sorted_font_table, except that Fontconfig is queried from a
+    // worker thread. The configuration is modified from the main thread, so
+    // prepare_font_configuration must be called first, reject is its result.
+    async FontTable get_sorted_font_table_async (Reject? reject) {
+        FontTable? table = null;
+        SourceFunc callback = get_sorted_font_table_async.callback;
+        new Thread <void> ("font-table", () => {
+            table = get_available_font_table(null);
+            Idle.add((owned) callback);
+        });
+        yield;
+        finish_font_table(table, reject);
+        return table;
+    }
+
+    // Only needed by consumers which require the complete listing as JSON
+    Json.Array get_sorted_font_list (Pango.Context? ctx) {
+        return get_sorted_font_table(ctx).to_json();
+    }
+
+    string get_font_table_snapshot_path () {
+        return Path.build_filename(get_package_cache_directory(), "FontTable.bin");
+    }
+
+    uint64 get_modification_time (string path) {
+        try {
+            File file = File.new_for_path(path);
+            FileInfo info = file.query_info(FileAttribute.TIME_MODIFIED, FileQueryInfoFlags.NONE);
+            return info.get_attribute_uint64(FileAttribute.TIME_MODIFIED);
+        } catch (Error e) {
+            return 0;
+        }
+    }
+
+    // Describes everything which affects the list of available fonts.
+    // Fontconfig rewrites its caches whenever a font directory changes.
+    string get_font_table_stamp () {
+        var sources = new Directories() {
+            config_dir = get_package_config_directory(),
+            target_element = "source",
+            target_file = "Sources.xml"
+        };
+        sources.load();
+        var active = new Directories();
+        var reject = new Reject();
+        string [] paths = {
+            Path.build_filename(Environment.get_user_cache_dir(), "fontconfig"),
+            "/var/cache/fontconfig",
+            Path.build_filename(Environment.get_home_dir(), ".fonts"),
+            get_user_font_directory(),
+            sources.get_filepath(),
+            active.get_filepath(),
+            reject.get_filepath()
+        };
+        var builder = new StringBuilder();
+        foreach (string path in paths)
+            builder.append(@"$path:$(get_modification_time(path))\n");
+        foreach (string path in sources)
+            if (path != null)
+                builder.append(@"$path:$(get_modification_time(path))\n");
+        return builder.str;
+    }
+
+    // Returns the font table saved during the last run, if it is still current
+    FontTable? load_font_table_snapshot () {
+        try {
+            return FontTable.load(get_font_table_snapshot_path(), get_font_table_stamp());
+        } catch (Error e) {
+            debug("Font table snapshot unavailable : %s", e.message);
+        }
+        return null;
     }
 
     public bool remove_directory_tree_if_empty (File dir) {
@@ -316,8 +412,8 @@ namespace FontManager {
 
     public async void copy_files (StringSet filelist, File destination, bool show_progress) {
         assert(destination.query_file_type(FileQueryInfoFlags.NONE) == FileType.DIRECTORY);
-        uint total = filelist.size;
         uint processed = 0;
+        var status = new ProgressData(null, 0, filelist.size);
         ProgressDialog? progress = null;
         if (show_progress) {
             Gtk.Window? parent = get_default_application().main_window;
@@ -338,10 +434,9 @@ namespace FontManager {
                 critical(e.message);
             }
             Idle.add(copy_files.callback);
-            if (progress != null) {
-                var progress_data = new ProgressData(filename, ++processed, total);
-                progress.update(progress_data);
-            }
+            status.update(filename, ++processed, status.bytes);
+            if (progress != null && status.ready())
+                progress.update(status);
             yield;
         }
         if (progress != null) {
@@ -36,6 +36,9 @@ namespace FontManager {
             }
         }
 
+        // Membership only changes during update(), which emits changed
+        public override bool cache_matches { get { return true; } }
+
         public Category (string name, string comment, string icon, string? sql, int index) {
             Object(name: name, icon: icon, comment: comment, sql: sql, index: index);
         }
@@ -71,6 +74,10 @@ namespace FontManager {
             return visible;
         }
 
+        public override bool matches_face (string family, string description) {
+            return sql == null || description in variations;
+        }
+
         public override bool deserialize_property (string prop_name,
                                                    out Value val,
                                                    ParamSpec pspec,
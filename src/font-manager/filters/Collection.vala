@@ -214,6 +214,10 @@ namespace FontManager {
             return results;
         }
 
+        public override StringSet? get_matching_families () {
+            return get_full_contents();
+        }
+
         public override bool matches (Object? item) {
             bool visible = false;
             string family;
@@ -222,6 +226,10 @@ namespace FontManager {
             return visible;
         }
 
+        public override bool matches_face (string family, string description) {
+            return family in get_full_contents();
+        }
+
         public override bool deserialize_property (string prop_name,
                                                    out Value val,
                                                    ParamSpec pspec,
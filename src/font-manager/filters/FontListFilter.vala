@@ -33,12 +33,36 @@ namespace FontManager {
         public virtual int size { get { return 0; } }
         public virtual int depth { get; set; default = 0; }
 
+        // Whether the result of matches() for a given font can only change
+        // when this filter emits changed, which allows results to be cached.
+        public virtual bool cache_matches { get { return false; } }
+
+        // Whether the families returned by get_matching_families() are excluded
+        public virtual bool excludes_families { get { return false; } }
+
+        // Families matched by this filter, if matches() depends on nothing else.
+        // Allows models to collect the matching faces for every family at once,
+        // rather than calling matches() for each face.
+        public virtual StringSet? get_matching_families () {
+            return null;
+        }
+
         public virtual async void update () {}
 
         public virtual bool matches (Object? item) {
             return item != null ? true : false;
         }
 
+        // Same as matches() for a font with the given family and description.
+        // Allows models to check faces without creating an object for each of them.
+        // Filters which only look at those two should override this.
+        public virtual bool matches_face (string family, string description) {
+            var face = new Json.Object();
+            face.set_string_member("family", family);
+            face.set_string_member("description", description);
+            return matches(new Font() { source_object = face });
+        }
+
     }
 
     public class FontListFilterModel : Object, ListModel {
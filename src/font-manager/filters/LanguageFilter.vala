@@ -20,9 +20,8 @@
 
 internal const string SELECT_ON_LANGUAGE = """
 SELECT DISTINCT Fonts.family, Fonts.description
-FROM Fonts, json_tree(Orthography.support, '$.%s')
-JOIN Orthography USING (filepath, findex)
-WHERE json_tree.key = 'coverage' AND json_tree.value > %f;
+FROM Fonts JOIN Coverage USING (filepath, findex)
+WHERE Coverage.orthography = '%s' AND Coverage.coverage > %f;
 """;
 
 const string DEFAULT_LANGUAGE_FILTER_COMMENT = _("Filter based on supported orthographies");
@@ -30,6 +30,11 @@ namespace FontManager {
             }
         }
 
+        // Matches depend on sorted, which is updated externally
+        public override bool cache_matches { get { return false; } }
+
+        public override bool excludes_families { get { return true; } }
+
         public Unsorted () {
             base(_("Unsorted"),
                  _("Fonts not present in any collection"),
@@ -51,6 +56,10 @@ namespace FontManager {
             return;
         }
 
+        public override StringSet? get_matching_families () {
+            return sorted;
+        }
+
         public override bool matches (Object? item) {
             bool visible = false;
             if (item is Family)
@@ -60,6 +69,10 @@ namespace FontManager {
             return visible;
         }
 
+        public override bool matches_face (string family, string description) {
+            return !(family in sorted);
+        }
+
     }
 
 }
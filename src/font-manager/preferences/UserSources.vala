@@ -121,14 +121,15 @@ namespace FontManager {
                                             Cancellable? cancellable = null) {
             string path = ((string) data).replace("'", "''");
             try {
-                Database db = DatabaseProxy.get_default_db();
-                string [] tables = { "Fonts", "Metadata", "Orthography", "Panose" };
+                // Shared connections are read-only, writes need their own
+                Database db = new Database();
+                string [] tables = { "Fonts", "Metadata", "Orthography", "Panose", "Coverage", "Codepoints", "FileState" };
                 foreach (string table in tables) {
                     db.execute_query(@"DELETE FROM $table WHERE filepath LIKE '%$path%'");
                     db.get_cursor().step();
                     db.end_query();
                 }
-                db.vacuum();
+                db.run_maintenance();
             } catch (Error e) {
                 warning("Failed to remove database entries for %s : %s", path, e.message);
             }
@@ -0,0 +1,220 @@
+/* test-sort-json-font-listing.c
+ *
+ * Copyright (C) 2009-2025 Jerry Casiano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *
+ * If not, see <http://www.gnu.org/licenses/gpl-3.0.txt>.
+*/
+
+#include <glib.h>
+#include <json-glib/json-glib.h>
+
+#include "font-manager-fontconfig.h"
+
+/*
+ * font_manager_sort_json_font_listing precomputes sort keys rather than
+ * comparing JSON nodes directly. The comparators below are copies of the
+ * ones it used before that change, listings sorted by both must be identical.
+ */
+
+static gint
+old_natural_sort (const gchar *str1, const gchar *str2)
+{
+    g_autofree gchar *s1 = g_utf8_collate_key_for_filename(str1, -1);
+    g_autofree gchar *s2 = g_utf8_collate_key_for_filename(str2, -1);
+    return g_strcmp0(s1, s2);
+}
+
+static gint
+old_compare_int_member (const gchar *member_name, JsonObject *a, JsonObject *b)
+{
+    gint int_a = json_object_get_int_member(a, member_name);
+    gint int_b = json_object_get_int_member(b, member_name);
+    return int_a == int_b ? 0 : int_a - int_b;
+}
+
+static gint
+old_compare_font_node (JsonNode *node_a, JsonNode *node_b)
+{
+    static const gchar *STYLE_PROPS[3] = { "width", "weight", "slant" };
+    JsonObject *a = json_node_get_object(node_a);
+    JsonObject *b = json_node_get_object(node_b);
+    for (gint i = 0; i < (gint) G_N_ELEMENTS(STYLE_PROPS); i++) {
+        gint result = old_compare_int_member(STYLE_PROPS[i], a, b);
+        if (result != 0)
+            return result;
+    }
+    return old_natural_sort(json_object_get_string_member(a, "style"),
+                            json_object_get_string_member(b, "style"));
+}
+
+static JsonArray *
+old_sort_json_font_listing (JsonObject *json_obj)
+{
+    GList *members = json_object_get_members(json_obj);
+    members = g_list_sort(members, (GCompareFunc) old_natural_sort);
+    JsonArray *result = json_array_sized_new(g_list_length(members));
+    gint index = 0;
+    for (GList *iter = members; iter != NULL; iter = iter->next) {
+        JsonObject *family_obj = json_object_get_object_member(json_obj, iter->data);
+        GList *variations = json_object_get_values(family_obj);
+        gint n_variations = g_list_length(variations);
+        JsonArray *_variations = json_array_sized_new(n_variations);
+        JsonObject *_family_obj = json_object_new();
+        json_object_set_string_member(_family_obj, "family", iter->data);
+        json_object_set_int_member(_family_obj, "n-variations", n_variations);
+        json_object_set_array_member(_family_obj, "variations", _variations);
+        json_object_set_boolean_member(_family_obj, "active", TRUE);
+        json_object_set_int_member(_family_obj, "_index", index);
+        variations = g_list_sort(variations, (GCompareFunc) old_compare_font_node);
+        gint _index = 0;
+        for (GList *_iter = variations; _iter != NULL; _iter = _iter->next) {
+            JsonObject *style_obj = json_node_dup_object(_iter->data);
+            json_object_set_int_member(style_obj, "_index", _index);
+            json_array_add_object_element(_variations, style_obj);
+            if (!json_object_get_member(_family_obj, "description")) {
+                const gchar *style = json_object_get_string_member(style_obj, "style");
+                if (font_manager_is_default_variant(style)) {
+                    const gchar *font_desc = json_object_get_string_member(style_obj, "description");
+                    json_object_set_string_member(_family_obj, "description", font_desc);
+                }
+            }
+            _index++;
+        }
+        if (!json_object_get_member(_family_obj, "description")) {
+            JsonObject *_default_ = json_array_get_object_element(_variations, 0);
+            const gchar *fallback = json_object_get_string_member(_default_, "description");
+            json_object_set_string_member(_family_obj, "description", fallback);
+        }
+        json_array_add_object_element(result, _family_obj);
+        g_list_free(variations);
+        index++;
+    }
+    g_list_free(members);
+    return result;
+}
+
+/* Names which exercise natural ordering, case, accents and non-Latin scripts */
+static const gchar *FAMILY_PREFIXES[] = {
+    "Noto Sans", "noto sans", "Noto Serif", "DejaVu", "Font", "font-", "Ärial",
+    "Arial", "Source Han Sans", "源ノ角ゴシック", "Ubuntu Mono", "_Hidden", "Zilla"
+};
+
+static const gchar *STYLE_NAMES[] = {
+    "Regular", "Book", "Roman", "Medium", "Bold", "Bold Italic", "Italic",
+    "Oblique", "Light", "Thin", "Black", "Condensed", "SemiCondensed Bold",
+    "Style 2", "Style 10", "style 1"
+};
+
+/* Fontconfig values, the listing only ever contains these */
+static const gint WEIGHTS[] = { 0, 40, 50, 80, 100, 180, 200, 210 };
+static const gint SLANTS[] = { 0, 100, 110 };
+static const gint WIDTHS[] = { 63, 75, 87, 100, 113, 125 };
+
+#define PICK(a) (a)[g_test_rand_int_range(0, G_N_ELEMENTS(a))]
+
+/* Same structure as font_manager_get_available_fonts */
+static JsonObject *
+generate_listing (guint n_families)
+{
+    JsonObject *listing = json_object_new();
+    for (guint i = 0; i < n_families; i++) {
+        g_autofree gchar *family = g_strdup_printf("%s %i", PICK(FAMILY_PREFIXES),
+                                                   g_test_rand_int_range(0, n_families));
+        if (json_object_has_member(listing, family))
+            continue;
+        JsonObject *family_obj = json_object_new();
+        gint n_styles = g_test_rand_int_range(1, G_N_ELEMENTS(STYLE_NAMES));
+        for (gint s = 0; s < n_styles; s++) {
+            const gchar *style = PICK(STYLE_NAMES);
+            JsonObject *font = json_object_new();
+            g_autofree gchar *filepath = g_strdup_printf("/fonts/%u-%i.ttf", i, s);
+            g_autofree gchar *description = g_strdup_printf("%s %s", family, style);
+            json_object_set_string_member(font, "filepath", filepath);
+            json_object_set_int_member(font, "findex", 0);
+            json_object_set_string_member(font, "family", family);
+            json_object_set_string_member(font, "style", style);
+            json_object_set_int_member(font, "spacing", 0);
+            /* Styles often share every property, ties are broken by name */
+            json_object_set_int_member(font, "slant", PICK(SLANTS));
+            json_object_set_int_member(font, "weight", s % 3 ? PICK(WEIGHTS) : 80);
+            json_object_set_int_member(font, "width", s % 2 ? PICK(WIDTHS) : 100);
+            json_object_set_string_member(font, "description", description);
+            json_object_set_object_member(family_obj, style, font);
+        }
+        json_object_set_object_member(listing, family, family_obj);
+    }
+    return listing;
+}
+
+static void
+assert_same_listing (JsonArray *expected, JsonArray *result)
+{
+    guint n_families = json_array_get_length(expected);
+    g_assert_cmpuint(json_array_get_length(result), ==, n_families);
+    for (guint i = 0; i < n_families; i++) {
+        JsonObject *a = json_array_get_object_element(expected, i);
+        JsonObject *b = json_array_get_object_element(result, i);
+        g_assert_cmpstr(json_object_get_string_member(a, "family"), ==,
+                        json_object_get_string_member(b, "family"));
+        g_assert_cmpstr(json_object_get_string_member(a, "description"), ==,
+                        json_object_get_string_member(b, "description"));
+        JsonArray *va = json_object_get_array_member(a, "variations");
+        JsonArray *vb = json_object_get_array_member(b, "variations");
+        guint n_variations = json_array_get_length(va);
+        g_assert_cmpuint(json_array_get_length(vb), ==, n_variations);
+        for (guint v = 0; v < n_variations; v++)
+            g_assert_cmpstr(json_object_get_string_member(json_array_get_object_element(va, v), "filepath"), ==,
+                            json_object_get_string_member(json_array_get_object_element(vb, v), "filepath"));
+    }
+    /* Anything not covered above, such as indices and variation counts */
+    JsonNode *node_a = json_node_init_array(json_node_alloc(), expected);
+    JsonNode *node_b = json_node_init_array(json_node_alloc(), result);
+    g_assert_true(json_node_equal(node_a, node_b));
+    json_node_free(node_a);
+    json_node_free(node_b);
+    return;
+}
+
+static void
+test_same_order (gconstpointer data)
+{
+    guint n_families = GPOINTER_TO_UINT(data);
+    g_autoptr(JsonObject) listing = generate_listing(n_families);
+    g_autoptr(JsonArray) expected = old_sort_json_font_listing(listing);
+    g_autoptr(JsonArray) result = font_manager_sort_json_font_listing(listing);
+    assert_same_listing(expected, result);
+    return;
+}
+
+static void
+test_empty_listing (void)
+{
+    g_autoptr(JsonObject) listing = json_object_new();
+    g_autoptr(JsonArray) result = font_manager_sort_json_font_listing(listing);
+    g_assert_cmpuint(json_array_get_length(result), ==, 0);
+    return;
+}
+
+int
+main (int argc, char *argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func("/sort-json-font-listing/empty", test_empty_listing);
+    /* Sizes below and above the chunk size used to split work between threads */
+    g_test_add_data_func("/sort-json-font-listing/small", GUINT_TO_POINTER(16), test_same_order);
+    g_test_add_data_func("/sort-json-font-listing/large", GUINT_TO_POINTER(5000), test_same_order);
+    return g_test_run();
+}